@@ -134,6 +134,7 @@ def config_mem(options, system):
     opt_dram_powerdown = getattr(options, "enable_dram_powerdown", None)
     opt_mem_channels_intlv = getattr(options, "mem_channels_intlv", 128)
     opt_xor_low_bit = getattr(options, "xor_low_bit", 0)
+    opt_multi_channel_ctrl = getattr(options, "mem_multi_channel_ctrl", False)
 
     if opt_mem_type == "HMC_2500_1x32":
         HMChost = HMC.config_hmc_host_ctrl(options, system)
@@ -246,6 +247,19 @@ def config_mem(options, system):
     for i in range(len(nvm_intfs)):
         mem_ctrls[i].nvm = nvm_intfs[i];
 
+    # Put all the channels behind a single multi-channel controller,
+    # which is connected to the xbar instead of the channels
+    if opt_multi_channel_ctrl:
+        if opt_mem_type == "HMC_2500_1x32" or \
+           not all(isinstance(c, m5.objects.MemCtrl) for c in mem_ctrls):
+            fatal("The multi-channel controller requires DRAM or NVM "
+                  "memory controllers")
+        subsystem.mem_ctrls = mem_ctrls
+        subsystem.mem_multi_channel_ctrl = \
+            m5.objects.MultiChannelMemCtrl(channels=mem_ctrls)
+        subsystem.mem_multi_channel_ctrl.port = xbar.mem_side_ports
+        return
+
     # Connect the controller to the xbar port
     for i in range(len(mem_ctrls)):
         if opt_mem_type == "HMC_2500_1x32":
@@ -131,6 +131,9 @@ def addNoISAOptions(parser):
                         help="Enable low-power states in DRAMInterface")
     parser.add_argument("--mem-channels-intlv", type=int, default=0,
                         help="Memory channels interleave")
+    parser.add_argument("--mem-multi-channel-ctrl", action="store_true",
+                        help="Put the memory channels behind a single "
+                        "multi-channel controller")
 
     parser.add_argument("--memchecker", action="store_true")
 
@@ -35,6 +35,7 @@
 
 import math
 import argparse
+import time
 
 import m5
 from m5.objects import *
@@ -78,6 +79,17 @@ parser.add_argument("--addr-map",
                     choices=ObjectList.dram_addr_map_list.get_names(),
                     default="RoRaBaCoCh", help = "DRAM address map policy")
 
+parser.add_argument("--read-buffer-size", type=int, default=None,
+                    help = "Override the read queue depth of the "
+                    "controller, deeper queues stress the scheduler")
+
+parser.add_argument("--write-buffer-size", type=int, default=None,
+                    help = "Override the write queue depth of the "
+                    "controller")
+
+parser.add_argument("--period", type=int, default=250000000,
+                    help = "Ticks spent in each state of the sweep")
+
 args = parser.parse_args()
 
 # at the moment we stay with the default open-adaptive page policy,
@@ -119,9 +131,14 @@ system.mem_ctrls[0].dram.null = True
 # Set the address mapping based on input argument
 system.mem_ctrls[0].dram.addr_mapping = args.addr_map
 
-# stay in each state for 0.25 ms, long enough to warm things up, and
-# short enough to avoid hitting a refresh
-period = 250000000
+if args.read_buffer_size:
+    system.mem_ctrls[0].dram.read_buffer_size = args.read_buffer_size
+if args.write_buffer_size:
+    system.mem_ctrls[0].dram.write_buffer_size = args.write_buffer_size
+
+# stay in each state for 0.25 ms by default, long enough to warm things
+# up, and short enough to avoid hitting a refresh
+period = args.period
 
 # stay in each state as long as the dump/reset period, use the entire
 # range, issue transactions of the right DRAM burst size, and match
@@ -188,7 +205,14 @@ def trace():
 
 system.tgen.start(trace())
 
+# the host time is mostly spent scheduling the queued requests, and
+# is a measure of the controller simulation speed with deep queues
+start = time.time()
 m5.simulate()
+host_seconds = time.time() - start
 
 print("DRAM sweep with burst: %d, banks: %d, max stride: %d, request \
        generation period: %d" % (burst_size, nbr_banks, max_stride, itt))
+print("Read/write queue depth: %d/%d, host seconds: %.2f" %
+      (system.mem_ctrls[0].dram.read_buffer_size.value,
+       system.mem_ctrls[0].dram.write_buffer_size.value, host_seconds))
@@ -0,0 +1,106 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script measures the simulation speed of a crossbar with many
+# ports. A set of traffic generators issue random reads and writes
+# through a single crossbar to a set of interleaved memories, so that
+# the host time is mostly spent routing the requests and responses.
+
+import argparse
+import time
+
+import m5
+from m5.objects import *
+from m5.util import convert, fatal
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("--requestors", type=int, default=64,
+                    help="Number of traffic generators")
+parser.add_argument("--responders", type=int, default=4,
+                    help="Number of memories, must be a power of 2")
+parser.add_argument("--xbar", choices=["noncoherent", "coherent"],
+                    default="noncoherent", help="Type of crossbar")
+parser.add_argument("--duration", type=str, default="100us",
+                    help="Time to simulate")
+parser.add_argument("--itt", type=str, default="10ns",
+                    help="Inter-transaction time of each generator")
+parser.add_argument("--rd-perc", type=int, default=70,
+                    help="Percentage of read commands")
+
+args = parser.parse_args()
+
+intlv_bits = args.responders.bit_length() - 1
+if 2 ** intlv_bits != args.responders:
+    fatal("Number of responders must be a power of 2")
+
+block_size = 64
+mem_size = 512 * 1024 * 1024
+
+system = System(membus = IOXBar() if args.xbar == "noncoherent" else
+                SystemXBar(point_of_coherency = True))
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = VoltageDomain())
+system.mem_mode = 'timing'
+system.cache_line_size = block_size
+system.mem_ranges = [AddrRange(mem_size)]
+
+# interleave the memories at the block granularity, and make them fast
+# enough for the crossbar to be the bottleneck
+system.mems = [SimpleMemory(range = AddrRange(0, size = mem_size,
+                                              intlvHighBit = 5 + intlv_bits,
+                                              intlvBits = intlv_bits,
+                                              intlvMatch = i),
+                            latency = '20ns', bandwidth = '0GB/s',
+                            null = True)
+               for i in range(args.responders)]
+for mem in system.mems:
+    mem.port = system.membus.mem_side_ports
+
+system.tgens = [PyTrafficGen() for i in range(args.requestors)]
+for tgen in system.tgens:
+    tgen.port = system.membus.cpu_side_ports
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+
+m5.instantiate()
+
+duration = m5.ticks.fromSeconds(convert.anyToLatency(args.duration))
+itt = m5.ticks.fromSeconds(convert.anyToLatency(args.itt))
+
+for tgen in system.tgens:
+    tgen.start([tgen.createRandom(duration, 0, mem_size - 1, block_size,
+                                  itt, itt, args.rd_perc, 0),
+                tgen.createExit(0)])
+
+# the generators all exit at the end of the duration
+start = time.time()
+m5.simulate()
+host_seconds = time.time() - start
+
+print("%s crossbar with %d requestors and %d responders, host seconds: %.2f"
+      % (args.xbar, args.requestors, args.responders, host_seconds))
@@ -59,7 +59,7 @@ namespace gem5
 using namespace ArmISA;
 
 TLB::TLB(const ArmTLBParams &p)
-    : BaseTLB(p), table(new TlbEntry[p.size]), size(p.size),
+    : BaseTLB(p), table(p.size), size(p.size),
       isStage2(p.is_stage2),
       _walkCache(false),
       tableWalker(nullptr),
@@ -92,7 +92,6 @@ TLB::TLB(const ArmTLBParams &p)
 
 TLB::~TLB()
 {
-    delete[] table;
 }
 
 void
@@ -105,52 +104,7 @@ TLB::setTableWalker(TableWalker *table_walker)
 TlbEntry*
 TLB::match(const Lookup &lookup_data)
 {
-    // Vector of TLB entry candidates.
-    // Only one of them will be assigned to retval and will
-    // be returned to the MMU (in case of a hit)
-    // The vector has one entry per lookup level as it stores
-    // both complete and partial matches
-    std::vector<std::pair<int, const TlbEntry*>> hits{
-        LookupLevel::Num_ArmLookupLevel, {0, nullptr}};
-
-    int x = 0;
-    while (x < size) {
-        if (table[x].match(lookup_data)) {
-            const TlbEntry &entry = table[x];
-            hits[entry.lookupLevel] = std::make_pair(x, &entry);
-
-            // This is a complete translation, no need to loop further
-            if (!entry.partial)
-                break;
-        }
-        ++x;
-    }
-
-    // Loop over the list of TLB entries matching our translation
-    // request, starting from the highest lookup level (complete
-    // translation) and iterating backwards (using reverse iterators)
-    for (auto it = hits.rbegin(); it != hits.rend(); it++) {
-        const auto& [idx, entry] = *it;
-        if (!entry) {
-            // No match for the current LookupLevel
-            continue;
-        }
-
-        // Maintaining LRU array
-        // We only move the hit entry ahead when the position is higher
-        // than rangeMRU
-        if (idx > rangeMRU && !lookup_data.functional) {
-            TlbEntry tmp_entry = *entry;
-            for (int i = idx; i > 0; i--)
-                table[i] = table[i - 1];
-            table[0] = tmp_entry;
-            return &table[0];
-        } else {
-            return &table[idx];
-        }
-    }
-
-    return nullptr;
+    return table.match(lookup_data, rangeMRU);
 }
 
 TlbEntry*
@@ -248,19 +202,18 @@ TLB::insert(TlbEntry &entry)
             entry.ap, static_cast<uint8_t>(entry.domain), entry.ns, entry.nstid,
             entry.isHyp);
 
-    if (table[size - 1].valid)
+    const TlbEntry &victim = table.victim();
+    if (victim.valid)
         DPRINTF(TLB, " - Replacing Valid entry %#x, asn %d vmn %d ppn %#x "
                 "size: %#x ap:%d ns:%d nstid:%d g:%d isHyp:%d el: %d\n",
-                table[size-1].vpn << table[size-1].N, table[size-1].asid,
-                table[size-1].vmid, table[size-1].pfn << table[size-1].N,
-                table[size-1].size, table[size-1].ap, table[size-1].ns,
-                table[size-1].nstid, table[size-1].global, table[size-1].isHyp,
-                table[size-1].el);
+                victim.vpn << victim.N, victim.asid,
+                victim.vmid, victim.pfn << victim.N,
+                victim.size, victim.ap, victim.ns,
+                victim.nstid, victim.global, victim.isHyp,
+                victim.el);
 
     // inserting to MRU position and evicting the LRU one
-    for (int i = size - 1; i > 0; --i)
-        table[i] = table[i-1];
-    table[0] = entry;
+    table.insert(entry);
 
     stats.inserts++;
     ppRefills->notify(1);
@@ -284,7 +237,7 @@ void
 TLB::printTlb() const
 {
     int x = 0;
-    TlbEntry *te;
+    const TlbEntry *te;
     DPRINTF(TLB, "Current TLB contents:\n");
     while (x < size) {
         te = &table[x];
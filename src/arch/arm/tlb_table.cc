@@ -0,0 +1,197 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/arm/tlb_table.hh"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace gem5
+{
+
+using namespace ArmISA;
+
+TlbTable::TlbTable(int size)
+    : entries(size), prev(size), next(size), head(0), tail(size - 1),
+      age(size), nextAge(size + 1), slotIndex(size, NotIndexed)
+{
+    assert(size > 0);
+
+    // Start with the invalid entries in slot order, slot 0 being the
+    // MRU one.
+    for (int i = 0; i < size; ++i) {
+        prev[i] = i - 1;
+        next[i] = i + 1 < size ? i + 1 : -1;
+        age[i] = size - i;
+    }
+}
+
+void
+TlbTable::addToIndex(int slot)
+{
+    const TlbEntry &entry = entries[slot];
+    const Addr mask = entry.size;
+    const Addr base = entry.vpn << entry.N;
+
+    // TlbEntry::match() hits on [base, base + size]. For a naturally
+    // aligned page this is the same as comparing the page address.
+    if ((mask & (mask + 1)) != 0 || (base & mask) != 0) {
+        slotIndex[slot] = Unaligned;
+        unaligned.push_back(slot);
+        return;
+    }
+
+    auto it = std::find_if(sizeIndex.begin(), sizeIndex.end(),
+        [mask](const SizeIndex &index) { return index.mask == mask; });
+    if (it == sizeIndex.end())
+        it = sizeIndex.insert(sizeIndex.end(), SizeIndex{mask, {}});
+
+    it->slots.emplace(base, slot);
+    slotIndex[slot] = it - sizeIndex.begin();
+}
+
+void
+TlbTable::removeFromIndex(int slot)
+{
+    if (slotIndex[slot] == NotIndexed)
+        return;
+
+    if (slotIndex[slot] == Unaligned) {
+        unaligned.erase(std::find(unaligned.begin(), unaligned.end(), slot));
+    } else {
+        const TlbEntry &entry = entries[slot];
+        auto &slots = sizeIndex[slotIndex[slot]].slots;
+        auto range = slots.equal_range(entry.vpn << entry.N);
+        auto it = std::find_if(range.first, range.second,
+            [slot](const auto &key_slot) { return key_slot.second == slot; });
+        assert(it != range.second);
+        slots.erase(it);
+    }
+    slotIndex[slot] = NotIndexed;
+}
+
+void
+TlbTable::moveToFront(int slot)
+{
+    age[slot] = nextAge++;
+    if (slot == head)
+        return;
+
+    // Unlink
+    next[prev[slot]] = next[slot];
+    if (next[slot] != -1)
+        prev[next[slot]] = prev[slot];
+    else
+        tail = prev[slot];
+
+    // Link as the new head
+    prev[slot] = -1;
+    next[slot] = head;
+    prev[head] = slot;
+    head = slot;
+}
+
+bool
+TlbTable::inMruRange(int slot, int range_mru) const
+{
+    int pos = 0;
+    for (int s = head; s != -1 && pos <= range_mru; s = next[s], ++pos) {
+        if (s == slot)
+            return true;
+    }
+    return false;
+}
+
+TlbEntry *
+TlbTable::match(const Lookup &lookup, int range_mru)
+{
+    matches.clear();
+    for (const auto &index : sizeIndex) {
+        auto range = index.slots.equal_range(lookup.va & ~index.mask);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (entries[it->second].match(lookup))
+                matches.push_back(it->second);
+        }
+    }
+    for (int slot : unaligned) {
+        if (entries[slot].match(lookup))
+            matches.push_back(slot);
+    }
+
+    if (matches.empty())
+        return nullptr;
+
+    // A scan in MRU order stops at the first complete translation, so
+    // only the matches at least as recent as that one are considered.
+    int complete = -1;
+    for (int slot : matches) {
+        if (!entries[slot].partial &&
+            (complete == -1 || age[slot] > age[complete])) {
+            complete = slot;
+        }
+    }
+
+    // For each lookup level, the scan keeps the last (least recently
+    // used) match before the complete translation.
+    std::array<int, enums::Num_ArmLookupLevel> hits;
+    hits.fill(-1);
+    for (int slot : matches) {
+        if (complete != -1 && age[slot] < age[complete])
+            continue;
+        int &hit = hits[entries[slot].lookupLevel];
+        if (hit == -1 || age[slot] < age[hit])
+            hit = slot;
+    }
+    if (complete != -1)
+        hits[entries[complete].lookupLevel] = complete;
+
+    // The highest lookup level wins.
+    auto hit = std::find_if(hits.rbegin(), hits.rend(),
+                            [](int slot) { return slot != -1; });
+    assert(hit != hits.rend());
+    const int slot = *hit;
+
+    if (!lookup.functional && !inMruRange(slot, range_mru))
+        moveToFront(slot);
+
+    return &entries[slot];
+}
+
+TlbEntry *
+TlbTable::insert(const TlbEntry &entry)
+{
+    const int slot = tail;
+
+    removeFromIndex(slot);
+    entries[slot] = entry;
+    if (entry.valid)
+        addToIndex(slot);
+    moveToFront(slot);
+
+    return &entries[slot];
+}
+
+} // namespace gem5
@@ -0,0 +1,145 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_ARM_TLB_TABLE_HH__
+#define __ARCH_ARM_TLB_TABLE_HH__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "arch/arm/pagetable.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace ArmISA
+{
+
+/**
+ * Storage of a fully-associative ARM TLB.
+ *
+ * The entries live in fixed slots and are kept in MRU order by an
+ * intrusive doubly linked list, so a hit or a refill only relinks a
+ * slot instead of shifting the whole array. Lookups go through one hash
+ * index per page size, keyed by the page-aligned virtual address, so
+ * they only need to check the entries mapping the looked up page
+ * (e.g., the same VA in different address spaces) instead of scanning
+ * the whole TLB.
+ *
+ * The table behaves exactly like an array kept in MRU order: match()
+ * selects the same entry a linear scan from the MRU position would, an
+ * insertion replaces the entry in the LRU position, and invalidated
+ * entries keep their position until they are replaced.
+ */
+class TlbTable
+{
+  public:
+    using Lookup = TlbEntry::Lookup;
+
+    explicit TlbTable(int size);
+
+    int size() const { return entries.size(); }
+
+    /**
+     * Access an entry by its slot. The slots are not in MRU order, but
+     * iterating over all of them visits every entry of the table.
+     */
+    TlbEntry &operator[](int slot) { return entries[slot]; }
+    const TlbEntry &operator[](int slot) const { return entries[slot]; }
+
+    /** The entry in the LRU position, replaced by the next insertion. */
+    const TlbEntry &victim() const { return entries[tail]; }
+
+    /**
+     * Find the entry hit by a lookup. Among the entries matching the
+     * lookup, this returns the one with the highest lookup level,
+     * considering the entries up to the first complete translation in
+     * MRU order. A non-functional hit further than range_mru entries
+     * from the MRU position is moved to the MRU position.
+     *
+     * @param lookup The lookup data.
+     * @param range_mru Positions within which hits are not promoted.
+     * @return The matching entry or nullptr on a miss.
+     */
+    TlbEntry *match(const Lookup &lookup, int range_mru);
+
+    /**
+     * Insert an entry in the MRU position, replacing the LRU entry.
+     *
+     * @return The newly inserted entry.
+     */
+    TlbEntry *insert(const TlbEntry &entry);
+
+  private:
+    /** Entries of the table, indexed by slot. */
+    std::vector<TlbEntry> entries;
+
+    /** @{ */
+    /** MRU list, linked through slot numbers (-1 terminates the list). */
+    std::vector<int> prev;
+    std::vector<int> next;
+    int head;
+    int tail;
+    /** @} */
+
+    /**
+     * Age of each slot. A slot is closer to the MRU position than
+     * another if its age is larger, which lets match() order the
+     * matching entries without walking the MRU list.
+     */
+    std::vector<uint64_t> age;
+    uint64_t nextAge;
+
+    /** Hash index of the entries of a given page size. */
+    struct SizeIndex
+    {
+        Addr mask;
+        std::unordered_multimap<Addr, int> slots;
+    };
+    std::vector<SizeIndex> sizeIndex;
+
+    /** Entries whose mapping isn't a naturally aligned page. */
+    std::vector<int> unaligned;
+
+    /** Index in sizeIndex of each slot, or one of the values below. */
+    std::vector<int> slotIndex;
+    static constexpr int NotIndexed = -1;
+    static constexpr int Unaligned = -2;
+
+    /** Scratch list of the slots matching a lookup. */
+    std::vector<int> matches;
+
+    void addToIndex(int slot);
+    void removeFromIndex(int slot);
+    void moveToFront(int slot);
+    bool inMruRange(int slot, int range_mru) const;
+};
+
+} // namespace ArmISA
+} // namespace gem5
+
+#endif // __ARCH_ARM_TLB_TABLE_HH__
@@ -0,0 +1,252 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "arch/arm/tlb_table.hh"
+
+using namespace gem5;
+using namespace ArmISA;
+
+namespace
+{
+
+/**
+ * Reference model of the TLB storage: an array kept in MRU order that
+ * is scanned linearly, as the ARM TLB used to do.
+ */
+class LinearTable
+{
+  private:
+    std::vector<TlbEntry> table;
+
+  public:
+    explicit LinearTable(int size) : table(size) {}
+
+    TlbEntry &operator[](int idx) { return table[idx]; }
+
+    TlbEntry *
+    match(const TlbEntry::Lookup &lookup, int range_mru)
+    {
+        std::vector<std::pair<int, const TlbEntry*>> hits{
+            enums::Num_ArmLookupLevel, {0, nullptr}};
+
+        for (int x = 0; x < table.size(); ++x) {
+            if (table[x].match(lookup)) {
+                hits[table[x].lookupLevel] = std::make_pair(x, &table[x]);
+                if (!table[x].partial)
+                    break;
+            }
+        }
+
+        for (auto it = hits.rbegin(); it != hits.rend(); it++) {
+            const auto& [idx, entry] = *it;
+            if (!entry)
+                continue;
+
+            if (idx > range_mru && !lookup.functional) {
+                TlbEntry tmp_entry = *entry;
+                for (int i = idx; i > 0; i--)
+                    table[i] = table[i - 1];
+                table[0] = tmp_entry;
+                return &table[0];
+            } else {
+                return &table[idx];
+            }
+        }
+        return nullptr;
+    }
+
+    void
+    insert(const TlbEntry &entry)
+    {
+        for (int i = table.size() - 1; i > 0; --i)
+            table[i] = table[i - 1];
+        table[0] = entry;
+    }
+};
+
+/**
+ * Random translations over a small virtual address space, so that
+ * entries of different page sizes, address spaces and lookup levels
+ * often overlap.
+ */
+class Generator
+{
+  private:
+    std::mt19937_64 rng;
+
+  public:
+    explicit Generator(uint64_t seed) : rng(seed) {}
+
+    TlbEntry
+    entry()
+    {
+        static const uint8_t page_bits[] = { 12, 16, 21, 30 };
+
+        TlbEntry te;
+        te.N = page_bits[rng() % 4];
+        te.size = (Addr(1) << te.N) - 1;
+        te.vpn = (rng() % (Addr(1) << 32)) >> te.N;
+        te.pfn = rng() % 0x100000;
+        te.asid = rng() % 4;
+        te.vmid = rng() % 2;
+        te.global = rng() % 8 == 0;
+        te.nstid = rng() % 4 != 0;
+        te.el = rng() % 4 == 0 ? EL2 : EL1;
+        te.isHyp = te.el == EL2;
+        te.partial = rng() % 4 == 0;
+        te.lookupLevel = te.partial ?
+            enums::ArmLookupLevel(rng() % 3) : enums::L3;
+        te.valid = true;
+        return te;
+    }
+
+    TlbEntry::Lookup
+    lookup(const TlbEntry &te)
+    {
+        TlbEntry::Lookup lookup;
+        lookup.va = (te.vpn << te.N) + rng() % (te.size + 1);
+        lookup.asn = rng() % 4 == 0 ? rng() % 4 : te.asid;
+        lookup.ignoreAsn = rng() % 16 == 0;
+        lookup.vmid = te.vmid;
+        lookup.hyp = te.isHyp;
+        lookup.secure = !te.nstid;
+        lookup.targetEL = te.el;
+        lookup.functional = rng() % 8 == 0;
+        return lookup;
+    }
+
+    uint64_t operator()() { return rng(); }
+};
+
+} // anonymous namespace
+
+/**
+ * The table must hit the same entries as the linear array and keep the
+ * same MRU order, including for lookups hitting partial translations
+ * and for entries invalidated in place.
+ */
+TEST(TlbTableTest, MatchesLinearScan)
+{
+    for (int size : { 1, 4, 64, 512 }) {
+        TlbTable table(size);
+        LinearTable reference(size);
+        Generator gen(size);
+
+        std::vector<TlbEntry> inserted;
+        for (int i = 0; i < 50000; ++i) {
+            const uint64_t op = gen() % 16;
+            if (op < 4 || inserted.empty()) {
+                TlbEntry te = gen.entry();
+                table.insert(te);
+                reference.insert(te);
+                inserted.push_back(te);
+            } else if (op == 4) {
+                // Invalidate the same entry in both tables, which are
+                // expected to be in the same order.
+                const TlbEntry::Lookup lookup =
+                    gen.lookup(inserted[gen() % inserted.size()]);
+                TlbEntry *te = table.match(lookup, 1);
+                TlbEntry *ref = reference.match(lookup, 1);
+                ASSERT_EQ(te == nullptr, ref == nullptr);
+                if (te) {
+                    te->valid = false;
+                    ref->valid = false;
+                }
+            } else {
+                const TlbEntry::Lookup lookup =
+                    gen.lookup(inserted[gen() % inserted.size()]);
+                TlbEntry *te = table.match(lookup, 1);
+                TlbEntry *ref = reference.match(lookup, 1);
+                ASSERT_EQ(te == nullptr, ref == nullptr);
+                if (te) {
+                    ASSERT_EQ(te->vpn, ref->vpn);
+                    ASSERT_EQ(te->pfn, ref->pfn);
+                    ASSERT_EQ(te->N, ref->N);
+                    ASSERT_EQ(te->asid, ref->asid);
+                    ASSERT_EQ(te->lookupLevel, ref->lookupLevel);
+                }
+            }
+
+            ASSERT_EQ(table.victim().valid, reference[size - 1].valid);
+            ASSERT_EQ(table.victim().pfn, reference[size - 1].pfn);
+        }
+    }
+}
+
+/**
+ * A full TLB with a working set larger than the TLB, refilled on every
+ * miss, must miss exactly as often as the linear array.
+ */
+TEST(TlbTableTest, MissCountMatchesLinearScan)
+{
+    const int count = 20000;
+    for (int size : { 64, 512, 2048 }) {
+        Generator gen(1);
+        std::vector<TlbEntry> entries;
+        std::vector<std::pair<TlbEntry::Lookup, int>> lookups;
+        for (int i = 0; i < size * 2; ++i) {
+            // Mostly 4KiB pages and a few 2MiB ones over a 48-bit
+            // address space, as seen by a TLB of a large system.
+            TlbEntry te = gen.entry();
+            te.N = i % 8 == 0 ? 21 : 12;
+            te.size = (Addr(1) << te.N) - 1;
+            te.vpn = (gen() % (Addr(1) << 48)) >> te.N;
+            te.partial = false;
+            te.lookupLevel = enums::L3;
+            entries.push_back(te);
+        }
+        for (int i = 0; i < count; ++i) {
+            const int idx = gen() % entries.size();
+            TlbEntry::Lookup lookup = gen.lookup(entries[idx]);
+            lookup.functional = false;
+            lookups.emplace_back(lookup, idx);
+        }
+
+        TlbTable table(size);
+        LinearTable reference(size);
+
+        auto run = [&](auto &tlb) {
+            for (int i = 0; i < size; ++i)
+                tlb.insert(entries[i]);
+            int misses = 0;
+            for (const auto &[lookup, idx] : lookups) {
+                if (!tlb.match(lookup, 1)) {
+                    tlb.insert(entries[idx]);
+                    ++misses;
+                }
+            }
+            return misses;
+        };
+
+        const int linear_misses = run(reference);
+        ASSERT_EQ(run(table), linear_misses);
+        ASSERT_GT(linear_misses, 0);
+    }
+}
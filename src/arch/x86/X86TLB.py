@@ -34,10 +34,13 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from m5.params import *
+from m5.params import isNullPointer
 from m5.proxy import *
 
 from m5.objects.BaseTLB import BaseTLB
 from m5.objects.ClockedObject import ClockedObject
+from m5.objects.IndexingPolicies import *
+from m5.objects.ReplacementPolicies import *
 
 class X86PagetableWalker(ClockedObject):
     type = 'X86PagetableWalker'
@@ -55,6 +58,26 @@ class X86TLB(BaseTLB):
     cxx_header = 'arch/x86/tlb.hh'
 
     size = Param.Unsigned(64, "TLB size")
+    assoc = Param.Unsigned(0, "TLB associativity, 0 for a fully "
+            "associative TLB")
+    indexing_policy = Param.BaseIndexingPolicy(NULL,
+            "Indexing policy of a set-associative TLB, indexed by virtual "
+            "page number")
+    replacement_policy = Param.BaseReplacementPolicy(NULL,
+            "Replacement policy of a set-associative TLB")
     system = Param.System(Parent.any, "system object")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
+
+    def __init__(self, **kwargs):
+        super().__init__(**kwargs)
+
+        # Only a set-associative TLB gets the default policies. Its
+        # indexing policy is sized explicitly, as the size of the TLB is
+        # a number of entries rather than a MemorySize.
+        if int(self.assoc):
+            if isNullPointer(self.indexing_policy):
+                self.indexing_policy = SetAssociative(entry_size=1,
+                    assoc=self.assoc, size=f"{int(self.size)}B")
+            if isNullPointer(self.replacement_policy):
+                self.replacement_policy = LRURP()
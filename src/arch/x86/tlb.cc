@@ -50,6 +50,7 @@
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
 #include "debug/TLB.hh"
+#include "mem/cache/tags/indexing_policies/base.hh"
 #include "mem/packet_access.hh"
 #include "mem/page_table.hh"
 #include "mem/request.hh"
@@ -64,14 +65,36 @@ namespace X86ISA {
 
 TLB::TLB(const Params &p)
     : BaseTLB(p), configAddress(0), size(p.size),
-      tlb(size), lruSeq(0), m5opRange(p.system->m5opRange()), stats(this)
+      tlb(p.assoc ? 0 : size), lruSeq(0),
+      m5opRange(p.system->m5opRange()), stats(this)
 {
     if (!size)
         fatal("TLBs must have a non-zero size.\n");
 
-    for (int x = 0; x < size; x++) {
-        tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
+    if (p.assoc) {
+        fatal_if(p.assoc > size || size % p.assoc,
+                 "The TLB associativity (%d) must divide its size (%d).\n",
+                 p.assoc, size);
+        fatal_if(!p.indexing_policy,
+                 "A set-associative TLB needs an indexing policy.\n");
+        fatal_if(!p.replacement_policy,
+                 "A set-associative TLB needs a replacement policy.\n");
+        const auto &indexing_params =
+            dynamic_cast<const BaseIndexingPolicy::Params &>(
+                p.indexing_policy->params());
+        fatal_if(indexing_params.size != size ||
+                 indexing_params.assoc != p.assoc ||
+                 indexing_params.entry_size != 1,
+                 "The indexing policy of the TLB must have its size (%d) "
+                 "and associativity (%d), and an entry size of 1.\n",
+                 size, p.assoc);
+        sets.reset(new TlbSets(p.assoc, size, p.indexing_policy,
+                               p.replacement_policy));
+    } else {
+        for (int x = 0; x < size; x++) {
+            tlb[x].trieHandle = NULL;
+            freeList.push_back(&tlb[x]);
+        }
     }
 
     walker = p.walker;
@@ -99,6 +122,12 @@ TLB::evictLRU()
 TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
+    if (sets) {
+        TlbEntry *new_entry = sets->insert(vpn, entry);
+        new_entry->lruSeq = nextSeq();
+        return new_entry;
+    }
+
     // If somebody beat us to it, just use that existing entry.
     TlbEntry *newEntry = trie.lookup(vpn);
     if (newEntry) {
@@ -123,6 +152,13 @@ TLB::insert(Addr vpn, const TlbEntry &entry)
 TlbEntry *
 TLB::lookup(Addr va, bool update_lru)
 {
+    if (sets) {
+        TlbEntry *entry = sets->lookup(va, update_lru);
+        if (entry && update_lru)
+            entry->lruSeq = nextSeq();
+        return entry;
+    }
+
     TlbEntry *entry = trie.lookup(va);
     if (entry && update_lru)
         entry->lruSeq = nextSeq();
@@ -133,6 +169,11 @@ void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
+    if (sets) {
+        sets->flush(false);
+        return;
+    }
+
     for (unsigned i = 0; i < size; i++) {
         if (tlb[i].trieHandle) {
             trie.remove(tlb[i].trieHandle);
@@ -152,6 +193,11 @@ void
 TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
+    if (sets) {
+        sets->flush(true);
+        return;
+    }
+
     for (unsigned i = 0; i < size; i++) {
         if (tlb[i].trieHandle && !tlb[i].global) {
             trie.remove(tlb[i].trieHandle);
@@ -164,6 +210,11 @@ TLB::flushNonGlobal()
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
+    if (sets) {
+        sets->demap(va);
+        return;
+    }
+
     TlbEntry *entry = trie.lookup(va);
     if (entry) {
         trie.remove(entry->trieHandle);
@@ -557,10 +608,21 @@ TLB::serialize(CheckpointOut &cp) const
 {
     // Only store the entries in use.
     uint32_t _size = size - freeList.size();
+    if (sets) {
+        _size = 0;
+        sets->forEachEntry([&_size](const TlbEntry &entry) { _size++; });
+    }
     SERIALIZE_SCALAR(_size);
     SERIALIZE_SCALAR(lruSeq);
 
     uint32_t _count = 0;
+    if (sets) {
+        sets->forEachEntry([&cp, &_count](const TlbEntry &entry) {
+            entry.serializeSection(cp, csprintf("Entry%d", _count++));
+        });
+        return;
+    }
+
     for (uint32_t x = 0; x < size; x++) {
         if (tlb[x].trieHandle != NULL)
             tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
@@ -579,6 +641,18 @@ TLB::unserialize(CheckpointIn &cp)
 
     UNSERIALIZE_SCALAR(lruSeq);
 
+    if (sets) {
+        // Entries of a checkpoint taken with a different organization
+        // may conflict, in which case the last one inserted in a set
+        // wins.
+        for (uint32_t x = 0; x < _size; x++) {
+            TlbEntry entry;
+            entry.unserializeSection(cp, csprintf("Entry%d", x));
+            insert(entry.vaddr, entry);
+        }
+        return;
+    }
+
     for (uint32_t x = 0; x < _size; x++) {
         TlbEntry *newEntry = freeList.front();
         freeList.pop_front();
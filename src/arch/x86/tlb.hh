@@ -39,10 +39,12 @@
 #define __ARCH_X86_TLB_HH__
 
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
+#include "arch/x86/tlb_sets.hh"
 #include "base/trie.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
@@ -102,6 +104,12 @@ namespace X86ISA
         TlbEntryTrie trie;
         uint64_t lruSeq;
 
+        /**
+         * Storage of a set-associative TLB, null when the TLB is fully
+         * associative.
+         */
+        std::unique_ptr<TlbSets> sets;
+
         AddrRange m5opRange;
 
         struct TlbStats : public statistics::Group
@@ -0,0 +1,118 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/x86/tlb_sets.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "mem/cache/prefetch/associative_set_impl.hh"
+
+namespace gem5
+{
+
+namespace X86ISA
+{
+
+TlbSets::TlbSets(unsigned assoc, unsigned num_entries,
+                 BaseIndexingPolicy *indexing_policy,
+                 replacement_policy::Base *replacement_policy)
+    : assoc(assoc),
+      entries(assoc, num_entries, indexing_policy, replacement_policy)
+{
+}
+
+TlbSets::Entry *
+TlbSets::find(Addr va) const
+{
+    // Mirror the trie of the fully associative TLB, which matches the
+    // address bits above the page offset of each entry.
+    for (unsigned log_bytes : pageSizes) {
+        const Addr key = va >> log_bytes;
+        for (unsigned way = 0; way < assoc; way++) {
+            Entry *candidate = entries.getPossibleEntry(key, way);
+            if (candidate->isValid() &&
+                    candidate->entry.logBytes == log_bytes &&
+                    (candidate->entry.vaddr >> log_bytes) == key) {
+                return candidate;
+            }
+        }
+    }
+    return nullptr;
+}
+
+TlbEntry *
+TlbSets::lookup(Addr va, bool touch)
+{
+    Entry *entry = find(va);
+    if (!entry)
+        return nullptr;
+    if (touch)
+        entries.accessEntry(entry);
+    return &entry->entry;
+}
+
+TlbEntry *
+TlbSets::insert(Addr vpn, const TlbEntry &entry)
+{
+    // If somebody beat us to it, just use that existing entry.
+    Entry *existing = find(vpn);
+    if (existing) {
+        assert(existing->entry.vaddr == vpn);
+        return &existing->entry;
+    }
+
+    if (std::find(pageSizes.begin(), pageSizes.end(),
+                  entry.logBytes) == pageSizes.end()) {
+        pageSizes.push_back(entry.logBytes);
+    }
+
+    const Addr key = vpn >> entry.logBytes;
+    Entry *victim = entries.findVictim(key);
+    victim->entry = entry;
+    victim->entry.vaddr = vpn;
+    entries.insertEntry(key, false, victim);
+    return &victim->entry;
+}
+
+void
+TlbSets::demap(Addr va)
+{
+    Entry *entry = find(va);
+    if (entry)
+        entries.invalidate(entry);
+}
+
+void
+TlbSets::flush(bool keep_global)
+{
+    for (auto &entry : entries) {
+        if (entry.isValid() && !(keep_global && entry.entry.global))
+            entries.invalidate(&entry);
+    }
+}
+
+} // namespace X86ISA
+} // namespace gem5
@@ -0,0 +1,123 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_X86_TLB_SETS_HH__
+#define __ARCH_X86_TLB_SETS_HH__
+
+#include <vector>
+
+#include "arch/x86/pagetable.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/associative_set.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+
+namespace gem5
+{
+
+class BaseIndexingPolicy;
+
+namespace replacement_policy
+{
+class Base;
+} // namespace replacement_policy
+
+namespace X86ISA
+{
+
+/**
+ * Storage of a set-associative X86 TLB.
+ *
+ * The entries are indexed by their virtual address shifted by their
+ * page size, so a lookup probes the ways of one set per page size in
+ * use, and a refill replaces the victim the replacement policy picks
+ * among the entries of a single set.
+ */
+class TlbSets
+{
+  public:
+    TlbSets(unsigned assoc, unsigned num_entries,
+            BaseIndexingPolicy *indexing_policy,
+            replacement_policy::Base *replacement_policy);
+
+    /**
+     * Find the entry that maps an address.
+     *
+     * @param va Virtual address to look up.
+     * @param touch Whether to update the replacement data of the entry.
+     * @return The entry, or nullptr on a miss.
+     */
+    TlbEntry *lookup(Addr va, bool touch);
+
+    /**
+     * Insert an entry, unless one already maps its page, in place of
+     * the victim of its set.
+     *
+     * @param vpn Virtual address of the page.
+     * @param entry Entry to insert.
+     * @return The inserted entry, or the one already mapping the page.
+     */
+    TlbEntry *insert(Addr vpn, const TlbEntry &entry);
+
+    /** Invalidate the entry that maps an address, if any. */
+    void demap(Addr va);
+
+    /**
+     * Invalidate the entries.
+     *
+     * @param keep_global Whether to keep the global entries.
+     */
+    void flush(bool keep_global);
+
+    /** Call a function on each valid entry. */
+    template <class F>
+    void
+    forEachEntry(F f) const
+    {
+        for (const auto &entry : entries) {
+            if (entry.isValid())
+                f(entry.entry);
+        }
+    }
+
+  private:
+    struct Entry : public TaggedEntry
+    {
+        TlbEntry entry;
+    };
+
+    const unsigned assoc;
+
+    AssociativeSet<Entry> entries;
+
+    /** Page sizes, in address bits, of the inserted entries. */
+    std::vector<unsigned> pageSizes;
+
+    Entry *find(Addr va) const;
+};
+
+} // namespace X86ISA
+} // namespace gem5
+
+#endif // __ARCH_X86_TLB_SETS_HH__
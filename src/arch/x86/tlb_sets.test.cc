@@ -0,0 +1,185 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "arch/x86/tlb_sets.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "params/LRURP.hh"
+#include "params/SetAssociative.hh"
+#include "sim/cur_tick.hh"
+
+using namespace gem5;
+using namespace X86ISA;
+
+namespace
+{
+
+/** Four sets of two ways, with an LRU policy. */
+class TlbSetsTest : public testing::Test
+{
+  protected:
+    Tick tick = 0;
+    std::unique_ptr<replacement_policy::LRU> rp;
+    std::unique_ptr<SetAssociative> indexing;
+    std::unique_ptr<TlbSets> sets;
+
+    void
+    SetUp() override
+    {
+        Gem5Internal::_curTickPtr = &tick;
+
+        LRURPParams rp_params;
+        rp_params.name = "rp";
+        rp_params.eventq_index = 0;
+        rp.reset(new replacement_policy::LRU(rp_params));
+
+        SetAssociativeParams indexing_params;
+        indexing_params.name = "indexing";
+        indexing_params.eventq_index = 0;
+        indexing_params.size = 8;
+        indexing_params.entry_size = 1;
+        indexing_params.assoc = 2;
+        indexing.reset(new SetAssociative(indexing_params));
+
+        sets.reset(new TlbSets(2, 8, indexing.get(), rp.get()));
+    }
+
+    /** Insert a mapping of a page, one tick later. */
+    TlbEntry *
+    insert(Addr vaddr, Addr paddr, unsigned log_bytes = 12,
+           bool global = false)
+    {
+        tick++;
+        TlbEntry entry(0, vaddr, paddr, false, false);
+        entry.logBytes = log_bytes;
+        entry.global = global;
+        return sets->insert(vaddr, entry);
+    }
+
+    /** Look an address up, one tick later. */
+    TlbEntry *
+    lookup(Addr va)
+    {
+        tick++;
+        return sets->lookup(va, true);
+    }
+
+    /** The virtual page of a given set and tag, for 4KiB pages. */
+    static Addr
+    page(unsigned set, unsigned tag)
+    {
+        return Addr(tag * 4 + set) << 12;
+    }
+};
+
+} // anonymous namespace
+
+TEST_F(TlbSetsTest, LookupInsert)
+{
+    EXPECT_EQ(lookup(0x1000), nullptr);
+
+    TlbEntry *entry = insert(0x1000, 0x8000);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->vaddr, 0x1000U);
+    EXPECT_EQ(entry->paddr, 0x8000U);
+
+    // Any address of the page hits, the next page does not
+    EXPECT_EQ(lookup(0x1000), entry);
+    EXPECT_EQ(lookup(0x1abc), entry);
+    EXPECT_EQ(lookup(0x2000), nullptr);
+
+    // Inserting a page twice keeps the existing mapping
+    EXPECT_EQ(insert(0x1000, 0x9000), entry);
+    EXPECT_EQ(entry->paddr, 0x8000U);
+}
+
+TEST_F(TlbSetsTest, PageSizes)
+{
+    TlbEntry *small = insert(0x1000, 0x8000);
+    TlbEntry *large = insert(0x40000000, 0x80000000, 21);
+
+    EXPECT_EQ(lookup(0x1fff), small);
+    EXPECT_EQ(lookup(0x40000000), large);
+    EXPECT_EQ(lookup(0x401fffff), large);
+    EXPECT_EQ(lookup(0x40200000), nullptr);
+}
+
+TEST_F(TlbSetsTest, CapacityEviction)
+{
+    // Fill both ways of set 1, and make the first page the LRU one
+    TlbEntry *first = insert(page(1, 0), 0x10000);
+    TlbEntry *second = insert(page(1, 1), 0x20000);
+    EXPECT_EQ(lookup(page(1, 1)), second);
+    EXPECT_EQ(lookup(page(1, 0)), first);
+
+    // Another set does not evict anything
+    TlbEntry *other = insert(page(2, 0), 0x30000);
+    EXPECT_EQ(lookup(page(1, 1)), second);
+    EXPECT_EQ(lookup(page(1, 0)), first);
+
+    // A third page of set 1 replaces the LRU one, the second page
+    TlbEntry *third = insert(page(1, 2), 0x40000);
+    EXPECT_EQ(third, second);
+    EXPECT_EQ(third->vaddr, page(1, 2));
+    EXPECT_EQ(lookup(page(1, 1)), nullptr);
+    EXPECT_EQ(lookup(page(1, 0)), first);
+    EXPECT_EQ(lookup(page(1, 2)), third);
+    EXPECT_EQ(lookup(page(2, 0)), other);
+}
+
+TEST_F(TlbSetsTest, Demap)
+{
+    insert(page(0, 0), 0x10000);
+    TlbEntry *kept = insert(page(0, 1), 0x20000);
+
+    sets->demap(page(0, 0) + 0x123);
+    EXPECT_EQ(lookup(page(0, 0)), nullptr);
+    EXPECT_EQ(lookup(page(0, 1)), kept);
+
+    // The invalidated way is refilled before the valid one is evicted
+    EXPECT_NE(insert(page(0, 2), 0x30000), kept);
+    EXPECT_EQ(lookup(page(0, 1)), kept);
+}
+
+TEST_F(TlbSetsTest, Flush)
+{
+    insert(page(0, 0), 0x10000);
+    TlbEntry *global = insert(page(1, 0), 0x20000, 12, true);
+
+    sets->flush(true);
+    EXPECT_EQ(lookup(page(0, 0)), nullptr);
+    EXPECT_EQ(lookup(page(1, 0)), global);
+
+    unsigned count = 0;
+    sets->forEachEntry([&count](const TlbEntry &entry) { count++; });
+    EXPECT_EQ(count, 1U);
+
+    sets->flush(false);
+    EXPECT_EQ(lookup(page(1, 0)), nullptr);
+}
@@ -0,0 +1,255 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/block_pool.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace gem5
+{
+
+namespace
+{
+
+/** Protects the list of pools, the list of threads, and their caches. */
+std::mutex &
+registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<BlockPool *> &
+allPools()
+{
+    static std::vector<BlockPool *> pools;
+    return pools;
+}
+
+/** Add a pool to the registry, returning its id. */
+std::size_t
+registerPool(BlockPool *pool)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    allPools().push_back(pool);
+    return allPools().size() - 1;
+}
+
+/** Set once the caches of this thread are destroyed. */
+thread_local bool threadExited = false;
+
+/** Count an event of this thread, which is the only one updating it. */
+void
+increment(std::atomic<uint64_t> &counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+/** Free list and counts of a pool in a given thread. */
+struct BlockPool::ThreadCache
+{
+    /** Size of the blocks on the free list. */
+    std::size_t blockSize = 0;
+    std::vector<void *> blocks;
+
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> reuses{0};
+};
+
+/** Caches of all the pools in a given thread. */
+struct BlockPool::ThreadCaches
+{
+    /** Caches indexed by pool id. */
+    std::vector<std::unique_ptr<ThreadCache>> caches;
+
+    static std::vector<ThreadCaches *> &
+    threads()
+    {
+        static std::vector<ThreadCaches *> threads;
+        return threads;
+    }
+
+    ThreadCaches()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        threads().push_back(this);
+    }
+
+    ~ThreadCaches()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        auto &list = threads();
+        list.erase(std::find(list.begin(), list.end(), this));
+
+        for (std::size_t id = 0; id < caches.size(); id++) {
+            ThreadCache &cache = *caches[id];
+            BlockPool &pool = *allPools()[id];
+            pool.exitedAllocations += cache.allocations;
+            pool.exitedReuses += cache.reuses;
+            for (void *block : cache.blocks)
+                ::operator delete(block);
+        }
+
+        // Blocks released by this thread from now on, e.g., by the
+        // destructors of other thread local objects, are freed.
+        threadExited = true;
+    }
+};
+
+BlockPool::BlockPool(const std::string &name, std::size_t block_size,
+                     bool enabled)
+    : _name(name), id(registerPool(this)), blockSize(block_size),
+      _enabled(enabled), exitedAllocations(0), exitedReuses(0),
+      sharedBlockSize(0)
+{
+}
+
+BlockPool::~BlockPool()
+{
+    for (void *block : sharedBlocks)
+        ::operator delete(block);
+}
+
+BlockPool::ThreadCache *
+BlockPool::threadCache()
+{
+    if (threadExited)
+        return nullptr;
+
+    thread_local ThreadCaches thread_caches;
+    auto &caches = thread_caches.caches;
+    if (id >= caches.size()) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        while (caches.size() <= id)
+            caches.emplace_back(new ThreadCache);
+    }
+    return caches[id].get();
+}
+
+void *
+BlockPool::allocate(std::size_t size)
+{
+    ThreadCache *cache = _enabled ? threadCache() : nullptr;
+    if (!cache)
+        return ::operator new(size);
+
+    if (cache->blockSize == 0)
+        cache->blockSize = blockSize ? blockSize : size;
+    if (size != cache->blockSize)
+        return ::operator new(size);
+
+    increment(cache->allocations);
+    if (cache->blocks.empty())
+        refill(*cache);
+    if (!cache->blocks.empty()) {
+        increment(cache->reuses);
+        void *block = cache->blocks.back();
+        cache->blocks.pop_back();
+        return block;
+    }
+    return ::operator new(size);
+}
+
+void
+BlockPool::deallocate(void *block, std::size_t size)
+{
+    ThreadCache *cache = _enabled ? threadCache() : nullptr;
+    if (cache && cache->blockSize == 0)
+        cache->blockSize = blockSize ? blockSize : size;
+    if (cache && size == cache->blockSize) {
+        if (cache->blocks.size() == MaxLocalBlocks)
+            releaseSurplus(*cache);
+        cache->blocks.push_back(block);
+    } else {
+        ::operator delete(block);
+    }
+}
+
+void
+BlockPool::releaseSurplus(ThreadCache &cache)
+{
+    auto first = cache.blocks.begin() + MaxLocalBlocks / 2;
+    {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        // With a block size taken from the first allocation of each
+        // thread, the threads may not agree on it: only the blocks of
+        // the first size released are shared
+        if (sharedBlocks.empty())
+            sharedBlockSize = cache.blockSize;
+        if (cache.blockSize == sharedBlockSize) {
+            sharedBlocks.insert(sharedBlocks.end(), first,
+                                cache.blocks.end());
+            first = cache.blocks.end();
+        }
+    }
+    for (auto it = first; it != cache.blocks.end(); ++it)
+        ::operator delete(*it);
+    cache.blocks.resize(MaxLocalBlocks / 2);
+}
+
+void
+BlockPool::refill(ThreadCache &cache)
+{
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (sharedBlocks.empty() || cache.blockSize != sharedBlockSize)
+        return;
+    const std::size_t count =
+        std::min(sharedBlocks.size(), MaxLocalBlocks / 2);
+    cache.blocks.assign(sharedBlocks.end() - count, sharedBlocks.end());
+    sharedBlocks.resize(sharedBlocks.size() - count);
+}
+
+uint64_t
+BlockPool::allocations() const
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    uint64_t count = exitedAllocations;
+    for (auto *thread : ThreadCaches::threads()) {
+        if (id < thread->caches.size())
+            count += thread->caches[id]->allocations;
+    }
+    return count;
+}
+
+uint64_t
+BlockPool::reuses() const
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    uint64_t count = exitedReuses;
+    for (auto *thread : ThreadCaches::threads()) {
+        if (id < thread->caches.size())
+            count += thread->caches[id]->reuses;
+    }
+    return count;
+}
+
+} // namespace gem5
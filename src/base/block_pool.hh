@@ -0,0 +1,184 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_BLOCK_POOL_HH__
+#define __BASE_BLOCK_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gem5
+{
+
+/**
+ * Pool of fixed-size memory blocks for objects which are created and
+ * destroyed at a high rate, e.g., packets, requests and Ruby messages.
+ * Released blocks are kept on a free list owned by the releasing thread
+ * and handed out again by the next allocations of this thread, so the
+ * simulated components neither call malloc for every object in steady
+ * state nor contend on the allocator when several event queues run in
+ * parallel. The free list of a thread holds at most MaxLocalBlocks
+ * blocks: the surplus moves to a list shared by all the threads, which
+ * refills the threads running out of blocks, so blocks allocated by one
+ * thread and released by another are reused rather than piling up.
+ *
+ * A disabled pool behaves like plain operator new and delete. Blocks are
+ * always obtained from operator new, so a pool can be enabled or
+ * disabled at any time, even with blocks in flight.
+ *
+ * Pools are meant to be static objects, they must outlive the threads
+ * using them.
+ */
+class BlockPool
+{
+  public:
+    /**
+     * @param name Name of the pool in the stats.
+     * @param block_size Size of the pooled blocks, or 0 to use the size
+     *                   of the first allocation or release of each thread.
+     * @param enabled Whether the free lists are used initially.
+     */
+    BlockPool(const std::string &name, std::size_t block_size = 0,
+              bool enabled = true);
+
+    ~BlockPool();
+
+    /** Maximum number of blocks on the free list of a thread. */
+    static const std::size_t MaxLocalBlocks = 1024;
+
+    const std::string &name() const { return _name; }
+
+    void enable(bool en) { _enabled = en; }
+    bool enabled() const { return _enabled; }
+
+    /**
+     * Allocate a block. Only blocks of the pool block size are served by
+     * the free lists, other sizes are forwarded to operator new.
+     */
+    void *allocate(std::size_t size);
+
+    /** Release a block obtained from allocate() with the same size. */
+    void deallocate(void *block, std::size_t size);
+
+    /** Number of pooled allocations so far by all threads. */
+    uint64_t allocations() const;
+
+    /** Number of pooled allocations served by a free list. */
+    uint64_t reuses() const;
+
+  private:
+    struct ThreadCache;
+    struct ThreadCaches;
+
+    ThreadCache *threadCache();
+
+    /**
+     * Move the blocks of a thread free list beyond half its capacity to
+     * the shared list.
+     */
+    void releaseSurplus(ThreadCache &cache);
+
+    /** Refill an empty thread free list from the shared list. */
+    void refill(ThreadCache &cache);
+
+    const std::string _name;
+
+    /** Index of the pool in the caches of each thread. */
+    const std::size_t id;
+
+    const std::size_t blockSize;
+
+    bool _enabled;
+
+    /** @{ */
+    /** Counts of the threads which have exited. */
+    uint64_t exitedAllocations;
+    uint64_t exitedReuses;
+    /** @} */
+
+    /** @{ */
+    /** Blocks shared by the threads, and their size. */
+    std::mutex sharedMutex;
+    std::vector<void *> sharedBlocks;
+    std::size_t sharedBlockSize;
+    /** @} */
+};
+
+/**
+ * Standard allocator handing out the blocks of a BlockPool, e.g., for
+ * use with std::allocate_shared().
+ */
+template <class T>
+class BlockPoolAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit BlockPoolAllocator(BlockPool &pool) : pool(&pool) {}
+
+    template <class U>
+    BlockPoolAllocator(const BlockPoolAllocator<U> &other)
+        : pool(other.pool)
+    {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        return static_cast<T *>(pool->allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, std::size_t n)
+    {
+        pool->deallocate(p, n * sizeof(T));
+    }
+
+    template <class U>
+    bool
+    operator==(const BlockPoolAllocator<U> &other) const
+    {
+        return pool == other.pool;
+    }
+
+    template <class U>
+    bool
+    operator!=(const BlockPoolAllocator<U> &other) const
+    {
+        return pool != other.pool;
+    }
+
+  private:
+    template <class U>
+    friend class BlockPoolAllocator;
+
+    BlockPool *pool;
+};
+
+} // namespace gem5
+
+#endif // __BASE_BLOCK_POOL_HH__
@@ -0,0 +1,158 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/block_pool.hh"
+
+using namespace gem5;
+
+/** Released blocks are handed out again by the next allocations. */
+TEST(BlockPoolTest, ReusesBlocks)
+{
+    static BlockPool pool("reuse", 64);
+
+    void *a = pool.allocate(64);
+    void *b = pool.allocate(64);
+    pool.deallocate(a, 64);
+    pool.deallocate(b, 64);
+    ASSERT_EQ(pool.allocate(64), b);
+    ASSERT_EQ(pool.allocate(64), a);
+    pool.deallocate(a, 64);
+    pool.deallocate(b, 64);
+
+    ASSERT_EQ(pool.allocations(), 4u);
+    ASSERT_EQ(pool.reuses(), 2u);
+}
+
+/** Only allocations of the block size go through the pool. */
+TEST(BlockPoolTest, OtherSizes)
+{
+    static BlockPool pool("sizes", 64);
+
+    void *a = pool.allocate(128);
+    pool.deallocate(a, 128);
+    void *b = pool.allocate(64);
+    pool.deallocate(b, 64);
+
+    ASSERT_EQ(pool.allocations(), 1u);
+    ASSERT_EQ(pool.reuses(), 0u);
+}
+
+/** Without a block size, the size of the first allocation is pooled. */
+TEST(BlockPoolTest, FirstSize)
+{
+    static BlockPool pool("first");
+
+    pool.deallocate(pool.allocate(24), 24);
+    pool.deallocate(pool.allocate(48), 48);
+    pool.deallocate(pool.allocate(24), 24);
+
+    ASSERT_EQ(pool.allocations(), 2u);
+    ASSERT_EQ(pool.reuses(), 1u);
+}
+
+/** A disabled pool behaves like the heap, even with blocks in flight. */
+TEST(BlockPoolTest, Disabled)
+{
+    static BlockPool pool("disabled", 64, false);
+    ASSERT_FALSE(pool.enabled());
+
+    void *a = pool.allocate(64);
+    pool.enable(true);
+    void *b = pool.allocate(64);
+    pool.deallocate(a, 64);
+    pool.enable(false);
+    pool.deallocate(b, 64);
+    pool.deallocate(pool.allocate(64), 64);
+
+    ASSERT_EQ(pool.allocations(), 1u);
+    ASSERT_EQ(pool.reuses(), 0u);
+}
+
+/** The pool works with standard allocators, e.g., for shared pointers. */
+TEST(BlockPoolTest, SharedPointers)
+{
+    static BlockPool pool("shared");
+
+    for (int i = 0; i < 100; ++i) {
+        auto p = std::allocate_shared<int>(BlockPoolAllocator<int>(pool),
+                                           i);
+        ASSERT_EQ(*p, i);
+    }
+
+    ASSERT_EQ(pool.allocations(), 100u);
+    ASSERT_EQ(pool.reuses(), 99u);
+}
+
+/** The counts of all the threads, including exited ones, are kept. */
+TEST(BlockPoolTest, Threads)
+{
+    static BlockPool pool("threads", 64);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]{
+            for (int i = 0; i < 1000; ++i)
+                pool.deallocate(pool.allocate(64), 64);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_EQ(pool.allocations(), 4000u);
+    ASSERT_EQ(pool.reuses(), 4u * 999);
+}
+
+/**
+ * Blocks allocated by one thread and released by another go through the
+ * shared list, instead of piling up on the free list of the releasing
+ * thread.
+ */
+TEST(BlockPoolTest, ProducerConsumer)
+{
+    static BlockPool pool("producer", 64);
+    const int rounds = 10;
+    const size_t batch = 4 * BlockPool::MaxLocalBlocks;
+
+    for (int r = 0; r < rounds; ++r) {
+        std::vector<void *> blocks;
+        for (size_t i = 0; i < batch; ++i)
+            blocks.push_back(pool.allocate(64));
+        std::thread consumer([&blocks]{
+            for (void *block : blocks)
+                pool.deallocate(block, 64);
+        });
+        consumer.join();
+    }
+
+    ASSERT_EQ(pool.allocations(), rounds * batch);
+    // all but the blocks kept by each consumer are reused
+    ASSERT_GE(pool.reuses(), (rounds - 1) * (batch / 2));
+}
@@ -0,0 +1,224 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_READ_AHEAD_HH__
+#define __BASE_READ_AHEAD_HH__
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gem5
+{
+
+/**
+ * Read ahead of a sequential reader on a helper thread.
+ *
+ * The records are produced by a fetch function, e.g., one decoding
+ * the next message of a trace, called from a helper thread. Fetched
+ * records are stored in a bounded ring of batches, so the helper thread
+ * runs at most the capacity of the ring ahead of the consumer, and the
+ * threads only synchronize once per batch.
+ *
+ * The helper thread is started by the first read, and exits once the
+ * fetch function signals the end of the input. Anything the fetch
+ * function uses must not be touched by the consumer while the helper
+ * thread runs, stop() has to be called first, e.g., to rewind the
+ * underlying stream.
+ *
+ * @tparam Record Type of the records, overwritten by the fetch function
+ */
+template <typename Record>
+class ReadAhead
+{
+  public:
+    /**
+     * Function reading the next record into its argument, and
+     * returning false at the end of the input.
+     */
+    using Fetch = std::function<bool(Record &)>;
+
+    /**
+     * @param fetch Function reading the next record.
+     * @param batch_size Number of records handed over at once.
+     * @param num_batches Number of batches in the ring.
+     */
+    ReadAhead(Fetch fetch, size_t batch_size=4096, size_t num_batches=4)
+        : fetch(std::move(fetch)), batchSize(batch_size),
+          batches(num_batches, Batch(batch_size))
+    {}
+
+    ~ReadAhead() { stop(); }
+
+    ReadAhead(const ReadAhead &) = delete;
+    ReadAhead &operator=(const ReadAhead &) = delete;
+
+    /**
+     * Get the next record.
+     *
+     * @param record Record to move the next record into.
+     * @return False if the end of the input was reached.
+     */
+    bool
+    read(Record &record)
+    {
+        if (!helper.joinable())
+            start();
+
+        if (readPos == readSize && !nextBatch())
+            return false;
+
+        record = std::move(batches[readBatch].records[readPos++]);
+        return true;
+    }
+
+    /**
+     * Stop the helper thread and drop the records read ahead. The next
+     * read starts reading ahead again.
+     */
+    void
+    stop()
+    {
+        if (helper.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+            cond.notify_all();
+            helper.join();
+        }
+
+        filled = 0;
+        readBatch = 0;
+        holding = false;
+        readPos = 0;
+        readSize = 0;
+        ended = false;
+        stopping = false;
+    }
+
+  private:
+    struct Batch
+    {
+        Batch(size_t size) : records(size) {}
+
+        std::vector<Record> records;
+        size_t size = 0;
+    };
+
+    void
+    start()
+    {
+        helper = std::thread([this]{ fetchBatches(); });
+    }
+
+    /**
+     * Release the batch being read and wait for the next one.
+     *
+     * @return False if the end of the input was reached.
+     */
+    bool
+    nextBatch()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (holding) {
+            holding = false;
+            --filled;
+            readBatch = (readBatch + 1) % batches.size();
+            cond.notify_all();
+        }
+
+        cond.wait(guard, [this]{ return filled != 0 || ended; });
+        if (filled == 0)
+            return false;
+
+        holding = true;
+        readPos = 0;
+        readSize = batches[readBatch].size;
+        return readSize != 0;
+    }
+
+    /** Main loop of the helper thread. */
+    void
+    fetchBatches()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            cond.wait(guard, [this]{
+                return stopping || filled != batches.size();
+            });
+            if (stopping)
+                return;
+
+            // The consumer never touches the batches past the filled
+            // ones, so this one can be filled without holding the lock
+            Batch &batch = batches[(readBatch + filled) % batches.size()];
+            guard.unlock();
+            size_t size = 0;
+            bool more = true;
+            while (size < batchSize && (more = fetch(batch.records[size])))
+                ++size;
+            guard.lock();
+
+            batch.size = size;
+            ++filled;
+            ended = !more;
+            cond.notify_all();
+            if (ended)
+                return;
+        }
+    }
+
+    Fetch fetch;
+    const size_t batchSize;
+    std::vector<Batch> batches;
+
+    std::thread helper;
+    std::mutex lock;
+    std::condition_variable cond;
+
+    /** @{ */
+    /** State shared with the helper thread, protected by the lock. */
+    size_t filled = 0;
+    size_t readBatch = 0;
+    bool ended = false;
+    bool stopping = false;
+    /** @} */
+
+    /** @{ */
+    /** State of the consumer. */
+    bool holding = false;
+    size_t readPos = 0;
+    size_t readSize = 0;
+    /** @} */
+};
+
+} // namespace gem5
+
+#endif // __BASE_READ_AHEAD_HH__
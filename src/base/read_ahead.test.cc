@@ -0,0 +1,125 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "base/read_ahead.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Fetch function producing the integers up to a limit. */
+struct Counter
+{
+    int next = 0;
+    int limit;
+
+    Counter(int limit) : limit(limit) {}
+
+    bool
+    operator()(int &record)
+    {
+        if (next == limit)
+            return false;
+        record = next++;
+        return true;
+    }
+};
+
+std::vector<int>
+readAll(ReadAhead<int> &reader)
+{
+    std::vector<int> records;
+    int record;
+    while (reader.read(record))
+        records.push_back(record);
+    return records;
+}
+
+} // anonymous namespace
+
+/** The records come out in order, whatever the batch boundaries. */
+TEST(ReadAheadTest, InOrder)
+{
+    for (int limit : { 0, 1, 7, 8, 9, 100, 10000 }) {
+        Counter counter(limit);
+        ReadAhead<int> reader(std::ref(counter), 8, 3);
+
+        std::vector<int> expected;
+        for (int i = 0; i < limit; ++i)
+            expected.push_back(i);
+
+        ASSERT_EQ(readAll(reader), expected);
+
+        // The end of the input is sticky
+        int record;
+        ASSERT_FALSE(reader.read(record));
+    }
+}
+
+/** Stopping drops the records read ahead and restarts the helper. */
+TEST(ReadAheadTest, Stop)
+{
+    Counter counter(1000);
+    ReadAhead<int> reader(std::ref(counter), 16, 2);
+
+    int record;
+    ASSERT_TRUE(reader.read(record));
+    ASSERT_EQ(record, 0);
+
+    // Rewind the input, as done when a trace is reset
+    reader.stop();
+    counter.next = 0;
+    ASSERT_EQ(readAll(reader).size(), 1000u);
+
+    // Restart after the end of the input was reached
+    reader.stop();
+    counter.next = 990;
+    ASSERT_EQ(readAll(reader).size(), 10u);
+}
+
+/** Records are moved out, so the fetch function must overwrite them. */
+TEST(ReadAheadTest, MoveRecords)
+{
+    int next = 0;
+    ReadAhead<std::string> reader([&next](std::string &record) {
+        if (next == 100)
+            return false;
+        record = std::to_string(next++);
+        return true;
+    }, 4, 2);
+
+    std::string record;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(reader.read(record));
+        ASSERT_EQ(record, std::to_string(i));
+    }
+    ASSERT_FALSE(reader.read(record));
+}
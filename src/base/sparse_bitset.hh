@@ -0,0 +1,352 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_SPARSE_BITSET_HH__
+#define __BASE_SPARSE_BITSET_HH__
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+
+namespace gem5
+{
+
+/**
+ * Set of integers, e.g., cache line or page numbers, stored as a
+ * two-level sparse set.
+ *
+ * The keys are split in chunks of ChunkSize consecutive keys, and only
+ * the chunks holding at least one key are allocated. A chunk holding
+ * few keys stores them as a sorted array of 16-bit offsets, and is
+ * turned into a plain bitmap once it holds more than ArrayMax keys,
+ * where the bitmap becomes the smaller of the two. The chunks are
+ * found through a hash map, and the last chunk accessed is cached as
+ * accesses are usually clustered. A densely populated set therefore
+ * costs little more than a bit per key, and a scattered one a few
+ * bytes per key plus the hash map node of its chunk.
+ *
+ * Inserting and erasing a key take time linear in ArrayMax at worst,
+ * looking up a key logarithmic time, the size of the set is maintained
+ * as keys are inserted and erased, and the keys in a range are counted
+ * with a population count of the bitmaps.
+ */
+class SparseBitSet
+{
+  public:
+    /** Number of keys per chunk, log2. */
+    static constexpr unsigned ChunkBits = 12;
+    static constexpr uint64_t ChunkSize = 1ULL << ChunkBits;
+
+    /**
+     * Maximum number of keys of an array chunk, past which its bitmap
+     * is smaller than its array.
+     */
+    static constexpr unsigned ArrayMax = ChunkSize / 16;
+
+  private:
+    static constexpr unsigned WordsPerChunk = ChunkSize / 64;
+
+    typedef std::array<uint64_t, WordsPerChunk> Bitmap;
+
+    struct Chunk
+    {
+        /** Sorted offsets of the keys, unless the chunk is a bitmap. */
+        std::vector<uint16_t> array;
+        /** Bitmap of the keys, allocated once the array grows too big. */
+        std::unique_ptr<Bitmap> bitmap;
+        unsigned count = 0;
+    };
+
+    std::unordered_map<uint64_t, Chunk> chunks;
+
+    /** Number of keys in the set. */
+    uint64_t _size = 0;
+
+    /** Last chunk accessed, chunks don't move once allocated. */
+    mutable uint64_t lastIndex = 0;
+    mutable Chunk *lastChunk = nullptr;
+
+    Chunk *
+    findChunk(uint64_t index) const
+    {
+        if (lastChunk && lastIndex == index)
+            return lastChunk;
+
+        auto it = chunks.find(index);
+        if (it == chunks.end())
+            return nullptr;
+
+        lastIndex = index;
+        lastChunk = const_cast<Chunk *>(&it->second);
+        return lastChunk;
+    }
+
+    static uint16_t
+    offset(uint64_t key)
+    {
+        return key % ChunkSize;
+    }
+
+    static uint64_t
+    bit(uint64_t key)
+    {
+        return 1ULL << (key % 64);
+    }
+
+    static uint64_t &
+    word(Bitmap &bitmap, uint64_t key)
+    {
+        return bitmap[offset(key) / 64];
+    }
+
+    /** Replace the array of a chunk by a bitmap. */
+    static void
+    toBitmap(Chunk &chunk)
+    {
+        chunk.bitmap.reset(new Bitmap());
+        for (uint16_t off : chunk.array)
+            (*chunk.bitmap)[off / 64] |= bit(off);
+        std::vector<uint16_t>().swap(chunk.array);
+    }
+
+    /** Replace the bitmap of a chunk by an array. */
+    static void
+    toArray(Chunk &chunk)
+    {
+        chunk.array.reserve(chunk.count);
+        for (unsigned i = 0; i < WordsPerChunk; ++i) {
+            for (uint64_t w = (*chunk.bitmap)[i]; w; w &= w - 1)
+                chunk.array.push_back(i * 64 + findLsbSet(w));
+        }
+        chunk.bitmap.reset();
+    }
+
+  public:
+    SparseBitSet() = default;
+
+    /**
+     * The chunks of a moved hash map keep their addresses, so the
+     * cached chunk stays valid for the target, but not for the source.
+     */
+    SparseBitSet(SparseBitSet &&other)
+        : chunks(std::move(other.chunks)), _size(other._size),
+          lastIndex(other.lastIndex), lastChunk(other.lastChunk)
+    {
+        other.chunks.clear();
+        other._size = 0;
+        other.lastChunk = nullptr;
+    }
+
+    SparseBitSet &
+    operator=(SparseBitSet &&other)
+    {
+        if (this != &other) {
+            chunks = std::move(other.chunks);
+            _size = other._size;
+            lastIndex = other.lastIndex;
+            lastChunk = other.lastChunk;
+            other.chunks.clear();
+            other._size = 0;
+            other.lastChunk = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * Insert a key.
+     *
+     * @param key The key to insert.
+     * @return True if the key was not already in the set.
+     */
+    bool
+    insert(uint64_t key)
+    {
+        const uint64_t index = key >> ChunkBits;
+        Chunk *chunk = findChunk(index);
+        if (!chunk) {
+            lastIndex = index;
+            lastChunk = chunk = &chunks[index];
+        }
+
+        if (chunk->bitmap) {
+            uint64_t &w = word(*chunk->bitmap, key);
+            if (w & bit(key))
+                return false;
+            w |= bit(key);
+        } else {
+            auto &array = chunk->array;
+            auto it = std::lower_bound(array.begin(), array.end(),
+                                       offset(key));
+            if (it != array.end() && *it == offset(key))
+                return false;
+            array.insert(it, offset(key));
+            if (array.size() > ArrayMax)
+                toBitmap(*chunk);
+        }
+
+        ++chunk->count;
+        ++_size;
+        return true;
+    }
+
+    /**
+     * Erase a key, releasing its chunk if it becomes empty. A bitmap
+     * chunk goes back to an array once half of ArrayMax keys are left,
+     * so that alternating inserts and erases don't convert it back and
+     * forth.
+     *
+     * @param key The key to erase.
+     * @return True if the key was in the set.
+     */
+    bool
+    erase(uint64_t key)
+    {
+        const uint64_t index = key >> ChunkBits;
+        Chunk *chunk = findChunk(index);
+        if (!chunk)
+            return false;
+
+        if (chunk->bitmap) {
+            uint64_t &w = word(*chunk->bitmap, key);
+            if (!(w & bit(key)))
+                return false;
+            w &= ~bit(key);
+        } else {
+            auto &array = chunk->array;
+            auto it = std::lower_bound(array.begin(), array.end(),
+                                       offset(key));
+            if (it == array.end() || *it != offset(key))
+                return false;
+            array.erase(it);
+        }
+
+        --_size;
+        if (--chunk->count == 0) {
+            lastChunk = nullptr;
+            chunks.erase(index);
+        } else if (chunk->bitmap && chunk->count <= ArrayMax / 2) {
+            toArray(*chunk);
+        }
+        return true;
+    }
+
+    /** Check if a key is in the set. */
+    bool
+    contains(uint64_t key) const
+    {
+        Chunk *chunk = findChunk(key >> ChunkBits);
+        if (!chunk)
+            return false;
+        if (chunk->bitmap)
+            return word(*chunk->bitmap, key) & bit(key);
+        return std::binary_search(chunk->array.begin(), chunk->array.end(),
+                                  offset(key));
+    }
+
+    /** Number of keys in the set. */
+    uint64_t size() const { return _size; }
+
+    bool empty() const { return _size == 0; }
+
+    /**
+     * Count the keys in a range.
+     *
+     * @param start First key of the range.
+     * @param end Key past the end of the range.
+     * @return Number of keys of the set in [start, end).
+     */
+    uint64_t
+    count(uint64_t start, uint64_t end) const
+    {
+        uint64_t count = 0;
+        for (const auto &[index, chunk] : chunks) {
+            const uint64_t base = index << ChunkBits;
+            if (base >= end || base + ChunkSize <= start)
+                continue;
+
+            if (base >= start && base + ChunkSize <= end) {
+                count += chunk.count;
+                continue;
+            }
+
+            // Offsets of the range in the chunk, clamped to the chunk
+            const uint64_t first = std::max(start, base) - base;
+            const uint64_t last = std::min(end, base + ChunkSize) - base;
+
+            if (!chunk.bitmap) {
+                count += std::lower_bound(chunk.array.begin(),
+                        chunk.array.end(), last) -
+                    std::lower_bound(chunk.array.begin(),
+                        chunk.array.end(), first);
+                continue;
+            }
+
+            for (unsigned i = first / 64; i < divCeil(last, 64); ++i) {
+                uint64_t w = (*chunk.bitmap)[i];
+                if (first > i * 64)
+                    w &= ~mask(first - i * 64);
+                if (last < (i + 1) * 64)
+                    w &= mask(last - i * 64);
+                count += popCount(w);
+            }
+        }
+        return count;
+    }
+
+    /** Remove all the keys from the set. */
+    void
+    clear()
+    {
+        chunks.clear();
+        lastChunk = nullptr;
+        _size = 0;
+    }
+
+    /** Approximate number of bytes used by the set. */
+    size_t
+    memoryUsage() const
+    {
+        // Each chunk also costs a hash map node and a bucket
+        size_t usage = chunks.size() * (sizeof(Chunk) + 4 * sizeof(void *)) +
+            chunks.bucket_count() * sizeof(void *);
+        for (const auto &[index, chunk] : chunks) {
+            usage += chunk.bitmap ? sizeof(Bitmap) :
+                chunk.array.capacity() * sizeof(uint16_t);
+        }
+        return usage;
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_SPARSE_BITSET_HH__
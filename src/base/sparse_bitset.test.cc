@@ -0,0 +1,200 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <unordered_set>
+#include <utility>
+
+#include "base/sparse_bitset.hh"
+
+using namespace gem5;
+
+/** The set behaves like a std::unordered_set of its keys. */
+TEST(SparseBitSetTest, MatchesUnorderedSet)
+{
+    SparseBitSet set;
+    std::unordered_set<uint64_t> reference;
+    std::mt19937_64 rng(0x5eed);
+
+    for (int i = 0; i < 200000; ++i) {
+        // Clustered keys, spread over a large key space
+        const uint64_t key = (rng() % 64) * 1000003 + rng() % 20000;
+        if (rng() % 4 == 0) {
+            ASSERT_EQ(set.erase(key), reference.erase(key) == 1);
+        } else {
+            ASSERT_EQ(set.insert(key), reference.insert(key).second);
+        }
+        ASSERT_EQ(set.size(), reference.size());
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        const uint64_t key = (rng() % 64) * 1000003 + rng() % 20000;
+        ASSERT_EQ(set.contains(key), reference.count(key) == 1);
+    }
+}
+
+/**
+ * Counting the keys in a range, across chunk and word boundaries, in
+ * bitmap chunks and in array chunks.
+ */
+TEST(SparseBitSetTest, Count)
+{
+    for (uint64_t step : { 3, 37 }) {
+        SparseBitSet set;
+        for (uint64_t key = 100; key < 3 * SparseBitSet::ChunkSize;
+             key += step) {
+            set.insert(key);
+        }
+
+        auto expected = [step](uint64_t start, uint64_t end) {
+            uint64_t count = 0;
+            for (uint64_t key = start; key < end; ++key)
+                count += key >= 100 && key < 3 * SparseBitSet::ChunkSize &&
+                    (key - 100) % step == 0;
+            return count;
+        };
+
+        for (auto [start, end] : {
+                std::make_pair(0ULL, 1ULL << 20),
+                std::make_pair(101ULL, 164ULL),
+                std::make_pair(64ULL, 128ULL),
+                std::make_pair(100ULL, 137ULL),
+                std::make_pair(4000ULL, 4200ULL),
+                std::make_pair(4096ULL, 8192ULL),
+                std::make_pair(5000ULL, 5000ULL) }) {
+            ASSERT_EQ(set.count(start, end), expected(start, end))
+                << step << ": " << start << "-" << end;
+        }
+        ASSERT_EQ(set.count(0, ~0ULL), set.size());
+    }
+}
+
+/**
+ * A chunk turns into a bitmap past ArrayMax keys and back into an
+ * array once half of them are erased, keeping its keys.
+ */
+TEST(SparseBitSetTest, ChunkConversion)
+{
+    SparseBitSet set;
+    const uint64_t base = 7 * SparseBitSet::ChunkSize;
+    const uint64_t keys = SparseBitSet::ArrayMax + 1;
+
+    for (uint64_t i = 0; i < keys; ++i)
+        ASSERT_TRUE(set.insert(base + (i * 13) % SparseBitSet::ChunkSize));
+    const size_t bitmap_usage = set.memoryUsage();
+
+    for (uint64_t i = 0; i < keys; i += 2)
+        ASSERT_TRUE(set.erase(base + (i * 13) % SparseBitSet::ChunkSize));
+    ASSERT_LT(set.memoryUsage(), bitmap_usage);
+
+    for (uint64_t i = 0; i < keys; ++i) {
+        ASSERT_EQ(set.contains(base + (i * 13) % SparseBitSet::ChunkSize),
+                  i % 2 == 1) << i;
+    }
+    ASSERT_EQ(set.size(), keys / 2);
+    ASSERT_EQ(set.count(base, base + SparseBitSet::ChunkSize), keys / 2);
+}
+
+/** Erasing the last key of a chunk releases it. */
+TEST(SparseBitSetTest, Clear)
+{
+    SparseBitSet set;
+    ASSERT_TRUE(set.empty());
+    ASSERT_TRUE(set.insert(1ULL << 40));
+    ASSERT_FALSE(set.insert(1ULL << 40));
+    ASSERT_TRUE(set.insert(5));
+    ASSERT_EQ(set.size(), 2u);
+
+    const size_t usage = set.memoryUsage();
+    ASSERT_TRUE(set.erase(1ULL << 40));
+    ASSERT_LT(set.memoryUsage(), usage);
+    ASSERT_FALSE(set.contains(1ULL << 40));
+    ASSERT_TRUE(set.contains(5));
+
+    set.clear();
+    ASSERT_TRUE(set.empty());
+    ASSERT_FALSE(set.contains(5));
+    ASSERT_TRUE(set.insert(5));
+}
+
+/**
+ * A moved set takes the keys, and the source doesn't see the chunk it
+ * accessed last anymore.
+ */
+TEST(SparseBitSetTest, Move)
+{
+    SparseBitSet set;
+    ASSERT_TRUE(set.insert(5));
+    ASSERT_TRUE(set.contains(5));
+
+    SparseBitSet moved(std::move(set));
+    ASSERT_TRUE(moved.contains(5));
+    ASSERT_EQ(moved.size(), 1u);
+    ASSERT_TRUE(set.empty());
+    ASSERT_FALSE(set.contains(5));
+    ASSERT_EQ(set.count(0, SparseBitSet::ChunkSize), 0u);
+    ASSERT_TRUE(set.insert(6));
+    ASSERT_FALSE(moved.contains(6));
+
+    SparseBitSet assigned;
+    ASSERT_TRUE(assigned.insert(7));
+    assigned = std::move(moved);
+    ASSERT_TRUE(assigned.contains(5));
+    ASSERT_FALSE(assigned.contains(7));
+    ASSERT_EQ(assigned.size(), 1u);
+    ASSERT_TRUE(moved.empty());
+    ASSERT_FALSE(moved.contains(5));
+    ASSERT_TRUE(moved.insert(5));
+    ASSERT_TRUE(assigned.erase(5));
+    ASSERT_TRUE(moved.contains(5));
+}
+
+/** A dense set uses a fraction of a byte per key. */
+TEST(SparseBitSetTest, MemoryUsage)
+{
+    SparseBitSet set;
+    const uint64_t keys = 1 << 22;
+    for (uint64_t key = 0; key < keys; ++key)
+        set.insert(key);
+    ASSERT_EQ(set.size(), keys);
+    ASSERT_LT(set.memoryUsage(), keys / 4);
+}
+
+/** A scattered set uses a fraction of the size of a bitmap per key. */
+TEST(SparseBitSetTest, SparseMemoryUsage)
+{
+    SparseBitSet set;
+    const uint64_t keys = 1 << 16;
+    std::mt19937_64 rng(0x5eed);
+    for (uint64_t i = 0; i < keys; ++i) {
+        // One key in most chunks, a few keys in some
+        set.insert((rng() % (keys * 4)) * SparseBitSet::ChunkSize +
+                   rng() % SparseBitSet::ChunkSize);
+    }
+    ASSERT_LT(set.memoryUsage(),
+              set.size() * SparseBitSet::ChunkSize / 8 / 4);
+}
@@ -0,0 +1,393 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/columnar.hh"
+
+#include <cstring>
+#include <ostream>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/stats/info.hh"
+#include "base/stats/units.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+namespace
+{
+
+const char Magic[8] = { 'g', 'e', 'm', '5', 'c', 'o', 'l', 's' };
+const uint32_t ByteOrderMark = 0x01020304;
+
+/** Name of an element of a stat, or its index if it has no name. */
+std::string
+subname(const std::vector<std::string> &subnames, size_t i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    return std::to_string(i);
+}
+
+/** Compare doubles bitwise, so that NaNs can be considered unchanged. */
+bool
+sameValue(double a, double b)
+{
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+} // anonymous namespace
+
+ColumnarWriter::ColumnarWriter(std::ostream &_os)
+    : os(_os)
+{
+    write(Magic, sizeof(Magic));
+    write(Version);
+    write(ByteOrderMark);
+}
+
+void
+ColumnarWriter::writeSchema(const std::vector<Stat> &stats)
+{
+    write("S", 1);
+    write(uint32_t(stats.size()));
+    for (const auto &stat : stats) {
+        write(stat.name);
+        write(stat.desc);
+        write(stat.unit);
+        write(uint32_t(stat.suffixes.size()));
+        for (const auto &suffix : stat.suffixes)
+            write(suffix);
+    }
+}
+
+void
+ColumnarWriter::writeRow(const double *values, size_t count)
+{
+    write("R", 1);
+    write(uint32_t(count));
+    write(values, count * sizeof(double));
+}
+
+void
+ColumnarWriter::writeDelta(const double *values,
+                           const std::vector<uint32_t> &changed)
+{
+    write("D", 1);
+    write(uint32_t(changed.size()));
+    for (uint32_t i : changed) {
+        write(i);
+        write(values[i]);
+    }
+}
+
+void
+ColumnarWriter::flush()
+{
+    os.flush();
+}
+
+void
+ColumnarWriter::write(const void *data, size_t size)
+{
+    os.write(static_cast<const char *>(data), size);
+}
+
+void
+ColumnarWriter::write(const std::string &str)
+{
+    write(uint32_t(str.size()));
+    write(str.data(), str.size());
+}
+
+Columnar::Columnar(const std::string &file, bool desc, bool formulas,
+                   bool delta)
+    : fname(file), enableDescriptions(desc), enableFormula(formulas),
+      enableDelta(delta), stream(nullptr), numColumns(0), nextStat(0),
+      schemaChanged(false)
+{
+}
+
+Columnar::~Columnar()
+{
+    writer.reset();
+    if (stream)
+        simout.close(stream);
+}
+
+void
+Columnar::begin()
+{
+    if (!stream) {
+        stream = simout.create(fname, true);
+        writer.reset(new ColumnarWriter(*stream->stream()));
+    }
+
+    row.clear();
+    nextStat = 0;
+    schemaChanged = false;
+}
+
+void
+Columnar::end()
+{
+    assert(path.empty());
+
+    // Stats that are no longer visited at the end of the dump.
+    if (nextStat != statInfo.size()) {
+        statInfo.resize(nextStat);
+        schema.resize(nextStat);
+        schemaChanged = true;
+    }
+
+    if (schemaChanged) {
+        numColumns = row.size();
+        writer->writeSchema(schema);
+        lastRow.clear();
+    }
+
+    writeRow();
+    std::swap(row, lastRow);
+    writer->flush();
+}
+
+bool
+Columnar::valid() const
+{
+    return true;
+}
+
+void
+Columnar::beginGroup(const char *name)
+{
+    if (path.empty())
+        path.push_back(name);
+    else
+        path.push_back(csprintf("%s.%s", path.back(), name));
+}
+
+void
+Columnar::endGroup()
+{
+    assert(!path.empty());
+    path.pop_back();
+}
+
+template <class Suffixes>
+void
+Columnar::addStat(const Info &info, size_t first, Suffixes &&suffixes)
+{
+    const size_t count = row.size() - first;
+    if (!schemaChanged && nextStat < statInfo.size()) {
+        if (statInfo[nextStat] == &info &&
+            schema[nextStat].suffixes.size() == count) {
+            ++nextStat;
+            return;
+        }
+    }
+
+    // The stats from here on don't match the previous schema, so
+    // rebuild it from this stat on.
+    schemaChanged = true;
+    statInfo.resize(nextStat);
+    schema.resize(nextStat);
+    statInfo.push_back(&info);
+    schema.push_back({ path.empty() ? info.name :
+                           csprintf("%s.%s", path.back(), info.name),
+                       enableDescriptions ? info.desc : std::string(),
+                       info.unit->getUnitString(), {} });
+    suffixes(schema.back().suffixes);
+    assert(schema.back().suffixes.size() == count);
+    ++nextStat;
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t first = row.size();
+    row.push_back(info.result());
+    addStat(info, first, [](std::vector<std::string> &suffixes) {
+        suffixes.emplace_back();
+    });
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t first = row.size();
+    const VResult &result = info.result();
+    row.insert(row.end(), result.begin(), result.end());
+    addStat(info, first, [&](std::vector<std::string> &suffixes) {
+        // Like the text output, name single-element vectors (e.g.,
+        // most formulas) after the stat.
+        if (result.size() == 1 &&
+            (info.subnames.empty() || info.subnames[0].empty())) {
+            suffixes.emplace_back();
+            return;
+        }
+        for (size_t i = 0; i < result.size(); ++i)
+            suffixes.push_back(subname(info.subnames, i));
+    });
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t first = row.size();
+    appendDist(info.data);
+    addStat(info, first, [&](std::vector<std::string> &suffixes) {
+        distSuffixes(info.data, "", suffixes);
+    });
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t first = row.size();
+    for (const auto &data : info.data)
+        appendDist(data);
+    addStat(info, first, [&](std::vector<std::string> &suffixes) {
+        for (size_t i = 0; i < info.data.size(); ++i) {
+            distSuffixes(info.data[i], subname(info.subnames, i) + "::",
+                         suffixes);
+        }
+    });
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t first = row.size();
+    row.insert(row.end(), info.cvec.begin(), info.cvec.end());
+    addStat(info, first, [&](std::vector<std::string> &suffixes) {
+        for (size_t x = 0; x < info.x; ++x) {
+            for (size_t y = 0; y < info.y; ++y) {
+                suffixes.push_back(subname(info.subnames, x) + "::" +
+                                   subname(info.y_subnames, y));
+            }
+        }
+    });
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    if (enableFormula)
+        visit((const VectorInfo &)info);
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    warn_once("Columnar stat files don't support sparse histograms.\n");
+}
+
+void
+Columnar::appendDist(const DistData &data)
+{
+    row.push_back(data.samples);
+    row.push_back(data.sum);
+    row.push_back(data.squares);
+    if (data.type == Deviation)
+        return;
+
+    row.push_back(data.min_val);
+    row.push_back(data.max_val);
+    row.push_back(data.underflow);
+    row.push_back(data.overflow);
+    row.push_back(data.min);
+    row.push_back(data.bucket_size);
+    row.insert(row.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Columnar::distSuffixes(const DistData &data, const std::string &prefix,
+                       std::vector<std::string> &suffixes)
+{
+    for (const char *name : { "samples", "sum", "squares" })
+        suffixes.push_back(prefix + name);
+    if (data.type == Deviation)
+        return;
+
+    for (const char *name : { "min_value", "max_value", "underflows",
+                              "overflows", "min", "bucket_size" }) {
+        suffixes.push_back(prefix + name);
+    }
+    for (size_t i = 0; i < data.cvec.size(); ++i)
+        suffixes.push_back(prefix + "bucket" + std::to_string(i));
+}
+
+void
+Columnar::writeRow()
+{
+    assert(row.size() == numColumns);
+
+    if (enableDelta && lastRow.size() == numColumns) {
+        changed.clear();
+        for (uint32_t i = 0; i < numColumns; ++i) {
+            if (!sameValue(row[i], lastRow[i]))
+                changed.push_back(i);
+        }
+
+        const size_t delta_size = changed.size() *
+            (sizeof(uint32_t) + sizeof(double));
+        if (delta_size < numColumns * sizeof(double)) {
+            writer->writeDelta(row.data(), changed);
+            return;
+        }
+    }
+
+    writer->writeRow(row.data(), numColumns);
+}
+
+std::unique_ptr<Output>
+initColumnar(const std::string &filename, bool desc, bool formulas,
+             bool delta)
+{
+    return std::unique_ptr<Output>(
+        new Columnar(filename, desc, formulas, delta));
+}
+
+} // namespace statistics
+} // namespace gem5
@@ -0,0 +1,203 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/output.hh"
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+/**
+ * Writer of binary, columnar stat files.
+ *
+ * Instead of printing every stat name with its value on each dump, the
+ * names are written once in a schema record and every row then holds
+ * the values of all the columns of the schema, in schema order. Each
+ * stat expands to a fixed set of columns (e.g., one per vector
+ * element).
+ *
+ * The file uses the host byte order, which the reader infers from the
+ * header, and is made of the following records:
+ *
+ * - Header: the magic "gem5cols", the uint32 format version and the
+ *   uint32 0x01020304.
+ * - Schema ('S'): the uint32 number of stats, followed by the name,
+ *   description, unit, uint32 number of columns and column suffixes of
+ *   each stat. Strings are stored as their uint32 length followed by
+ *   their characters.
+ * - Full row ('R'): the uint32 number of columns followed by the double
+ *   value of each column.
+ * - Delta row ('D'): the uint32 number of changed columns followed by
+ *   the uint32 index and double value of each changed column.
+ *
+ * The m5.ext.pystats.columnar module reads these files.
+ */
+class ColumnarWriter
+{
+  public:
+    static constexpr uint32_t Version = 1;
+
+    /** Schema entry of a stat. */
+    struct Stat
+    {
+        std::string name;
+        std::string desc;
+        std::string unit;
+        std::vector<std::string> suffixes;
+    };
+
+    /** Start a columnar file, writing its header to a stream. */
+    explicit ColumnarWriter(std::ostream &os);
+
+    void writeSchema(const std::vector<Stat> &stats);
+
+    /** Write a full row of values. */
+    void writeRow(const double *values, size_t count);
+
+    /** Write a delta row holding the changed columns of a row. */
+    void writeDelta(const double *values,
+                    const std::vector<uint32_t> &changed);
+
+    void flush();
+
+  private:
+    void write(const void *data, size_t size);
+    void write(uint32_t value) { write(&value, sizeof(value)); }
+    void write(double value) { write(&value, sizeof(value)); }
+    void write(const std::string &str);
+
+    std::ostream &os;
+};
+
+/**
+ * Stats output appending a row to a columnar file on each dump, see
+ * ColumnarWriter. A new schema record is only written if the set of
+ * stats or their shape changes between dumps. When delta rows are
+ * enabled, a dump only stores the columns that changed since the
+ * previous row if that takes less space than a full row.
+ */
+class Columnar : public Output
+{
+  public:
+    Columnar(const std::string &file, bool desc, bool formulas, bool delta);
+
+    ~Columnar();
+
+    Columnar() = delete;
+    Columnar(const Columnar &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /**
+     * Account for the values a stat appended to the current row,
+     * starting at index first, and update the schema if the stat
+     * doesn't match the one at this position in the previous dump.
+     *
+     * @param suffixes Function returning the column suffixes of the
+     *                 stat, only called when the schema changes.
+     */
+    template <class Suffixes>
+    void addStat(const Info &info, size_t first, Suffixes &&suffixes);
+
+    /** Append the values of a distribution to the current row. */
+    void appendDist(const DistData &data);
+
+    /** Column suffixes of a distribution, prefixed by prefix. */
+    static void distSuffixes(const DistData &data, const std::string &prefix,
+                             std::vector<std::string> &suffixes);
+
+    void writeRow();
+
+  protected:
+    const std::string fname;
+    const bool enableDescriptions;
+    const bool enableFormula;
+    const bool enableDelta;
+
+    OutputStream *stream;
+    std::unique_ptr<ColumnarWriter> writer;
+
+    /** Group path of the stats being visited. */
+    std::vector<std::string> path;
+
+    /** Stats of the current schema, in dump order. */
+    std::vector<const Info *> statInfo;
+    std::vector<ColumnarWriter::Stat> schema;
+
+    /** Number of columns of the current schema. */
+    size_t numColumns;
+
+    /** Index in stats of the next stat to be visited. */
+    size_t nextStat;
+
+    /** Whether the schema changed in the current dump. */
+    bool schemaChanged;
+
+    /** Values of the current and the previous dump. */
+    std::vector<double> row;
+    std::vector<double> lastRow;
+
+    /** Scratch list of the changed columns of a delta row. */
+    std::vector<uint32_t> changed;
+};
+
+std::unique_ptr<Output> initColumnar(const std::string &filename,
+                                     bool desc = true, bool formulas = true,
+                                     bool delta = true);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_COLUMNAR_HH__
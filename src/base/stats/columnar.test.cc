@@ -0,0 +1,494 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/stats/columnar.hh"
+#include "base/stats/info.hh"
+#include "base/stats/units.hh"
+
+using namespace gem5;
+using namespace gem5::statistics;
+
+namespace
+{
+
+/** Stat whose values are set by the test. */
+template <class Base>
+class FakeInfo : public Base
+{
+  public:
+    FakeInfo(const std::string &name, const std::string &desc="")
+    {
+        this->name = name;
+        this->desc = desc;
+        this->unit = units::Count::get();
+        this->flags.set(display);
+    }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return false; }
+    void visit(Output &visitor) override {}
+};
+
+class FakeScalar : public FakeInfo<ScalarInfo>
+{
+  public:
+    using FakeInfo::FakeInfo;
+
+    double val = 0;
+
+    statistics::Counter value() const override { return val; }
+    Result result() const override { return val; }
+    Result total() const override { return val; }
+};
+
+class FakeVector : public FakeInfo<VectorInfo>
+{
+  public:
+    using FakeInfo::FakeInfo;
+
+    VCounter counters;
+    mutable VResult results;
+
+    size_type size() const override { return counters.size(); }
+    const VCounter &value() const override { return counters; }
+
+    const VResult &
+    result() const override
+    {
+        results.assign(counters.begin(), counters.end());
+        return results;
+    }
+
+    Result total() const override { return 0; }
+};
+
+/** Schema entry of a stat, as read back from the file. */
+struct Stat
+{
+    std::string name;
+    std::string desc;
+    std::string unit;
+    std::vector<std::string> suffixes;
+};
+
+/** Reads back the records of a columnar file. */
+class Reader
+{
+  private:
+    std::string data;
+    size_t pos = 0;
+
+  public:
+    explicit Reader(const std::string &_data) : data(_data) {}
+
+    bool atEnd() const { return pos == data.size(); }
+
+    /** Type of the next record. */
+    char peek() const { return pos < data.size() ? data[pos] : '\0'; }
+
+    template <class T>
+    T
+    read()
+    {
+        T value;
+        EXPECT_LE(pos + sizeof(T), data.size());
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string
+    readString()
+    {
+        const uint32_t size = read<uint32_t>();
+        std::string str = data.substr(pos, size);
+        pos += size;
+        return str;
+    }
+
+    void
+    readHeader()
+    {
+        EXPECT_EQ(data.substr(pos, 8), "gem5cols");
+        pos += 8;
+        EXPECT_EQ(read<uint32_t>(), ColumnarWriter::Version);
+        EXPECT_EQ(read<uint32_t>(), 0x01020304U);
+    }
+
+    std::vector<Stat>
+    readSchema()
+    {
+        EXPECT_EQ(read<char>(), 'S');
+        std::vector<Stat> stats(read<uint32_t>());
+        for (auto &stat : stats) {
+            stat.name = readString();
+            stat.desc = readString();
+            stat.unit = readString();
+            stat.suffixes.resize(read<uint32_t>());
+            for (auto &suffix : stat.suffixes)
+                suffix = readString();
+        }
+        return stats;
+    }
+
+    std::vector<double>
+    readRow()
+    {
+        EXPECT_EQ(read<char>(), 'R');
+        std::vector<double> values(read<uint32_t>());
+        for (auto &value : values)
+            value = read<double>();
+        return values;
+    }
+
+    /**
+     * Read a delta row, applying it to the previous values.
+     *
+     * @return The number of changed columns.
+     */
+    uint32_t
+    readDelta(std::vector<double> &values)
+    {
+        EXPECT_EQ(read<char>(), 'D');
+        const uint32_t changed = read<uint32_t>();
+        for (uint32_t i = 0; i < changed; ++i) {
+            const uint32_t column = read<uint32_t>();
+            EXPECT_LT(column, values.size());
+            const double value = read<double>();
+            if (column < values.size())
+                values[column] = value;
+        }
+        return changed;
+    }
+};
+
+class ColumnarTest : public testing::Test
+{
+  protected:
+    std::string dir;
+    std::string file;
+
+    void
+    SetUp() override
+    {
+        char name[] = "columnar-XXXXXX";
+        ASSERT_NE(mkdtemp(name), nullptr);
+        dir = name;
+        // An absolute path, so that the output directory of the
+        // simulation isn't needed.
+        char cwd[4096];
+        ASSERT_NE(getcwd(cwd, sizeof(cwd)), nullptr);
+        file = std::string(cwd) + "/" + dir + "/stats.cols";
+    }
+
+    void
+    TearDown() override
+    {
+        std::remove(file.c_str());
+        rmdir(dir.c_str());
+    }
+
+    std::string
+    contents() const
+    {
+        std::ifstream is(file, std::ios::binary);
+        std::ostringstream os;
+        os << is.rdbuf();
+        return os.str();
+    }
+};
+
+} // anonymous namespace
+
+/** The schema is only written by the first of identical dumps. */
+TEST_F(ColumnarTest, SchemaWrittenOnce)
+{
+    FakeScalar insts("numInsts", "Number of instructions");
+    FakeVector bytes("bytes");
+    bytes.subnames = { "cpu", "dma" };
+    bytes.counters = { 64, 0 };
+
+    Columnar cols(file, true, true, false);
+    for (int dump = 0; dump < 3; ++dump) {
+        insts.val = 10 * dump;
+        cols.begin();
+        cols.beginGroup("system");
+        cols.visit(insts);
+        cols.beginGroup("mem");
+        cols.visit(bytes);
+        cols.endGroup();
+        cols.endGroup();
+        cols.end();
+    }
+
+    Reader reader(contents());
+    reader.readHeader();
+    const auto schema = reader.readSchema();
+    ASSERT_EQ(schema.size(), 2);
+    EXPECT_EQ(schema[0].name, "system.numInsts");
+    EXPECT_EQ(schema[0].desc, "Number of instructions");
+    EXPECT_EQ(schema[0].unit, "Count");
+    EXPECT_EQ(schema[0].suffixes, std::vector<std::string>{ "" });
+    EXPECT_EQ(schema[1].name, "system.mem.bytes");
+    EXPECT_EQ(schema[1].suffixes,
+              (std::vector<std::string>{ "cpu", "dma" }));
+
+    for (int dump = 0; dump < 3; ++dump) {
+        EXPECT_EQ(reader.readRow(),
+                  (std::vector<double>{ 10.0 * dump, 64, 0 }));
+    }
+    EXPECT_TRUE(reader.atEnd());
+}
+
+/** Descriptions are left empty when they are disabled. */
+TEST_F(ColumnarTest, NoDescriptions)
+{
+    FakeScalar insts("numInsts", "Number of instructions");
+
+    Columnar cols(file, false, true, false);
+    cols.begin();
+    cols.visit(insts);
+    cols.end();
+
+    Reader reader(contents());
+    reader.readHeader();
+    const auto schema = reader.readSchema();
+    ASSERT_EQ(schema.size(), 1);
+    EXPECT_EQ(schema[0].name, "numInsts");
+    EXPECT_EQ(schema[0].desc, "");
+}
+
+/**
+ * A stat changing shape, a different stat at the same position or a
+ * stat no longer being visited rebuild the schema, and the row
+ * following a new schema is always a full one.
+ */
+TEST_F(ColumnarTest, SchemaRebuilt)
+{
+    FakeScalar a("a"), b("b"), c("c");
+    FakeVector vec("vec");
+    vec.counters = { 1, 2 };
+
+    Columnar cols(file, true, true, true);
+    auto dump = [&](std::vector<Info *> stats) {
+        cols.begin();
+        for (auto *info : stats) {
+            if (auto *scalar = dynamic_cast<ScalarInfo *>(info))
+                cols.visit(*scalar);
+            else
+                cols.visit(*dynamic_cast<VectorInfo *>(info));
+        }
+        cols.end();
+    };
+
+    dump({ &a, &vec, &b });
+    // Same stats, same shape: no schema.
+    dump({ &a, &vec, &b });
+    vec.counters = { 1, 2, 3 };
+    dump({ &a, &vec, &b });
+    dump({ &a, &c, &b });
+    dump({ &a, &c });
+
+    Reader reader(contents());
+    reader.readHeader();
+
+    auto schema = reader.readSchema();
+    ASSERT_EQ(schema.size(), 3);
+    EXPECT_EQ(schema[1].suffixes, (std::vector<std::string>{ "0", "1" }));
+    std::vector<double> values = reader.readRow();
+    EXPECT_EQ(values, (std::vector<double>{ 0, 1, 2, 0 }));
+    EXPECT_EQ(reader.readDelta(values), 0);
+
+    schema = reader.readSchema();
+    ASSERT_EQ(schema.size(), 3);
+    EXPECT_EQ(schema[1].name, "vec");
+    EXPECT_EQ(schema[1].suffixes,
+              (std::vector<std::string>{ "0", "1", "2" }));
+    EXPECT_EQ(reader.readRow(), (std::vector<double>{ 0, 1, 2, 3, 0 }));
+
+    schema = reader.readSchema();
+    ASSERT_EQ(schema.size(), 3);
+    EXPECT_EQ(schema[0].name, "a");
+    EXPECT_EQ(schema[1].name, "c");
+    EXPECT_EQ(schema[2].name, "b");
+    EXPECT_EQ(reader.readRow(), (std::vector<double>{ 0, 0, 0 }));
+
+    schema = reader.readSchema();
+    ASSERT_EQ(schema.size(), 2);
+    EXPECT_EQ(schema[0].name, "a");
+    EXPECT_EQ(schema[1].name, "c");
+    EXPECT_EQ(reader.readRow(), (std::vector<double>{ 0, 0 }));
+
+    EXPECT_TRUE(reader.atEnd());
+}
+
+/**
+ * With delta rows enabled, a dump is written as a delta row as long as
+ * it's smaller than a full row. A changed column takes 12 bytes in a
+ * delta row and an unchanged one 8 bytes in a full row, so with 3
+ * columns only dumps changing a single column are deltas.
+ */
+TEST_F(ColumnarTest, DeltaOrFullRow)
+{
+    FakeVector vec("vec");
+    vec.counters = { 1, 2, 3 };
+
+    Columnar cols(file, true, true, true);
+    auto dump = [&](const VCounter &counters) {
+        vec.counters = counters;
+        cols.begin();
+        cols.visit(vec);
+        cols.end();
+    };
+
+    dump({ 1, 2, 3 });
+    dump({ 1, 5, 3 });
+    dump({ 1, 5, 3 });
+    dump({ 4, 6, 3 });
+    dump({ 4, 6, 7 });
+
+    Reader reader(contents());
+    reader.readHeader();
+    reader.readSchema();
+
+    std::vector<double> values = reader.readRow();
+    EXPECT_EQ(values, (std::vector<double>{ 1, 2, 3 }));
+    EXPECT_EQ(reader.readDelta(values), 1);
+    EXPECT_EQ(values, (std::vector<double>{ 1, 5, 3 }));
+    EXPECT_EQ(reader.readDelta(values), 0);
+    EXPECT_EQ(values, (std::vector<double>{ 1, 5, 3 }));
+    EXPECT_EQ(reader.peek(), 'R');
+    values = reader.readRow();
+    EXPECT_EQ(values, (std::vector<double>{ 4, 6, 3 }));
+    EXPECT_EQ(reader.readDelta(values), 1);
+    EXPECT_EQ(values, (std::vector<double>{ 4, 6, 7 }));
+    EXPECT_TRUE(reader.atEnd());
+}
+
+/** A NaN which stays NaN is an unchanged column. */
+TEST_F(ColumnarTest, UnchangedNaN)
+{
+    FakeScalar ratio("ratio");
+    ratio.val = NAN;
+
+    Columnar cols(file, true, true, true);
+    for (int dump = 0; dump < 2; ++dump) {
+        cols.begin();
+        cols.visit(ratio);
+        cols.end();
+    }
+
+    Reader reader(contents());
+    reader.readHeader();
+    reader.readSchema();
+    std::vector<double> values = reader.readRow();
+    ASSERT_EQ(values.size(), 1);
+    EXPECT_TRUE(std::isnan(values[0]));
+    EXPECT_EQ(reader.readDelta(values), 0);
+    EXPECT_TRUE(reader.atEnd());
+}
+
+TEST(ColumnarWriterTest, Header)
+{
+    std::ostringstream os;
+    ColumnarWriter writer(os);
+    writer.flush();
+
+    Reader reader(os.str());
+    reader.readHeader();
+    EXPECT_TRUE(reader.atEnd());
+}
+
+TEST(ColumnarWriterTest, SchemaAndRows)
+{
+    const std::vector<ColumnarWriter::Stat> schema = {
+        { "curTick", "Tick of the sample", "Tick", { "" } },
+        { "system.cpu.numInsts", "Number of instructions", "Count",
+          { "" } },
+        { "system.mem.bytes", "Bytes per requestor", "Byte",
+          { "cpu", "dma", "total" } },
+    };
+    const std::vector<double> first = { 1000, 12, 64, 0, 64 };
+    const std::vector<double> second = { 2000, 20, 64, 128, 192 };
+
+    std::ostringstream os;
+    ColumnarWriter writer(os);
+    writer.writeSchema(schema);
+    writer.writeRow(first.data(), first.size());
+    writer.writeDelta(second.data(), { 0, 1, 3, 4 });
+    writer.writeRow(second.data(), second.size());
+    writer.flush();
+
+    Reader reader(os.str());
+    reader.readHeader();
+
+    const auto read_schema = reader.readSchema();
+    ASSERT_EQ(read_schema.size(), schema.size());
+    for (size_t i = 0; i < schema.size(); ++i) {
+        EXPECT_EQ(read_schema[i].name, schema[i].name);
+        EXPECT_EQ(read_schema[i].desc, schema[i].desc);
+        EXPECT_EQ(read_schema[i].unit, schema[i].unit);
+        EXPECT_EQ(read_schema[i].suffixes, schema[i].suffixes);
+    }
+
+    std::vector<double> values = reader.readRow();
+    EXPECT_EQ(values, first);
+    reader.readDelta(values);
+    EXPECT_EQ(values, second);
+    EXPECT_EQ(reader.readRow(), second);
+    EXPECT_TRUE(reader.atEnd());
+}
+
+/** A delta row without any changed column is still a row. */
+TEST(ColumnarWriterTest, EmptyDelta)
+{
+    const std::vector<double> row = { 1, 2 };
+
+    std::ostringstream os;
+    ColumnarWriter writer(os);
+    writer.writeRow(row.data(), row.size());
+    writer.writeDelta(row.data(), {});
+
+    Reader reader(os.str());
+    reader.readHeader();
+    std::vector<double> values = reader.readRow();
+    reader.readDelta(values);
+    EXPECT_EQ(values, row);
+    EXPECT_TRUE(reader.atEnd());
+}
@@ -354,6 +354,9 @@ class DynInst : public ExecContext, public RefCounted
     ssize_t sqIdx = -1;
     typename LSQUnit::SQIterator sqIt;
 
+    /** Slot of the instruction in the IQ wakeup matrix, if any. */
+    int iqSlot = -1;
+
 
     /////////////////////// TLB Miss //////////////////////
     /**
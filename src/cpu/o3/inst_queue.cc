@@ -89,6 +89,7 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
     : cpu(cpu_ptr),
       iewStage(iew_ptr),
       fuPool(params.fuPool),
+      instsToExecute(params.numIQEntries + params.numROBEntries),
       iqPolicy(params.smtIQPolicy),
       numThreads(params.numThreads),
       numEntries(params.numIQEntries),
@@ -114,6 +115,12 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
     //dependency graph.
     dependGraph.resize(numPhysRegs);
 
+    if (params.iqScheduler == IQScheduler::Matrix) {
+        matrix.reset(new WakeupMatrix(numEntries, numPhysRegs));
+        slotInst.resize(numEntries);
+        readySlots.reserve(numEntries);
+    }
+
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
 
@@ -123,6 +130,12 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
         memDepUnit[tid].setIQ(this);
     }
 
+    instList.reserve(MaxThreads);
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        instList.emplace_back(tid < numThreads ?
+            params.numIQEntries + params.numROBEntries : 0);
+    }
+
     resetState();
 
     //Figure out resource sharing policy
@@ -395,7 +408,10 @@ InstructionQueue::resetState()
     //Initialize thread IQ counts
     for (ThreadID tid = 0; tid < MaxThreads; tid++) {
         count[tid] = 0;
-        instList[tid].clear();
+        while (!instList[tid].empty()) {
+            instList[tid].back() = nullptr;
+            instList[tid].pop_back();
+        }
     }
 
     // Initialize the number of free IQ entries.
@@ -414,14 +430,17 @@ InstructionQueue::resetState()
         squashedSeqNum[tid] = 0;
     }
 
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        while (!readyInsts[i].empty())
-            readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
+    if (matrix) {
+        matrix->reset();
+        for (auto &inst : slotInst) {
+            if (inst)
+                inst->iqSlot = WakeupMatrix::InvalidSlot;
+            inst = nullptr;
+        }
     }
+
+    readyList.clear();
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -451,7 +470,7 @@ InstructionQueue::setTimeBuffer(TimeBuffer<TimeStruct> *tb_ptr)
 bool
 InstructionQueue::isDrained() const
 {
-    bool drained = dependGraph.empty() &&
+    bool drained = (matrix ? matrix->empty() : dependGraph.empty()) &&
                    instsToExecute.empty() &&
                    wbOutstanding == 0;
     for (ThreadID tid = 0; tid < numThreads; ++tid)
@@ -463,7 +482,7 @@ InstructionQueue::isDrained() const
 void
 InstructionQueue::drainSanityCheck() const
 {
-    assert(dependGraph.empty());
+    assert(matrix ? matrix->empty() : dependGraph.empty());
     assert(instsToExecute.empty());
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         memDepUnit[tid].drainSanityCheck();
@@ -545,17 +564,10 @@ InstructionQueue::isFull(ThreadID tid)
 bool
 InstructionQueue::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
+    if (matrix)
+        return matrix->anyReady();
 
-    return false;
+    return !readyList.empty();
 }
 
 void
@@ -576,7 +588,10 @@ InstructionQueue::insert(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    pushInst(instList[new_inst->threadNumber], new_inst);
+
+    if (matrix)
+        allocateSlot(new_inst);
 
     --freeEntries;
 
@@ -626,7 +641,10 @@ InstructionQueue::insertNonSpec(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    pushInst(instList[new_inst->threadNumber], new_inst);
+
+    if (matrix)
+        allocateSlot(new_inst);
 
     --freeEntries;
 
@@ -673,57 +691,6 @@ InstructionQueue::getInstToExecute()
     return inst;
 }
 
-void
-InstructionQueue::addToOrderList(OpClass op_class)
-{
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
-
-    queue_entry.queueType = op_class;
-
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
-
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
-
-        list_it++;
-    }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
-}
-
-void
-InstructionQueue::moveToYoungerInst(ListOrderIt list_order_it)
-{
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
-    }
-
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
-}
-
 void
 InstructionQueue::processFUCompletion(const DynInstPtr &inst, int fu_idx)
 {
@@ -741,7 +708,7 @@ InstructionQueue::processFUCompletion(const DynInstPtr &inst, int fu_idx)
     // of a cycle, otherwise they could add too many instructions to
     // the queue.
     issueToExecuteQueue->access(-1)->size++;
-    instsToExecute.push_back(inst);
+    pushInst(instsToExecute, inst);
 }
 
 // @todo: Figure out a better way to remove the squashed items from the
@@ -765,25 +732,9 @@ InstructionQueue::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
-    // This will avoid trying to schedule a certain op class if there are no
-    // FUs that handle it.
-    int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
-
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
-
-        assert(!readyInsts[op_class].empty());
-
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
-
+    // Issue the oldest ready instructions, giving up on an op class
+    // once it has no free FU.
+    auto try_issue = [&](const DynInstPtr &issuing_inst) {
         if (issuing_inst->isFloating()) {
             iqIOStats.fpInstQueueReads++;
         } else if (issuing_inst->isVector()) {
@@ -792,129 +743,122 @@ InstructionQueue::scheduleReadyInsts()
             iqIOStats.intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
-
         if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
+            ++iqStats.squashedInstsIssued;
+            return IssueResult::Squashed;
+        }
 
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+        return issueInst(issuing_inst, i2e_info) ?
+            IssueResult::Issued : IssueResult::Busy;
+    };
 
-            listOrder.erase(order_it++);
+    int total_issued = matrix ?
+        issueMatrix(*matrix, slotInst, readySlots, totalWidth, try_issue) :
+        readyList.issue(totalWidth, try_issue);
 
-            ++iqStats.squashedInstsIssued;
+    iqStats.numIssuedDist.sample(total_issued);
+    iqStats.instsIssued+= total_issued;
 
-            continue;
-        }
+    // If we issued any instructions, tell the CPU we had activity.
+    // @todo If the way deferred memory instructions are handeled due to
+    // translation changes then the deferredMemInsts condition should be
+    // removed from the code below.
+    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
+        cpu->activityThisCycle();
+    } else {
+        DPRINTF(IQ, "Not able to schedule any instructions.\n");
+    }
+}
 
-        int idx = FUPool::NoCapableFU;
-        Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
+bool
+InstructionQueue::issueInst(const DynInstPtr &issuing_inst,
+                            IssueStruct *i2e_info)
+{
+    OpClass op_class = issuing_inst->opClass();
+    int idx = FUPool::NoCapableFU;
+    Cycles op_latency = Cycles(1);
+    ThreadID tid = issuing_inst->threadNumber;
 
-        if (op_class != No_OpClass) {
-            idx = fuPool->getUnit(op_class);
-            if (issuing_inst->isFloating()) {
-                iqIOStats.fpAluAccesses++;
-            } else if (issuing_inst->isVector()) {
-                iqIOStats.vecAluAccesses++;
-            } else {
-                iqIOStats.intAluAccesses++;
-            }
-            if (idx > FUPool::NoFreeFU) {
-                op_latency = fuPool->getOpLatency(op_class);
-            }
+    if (op_class != No_OpClass) {
+        idx = fuPool->getUnit(op_class);
+        if (issuing_inst->isFloating()) {
+            iqIOStats.fpAluAccesses++;
+        } else if (issuing_inst->isVector()) {
+            iqIOStats.vecAluAccesses++;
+        } else {
+            iqIOStats.intAluAccesses++;
+        }
+        if (idx > FUPool::NoFreeFU) {
+            op_latency = fuPool->getOpLatency(op_class);
         }
+    }
 
-        // If we have an instruction that doesn't require a FU, or a
-        // valid FU, then schedule for execution.
-        if (idx != FUPool::NoFreeFU) {
-            if (op_latency == Cycles(1)) {
-                i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
-
-                // Add the FU onto the list of FU's to be freed next
-                // cycle if we used one.
-                if (idx >= 0)
-                    fuPool->freeUnitNextCycle(idx);
-            } else {
-                bool pipelined = fuPool->isPipelined(op_class);
-                // Generate completion event for the FU
-                ++wbOutstanding;
-                FUCompletion *execution = new FUCompletion(issuing_inst,
-                                                           idx, this);
-
-                cpu->schedule(execution,
-                              cpu->clockEdge(Cycles(op_latency - 1)));
-
-                if (!pipelined) {
-                    // If FU isn't pipelined, then it must be freed
-                    // upon the execution completing.
-                    execution->setFreeFU();
-                } else {
-                    // Add the FU onto the list of FU's to be freed next cycle.
-                    fuPool->freeUnitNextCycle(idx);
-                }
-            }
+    if (idx == FUPool::NoFreeFU) {
+        iqStats.statFuBusy[op_class]++;
+        iqStats.fuBusy[tid]++;
+        return false;
+    }
 
-            DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
-                    "[sn:%llu]\n",
-                    tid, issuing_inst->pcState(),
-                    issuing_inst->seqNum);
+    // We have an instruction that doesn't require a FU, or a valid FU,
+    // so schedule it for execution.
+    if (op_latency == Cycles(1)) {
+        i2e_info->size++;
+        pushInst(instsToExecute, issuing_inst);
 
-            readyInsts[op_class].pop();
+        // Add the FU onto the list of FU's to be freed next
+        // cycle if we used one.
+        if (idx >= 0)
+            fuPool->freeUnitNextCycle(idx);
+    } else {
+        bool pipelined = fuPool->isPipelined(op_class);
+        // Generate completion event for the FU
+        ++wbOutstanding;
+        FUCompletion *execution = new FUCompletion(issuing_inst,
+                                                   idx, this);
+
+        cpu->schedule(execution,
+                      cpu->clockEdge(Cycles(op_latency - 1)));
+
+        if (!pipelined) {
+            // If FU isn't pipelined, then it must be freed
+            // upon the execution completing.
+            execution->setFreeFU();
+        } else {
+            // Add the FU onto the list of FU's to be freed next cycle.
+            fuPool->freeUnitNextCycle(idx);
+        }
+    }
 
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+    DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
+            "[sn:%llu]\n",
+            tid, issuing_inst->pcState(),
+            issuing_inst->seqNum);
 
-            issuing_inst->setIssued();
-            ++total_issued;
+    issuing_inst->setIssued();
 
 #if TRACING_ON
-            issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
+    issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
 #endif
 
-            if (issuing_inst->firstIssue == -1)
-                issuing_inst->firstIssue = curTick();
+    if (issuing_inst->firstIssue == -1)
+        issuing_inst->firstIssue = curTick();
 
-            if (!issuing_inst->isMemRef()) {
-                // Memory instructions can not be freed from the IQ until they
-                // complete.
-                ++freeEntries;
-                count[tid]--;
-                issuing_inst->clearInIQ();
-            } else {
-                memDepUnit[tid].issue(issuing_inst);
-            }
-
-            listOrder.erase(order_it++);
-            iqStats.statIssuedInstType[tid][op_class]++;
-        } else {
-            iqStats.statFuBusy[op_class]++;
-            iqStats.fuBusy[tid]++;
-            ++order_it;
-        }
-    }
-
-    iqStats.numIssuedDist.sample(total_issued);
-    iqStats.instsIssued+= total_issued;
-
-    // If we issued any instructions, tell the CPU we had activity.
-    // @todo If the way deferred memory instructions are handeled due to
-    // translation changes then the deferredMemInsts condition should be
-    // removed from the code below.
-    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
-        cpu->activityThisCycle();
+    if (!issuing_inst->isMemRef()) {
+        // Memory instructions can not be freed from the IQ until they
+        // complete.
+        ++freeEntries;
+        count[tid]--;
+        issuing_inst->clearInIQ();
+        if (matrix)
+            releaseSlot(issuing_inst);
     } else {
-        DPRINTF(IQ, "Not able to schedule any instructions.\n");
+        if (matrix)
+            matrix->clearReady(issuing_inst->iqSlot);
+        memDepUnit[tid].issue(issuing_inst);
     }
+
+    iqStats.statIssuedInstType[tid][op_class]++;
+    return true;
 }
 
 void
@@ -944,17 +888,44 @@ InstructionQueue::scheduleNonSpec(const InstSeqNum &inst)
     nonSpecInsts.erase(inst_it);
 }
 
+void
+InstructionQueue::pushInst(CircularQueue<DynInstPtr> &ring,
+                           const DynInstPtr &inst)
+{
+    panic_if(ring.full(), "IQ instruction list overflow, capacity %d.",
+             ring.capacity());
+    ring.push_back(inst);
+}
+
+void
+InstructionQueue::allocateSlot(const DynInstPtr &inst)
+{
+    int slot = matrix->allocate(inst->seqNum);
+    panic_if(slot == WakeupMatrix::InvalidSlot,
+             "IQ wakeup matrix overflow, capacity %d.", numEntries);
+    inst->iqSlot = slot;
+    slotInst[slot] = inst;
+}
+
+void
+InstructionQueue::releaseSlot(const DynInstPtr &inst)
+{
+    int slot = inst->iqSlot;
+    assert(slot != WakeupMatrix::InvalidSlot && slotInst[slot] == inst);
+    matrix->release(slot);
+    inst->iqSlot = WakeupMatrix::InvalidSlot;
+    slotInst[slot] = nullptr;
+}
+
 void
 InstructionQueue::commit(const InstSeqNum &inst, ThreadID tid)
 {
     DPRINTF(IQ, "[tid:%i] Committing instructions older than [sn:%llu]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
-
-    while (iq_it != instList[tid].end() &&
-           (*iq_it)->seqNum <= inst) {
-        ++iq_it;
+    while (!instList[tid].empty() &&
+           instList[tid].front()->seqNum <= inst) {
+        instList[tid].front() = nullptr;
         instList[tid].pop_front();
     }
 
@@ -994,6 +965,8 @@ InstructionQueue::wakeDependents(const DynInstPtr &completed_inst)
         ++freeEntries;
         completed_inst->memOpDone(true);
         count[tid]--;
+        if (matrix)
+            releaseSlot(completed_inst);
     } else if (completed_inst->isReadBarrier() ||
                completed_inst->isWriteBarrier()) {
         // Completes a non mem ref barrier
@@ -1030,6 +1003,26 @@ InstructionQueue::wakeDependents(const DynInstPtr &completed_inst)
                 dest_reg->index(),
                 dest_reg->className());
 
+        if (matrix) {
+            dependents += matrix->wake(dest_reg->flatIndex(),
+                [this](int slot, unsigned times) {
+                    const DynInstPtr &dep_inst = slotInst[slot];
+                    DPRINTF(IQ, "Waking up a dependent instruction, "
+                            "[sn:%llu] PC %s.\n",
+                            dep_inst->seqNum, dep_inst->pcState());
+
+                    // The instruction waited on the register once for
+                    // each source operand reading it.
+                    for (unsigned i = 0; i < times; ++i)
+                        dep_inst->markSrcRegReady();
+
+                    addIfReady(dep_inst);
+                });
+
+            regScoreboard[dest_reg->flatIndex()] = true;
+            continue;
+        }
+
         //Go through the dependency chain, marking the registers as
         //ready within the waiting instructions.
         DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
@@ -1067,18 +1060,20 @@ InstructionQueue::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
+    if (matrix) {
+        // A deferred instruction may have been squashed, and released
+        // its slot, in the meantime.
+        if (ready_inst->iqSlot != WakeupMatrix::InvalidSlot)
+            matrix->setReady(ready_inst->iqSlot);
 
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
+        DPRINTF(IQ, "Instruction is ready to issue, setting it ready in "
+                "the wakeup matrix, PC %s opclass:%i [sn:%llu].\n",
+                ready_inst->pcState(), op_class, ready_inst->seqNum);
+        return;
     }
 
+    readyList.push(ready_inst);
+
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
             ready_inst->pcState(), op_class, ready_inst->seqNum);
@@ -1183,19 +1178,15 @@ InstructionQueue::squash(ThreadID tid)
 void
 InstructionQueue::doSquash(ThreadID tid)
 {
-    // Start at the tail.
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
     DPRINTF(IQ, "[tid:%i] Squashing until sequence number %i!\n",
             tid, squashedSeqNum[tid]);
 
     // Squash any instructions younger than the squashed sequence number
-    // given.
-    while (squash_it != instList[tid].end() &&
-           (*squash_it)->seqNum > squashedSeqNum[tid]) {
+    // given, starting at the tail.
+    while (!instList[tid].empty() &&
+           instList[tid].back()->seqNum > squashedSeqNum[tid]) {
 
-        DynInstPtr squashed_inst = (*squash_it);
+        DynInstPtr squashed_inst = std::move(instList[tid].back());
         if (squashed_inst->isFloating()) {
             iqIOStats.fpInstQueueWrites++;
         } else if (squashed_inst->isVector()) {
@@ -1204,13 +1195,10 @@ InstructionQueue::doSquash(ThreadID tid)
             iqIOStats.intInstQueueWrites++;
         }
 
-        // Only handle the instruction if it actually is in the IQ and
-        // hasn't already been squashed in the IQ.
-        if (squashed_inst->threadNumber != tid ||
-            squashed_inst->isSquashedInIQ()) {
-            --squash_it;
-            continue;
-        }
+        // Instructions squashed in the IQ are removed from the list right
+        // away, so the list only holds live instructions of this thread.
+        assert(squashed_inst->threadNumber == tid &&
+               !squashed_inst->isSquashedInIQ());
 
         if (!squashed_inst->isIssued() ||
             (squashed_inst->isMemRef() &&
@@ -1248,7 +1236,10 @@ InstructionQueue::doSquash(ThreadID tid)
                     // overwritten.  The only downside to this is it
                     // leaves more room for error.
 
-                    if (!squashed_inst->readySrcIdx(src_reg_idx) &&
+                    // The wakeup matrix drops the dependences of the
+                    // instruction when its slot is released.
+                    if (!matrix &&
+                        !squashed_inst->readySrcIdx(src_reg_idx) &&
                         !src_reg->isFixedMapping()) {
                         dependGraph.remove(src_reg->flatIndex(),
                                            squashed_inst);
@@ -1295,6 +1286,9 @@ InstructionQueue::doSquash(ThreadID tid)
             //Update Thread IQ Count
             count[squashed_inst->threadNumber]--;
 
+            if (matrix)
+                releaseSlot(squashed_inst);
+
             ++freeEntries;
         }
 
@@ -1314,21 +1308,18 @@ InstructionQueue::doSquash(ThreadID tid)
             if (dest_reg->isFixedMapping()){
                 continue;
             }
+            if (matrix) {
+                assert(!matrix->hasDependents(dest_reg->flatIndex()));
+                continue;
+            }
             assert(dependGraph.empty(dest_reg->flatIndex()));
             dependGraph.clearInst(dest_reg->flatIndex());
         }
-        instList[tid].erase(squash_it--);
+        instList[tid].pop_back();
         ++iqStats.squashedInstsExamined;
     }
 }
 
-bool
-InstructionQueue::PqCompare::operator()(
-        const DynInstPtr &lhs, const DynInstPtr &rhs) const
-{
-    return lhs->seqNum > rhs->seqNum;
-}
-
 bool
 InstructionQueue::addToDependents(const DynInstPtr &new_inst)
 {
@@ -1357,7 +1348,12 @@ InstructionQueue::addToDependents(const DynInstPtr &new_inst)
                         new_inst->pcState(), src_reg->index(),
                         src_reg->className());
 
-                dependGraph.insert(src_reg->flatIndex(), new_inst);
+                if (matrix) {
+                    matrix->addDependence(new_inst->iqSlot,
+                                          src_reg->flatIndex());
+                } else {
+                    dependGraph.insert(src_reg->flatIndex(), new_inst);
+                }
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1397,14 +1393,21 @@ InstructionQueue::addToProducers(const DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg->flatIndex())) {
-            dependGraph.dump();
-            panic("Dependency graph %i (%s) (flat: %i) not empty!",
-                  dest_reg->index(), dest_reg->className(),
-                  dest_reg->flatIndex());
-        }
+        if (matrix) {
+            panic_if(matrix->hasDependents(dest_reg->flatIndex()),
+                     "Wakeup matrix row %i (%s) (flat: %i) not empty!",
+                     dest_reg->index(), dest_reg->className(),
+                     dest_reg->flatIndex());
+        } else {
+            if (!dependGraph.empty(dest_reg->flatIndex())) {
+                dependGraph.dump();
+                panic("Dependency graph %i (%s) (flat: %i) not empty!",
+                      dest_reg->index(), dest_reg->className(),
+                      dest_reg->flatIndex());
+            }
 
-        dependGraph.setInst(dest_reg->flatIndex(), new_inst);
+            dependGraph.setInst(dest_reg->flatIndex(), new_inst);
+        }
 
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg->flatIndex()] = false;
@@ -1436,17 +1439,12 @@ InstructionQueue::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
+        if (matrix) {
+            matrix->setReady(inst->iqSlot);
+            return;
         }
+
+        readyList.push(inst);
     }
 }
 
@@ -1460,7 +1458,8 @@ void
 InstructionQueue::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        cprintf("Ready list %i size: %i\n", i,
+                readyList.size(OpClass(i)));
 
         cprintf("\n");
     }
@@ -1480,17 +1479,13 @@ InstructionQueue::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
     int i = 1;
 
     cprintf("List order: ");
 
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%llu] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
+    for (const auto &entry : readyList.order()) {
+        cprintf("%i OpClass:%i [sn:%llu] ", i, entry.queueType,
+                entry.oldestInst);
         ++i;
     }
 
@@ -1504,7 +1499,7 @@ InstructionQueue::dumpInsts()
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
         int num = 0;
         int valid_num = 0;
-        ListIt inst_list_it = instList[tid].begin();
+        InstIt inst_list_it = instList[tid].begin();
 
         while (inst_list_it != instList[tid].end()) {
             cprintf("Instruction:%i\n", num);
@@ -1544,7 +1539,7 @@ InstructionQueue::dumpInsts()
 
     int num = 0;
     int valid_num = 0;
-    ListIt inst_list_it = instsToExecute.begin();
+    InstIt inst_list_it = instsToExecute.begin();
 
     while (inst_list_it != instsToExecute.end())
     {
@@ -44,20 +44,24 @@
 
 #include <list>
 #include <map>
-#include <queue>
+#include <memory>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/dep_graph.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/issue_select.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/mem_dep_unit.hh"
 #include "cpu/o3/store_set.hh"
+#include "cpu/o3/wakeup_matrix.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
+#include "enums/IQScheduler.hh"
 #include "enums/SMTQueuePolicy.hh"
 #include "sim/eventq.hh"
 
@@ -101,6 +105,9 @@ class InstructionQueue
     // Typedef of iterator through the list of instructions.
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
+    // Typedef of iterator through the rings of instructions.
+    typedef typename CircularQueue<DynInstPtr>::iterator InstIt;
+
     /** FU completion event class. */
     class FUCompletion : public Event
     {
@@ -317,11 +324,22 @@ class InstructionQueue
     // Instruction lists, ready queues, and ordering
     //////////////////////////////////////
 
-    /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /**
+     * List of all the instructions in the IQ (some of which may be
+     * issued), per thread and in program order. The instructions are
+     * added at the tail, and leave the list from the head when they
+     * commit or from the tail when they are squashed, so the lists are
+     * rings. An instruction stays in the list until its commit reaches
+     * the IQ, so the rings are sized for the IQ and the ROB.
+     */
+    std::vector<CircularQueue<DynInstPtr>> instList;
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    CircularQueue<DynInstPtr> instsToExecute;
+
+    /** Add an instruction at the tail of a ring. */
+    static void pushInst(CircularQueue<DynInstPtr> &ring,
+                         const DynInstPtr &inst);
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
@@ -336,25 +354,8 @@ class InstructionQueue
      */
     std::list<DynInstPtr> retryMemInsts;
 
-    /**
-     * Struct for comparing entries to be added to the priority queue.
-     * This gives reverse ordering to the instructions in terms of
-     * sequence numbers: the instructions with smaller sequence
-     * numbers (and hence are older) will be at the top of the
-     * priority queue.
-     */
-    struct PqCompare
-    {
-        bool operator()(const DynInstPtr &lhs, const DynInstPtr &rhs) const;
-    };
-
-    typedef std::priority_queue<
-        DynInstPtr, std::vector<DynInstPtr>, PqCompare> ReadyInstQueue;
-
-    /** List of ready instructions, per op class.  They are separated by op
-     *  class to allow for easy mapping to FUs.
-     */
-    ReadyInstQueue readyInsts[Num_OpClasses];
+    /** Ready instructions of the list scheduler. */
+    ReadyList<DynInstPtr> readyList;
 
     /** List of non-speculative instructions that will be scheduled
      *  once the IQ gets a signal from commit.  While it's redundant to
@@ -367,42 +368,32 @@ class InstructionQueue
 
     typedef std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry
-    {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
+    DependencyGraph<DynInstPtr> dependGraph;
 
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
+    /**
+     * Wakeup matrix replacing the dependency graph and the ready lists
+     * when the matrix scheduler is selected, nullptr otherwise.
      */
-    std::list<ListOrderEntry> listOrder;
+    std::unique_ptr<WakeupMatrix> matrix;
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    /** Instruction held by each slot of the wakeup matrix. */
+    std::vector<DynInstPtr> slotInst;
 
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
+    /** Scratch list of the ready slots, in age order. */
+    std::vector<int> readySlots;
 
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
-     */
-    ListOrderIt readyIt[Num_OpClasses];
+    /** Give an instruction a slot in the wakeup matrix. */
+    void allocateSlot(const DynInstPtr &inst);
 
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
+    /** Release the wakeup matrix slot of an instruction. */
+    void releaseSlot(const DynInstPtr &inst);
 
     /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
+     * Issue an instruction if it doesn't need a FU or one is free.
+     *
+     * @return Whether the instruction was issued.
      */
-    void moveToYoungerInst(ListOrderIt age_order_it);
-
-    DependencyGraph<DynInstPtr> dependGraph;
+    bool issueInst(const DynInstPtr &issuing_inst, IssueStruct *i2e_info);
 
     //////////////////////////////////////
     // Various parameters
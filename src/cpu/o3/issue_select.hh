@@ -0,0 +1,306 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_ISSUE_SELECT_HH__
+#define __CPU_O3_ISSUE_SELECT_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <queue>
+#include <vector>
+
+#include "cpu/inst_seq.hh"
+#include "cpu/o3/wakeup_matrix.hh"
+#include "cpu/op_class.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/** Outcome of an attempt to issue a ready instruction. */
+enum class IssueResult
+{
+    /** The instruction was issued. */
+    Issued,
+    /** The instruction was squashed, and is dropped without issuing. */
+    Squashed,
+    /** No FU of the op class of the instruction is free. */
+    Busy
+};
+
+/**
+ * Ready instructions of the list scheduler. They are kept in a queue
+ * per op class, to allow for easy mapping to FUs, and a list orders
+ * the queues by the age of their oldest instruction, to select the
+ * oldest instruction available among op classes.
+ *
+ * @tparam InstPtr Pointer to an instruction, with a seqNum member and
+ *                 an opClass() method.
+ */
+template <class InstPtr>
+class ReadyList
+{
+  public:
+    /** Entry for the list age ordering by op class. */
+    struct ListOrderEntry
+    {
+        OpClass queueType;
+        InstSeqNum oldestInst;
+    };
+
+    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+
+    ReadyList() { clear(); }
+
+    /** Remove all the instructions. */
+    void
+    clear()
+    {
+        for (int i = 0; i < Num_OpClasses; ++i) {
+            readyInsts[i] = ReadyInstQueue();
+            queueOnList[i] = false;
+        }
+        listOrder.clear();
+        for (int i = 0; i < Num_OpClasses; ++i)
+            readyIt[i] = listOrder.end();
+    }
+
+    bool empty() const { return listOrder.empty(); }
+
+    /** Number of ready instructions of an op class. */
+    size_t size(OpClass op_class) const { return readyInsts[op_class].size(); }
+
+    /** The age order of the oldest instruction of each ready queue. */
+    const std::list<ListOrderEntry> &order() const { return listOrder; }
+
+    /** Add a ready instruction. */
+    void
+    push(const InstPtr &inst)
+    {
+        const OpClass op_class = inst->opClass();
+        readyInsts[op_class].push(inst);
+
+        // Will need to reorder the list if either a queue is not on the
+        // list, or it has an older instruction than last time.
+        if (!queueOnList[op_class]) {
+            addToOrderList(op_class);
+        } else if (readyInsts[op_class].top()->seqNum <
+                   (*readyIt[op_class]).oldestInst) {
+            listOrder.erase(readyIt[op_class]);
+            addToOrderList(op_class);
+        }
+    }
+
+    /**
+     * Issue the ready instructions, oldest first, until the width is
+     * reached. Once an op class has no free FU, its younger instructions
+     * are not tried anymore.
+     *
+     * @param width Maximum number of instructions to issue.
+     * @param try_issue Function called with each instruction selected,
+     *                  returning an IssueResult.
+     * @return The number of instructions issued.
+     */
+    template <class TryIssue>
+    int
+    issue(int width, TryIssue &&try_issue)
+    {
+        int total_issued = 0;
+        ListOrderIt order_it = listOrder.begin();
+
+        while (total_issued < width && order_it != listOrder.end()) {
+            OpClass op_class = (*order_it).queueType;
+
+            assert(!readyInsts[op_class].empty());
+
+            InstPtr issuing_inst = readyInsts[op_class].top();
+
+            assert(issuing_inst->seqNum == (*order_it).oldestInst);
+
+            IssueResult result = try_issue(issuing_inst);
+            if (result == IssueResult::Busy) {
+                ++order_it;
+                continue;
+            }
+
+            if (result == IssueResult::Issued)
+                ++total_issued;
+
+            readyInsts[op_class].pop();
+
+            if (!readyInsts[op_class].empty()) {
+                moveToYoungerInst(order_it);
+            } else {
+                readyIt[op_class] = listOrder.end();
+                queueOnList[op_class] = false;
+            }
+
+            listOrder.erase(order_it++);
+        }
+
+        return total_issued;
+    }
+
+  private:
+    /**
+     * Struct for comparing entries to be added to the priority queue.
+     * This gives reverse ordering to the instructions in terms of
+     * sequence numbers: the instructions with smaller sequence
+     * numbers (and hence are older) will be at the top of the
+     * priority queue.
+     */
+    struct PqCompare
+    {
+        bool
+        operator()(const InstPtr &lhs, const InstPtr &rhs) const
+        {
+            return lhs->seqNum > rhs->seqNum;
+        }
+    };
+
+    typedef std::priority_queue<
+        InstPtr, std::vector<InstPtr>, PqCompare> ReadyInstQueue;
+
+    /** List of ready instructions, per op class. */
+    ReadyInstQueue readyInsts[Num_OpClasses];
+
+    /** List that contains the age order of the oldest instruction of each
+     *  ready queue.
+     */
+    std::list<ListOrderEntry> listOrder;
+
+    /** Tracks if each ready queue is on the age order list. */
+    bool queueOnList[Num_OpClasses];
+
+    /** Iterators of each ready queue.  Points to their spot in the age order
+     *  list.
+     */
+    ListOrderIt readyIt[Num_OpClasses];
+
+    /** Add an op class to the age order list. */
+    void
+    addToOrderList(OpClass op_class)
+    {
+        assert(!readyInsts[op_class].empty());
+
+        ListOrderEntry queue_entry;
+        queue_entry.queueType = op_class;
+        queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
+
+        ListOrderIt list_it = listOrder.begin();
+        while (list_it != listOrder.end() &&
+               (*list_it).oldestInst <= queue_entry.oldestInst) {
+            ++list_it;
+        }
+
+        readyIt[op_class] = listOrder.insert(list_it, queue_entry);
+        queueOnList[op_class] = true;
+    }
+
+    /**
+     * Called when the oldest instruction has been removed from a ready
+     * queue; this places that ready queue into the proper spot in the age
+     * order list, after the entry it replaces.
+     */
+    void
+    moveToYoungerInst(ListOrderIt list_order_it)
+    {
+        ListOrderEntry queue_entry;
+        OpClass op_class = (*list_order_it).queueType;
+        ListOrderIt next_it = list_order_it;
+
+        ++next_it;
+
+        queue_entry.queueType = op_class;
+        queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
+
+        while (next_it != listOrder.end() &&
+               (*next_it).oldestInst < queue_entry.oldestInst) {
+            ++next_it;
+        }
+
+        readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    }
+};
+
+/**
+ * Issue the ready instructions of a wakeup matrix, oldest first, until
+ * the width is reached. Skipping the op classes that ran out of FUs
+ * issues the same instructions, in the same order, as a ReadyList
+ * holding the same ready instructions.
+ *
+ * @param matrix Wakeup matrix holding the ready state of the slots.
+ * @param slot_inst Instruction held by each slot.
+ * @param slots Scratch list for the ready slots.
+ * @param width Maximum number of instructions to issue.
+ * @param try_issue Function called with each instruction selected,
+ *                  returning an IssueResult. It may release the slot
+ *                  of the instruction.
+ * @return The number of instructions issued.
+ */
+template <class InstPtr, class TryIssue>
+int
+issueMatrix(WakeupMatrix &matrix, const std::vector<InstPtr> &slot_inst,
+            std::vector<int> &slots, int width, TryIssue &&try_issue)
+{
+    matrix.readySlots(slots);
+
+    bool fu_busy[Num_OpClasses] = {};
+    int total_issued = 0;
+
+    for (int slot : slots) {
+        if (total_issued >= width)
+            break;
+
+        // Issuing the instruction may release its slot.
+        InstPtr issuing_inst = slot_inst[slot];
+        OpClass op_class = issuing_inst->opClass();
+
+        if (fu_busy[op_class])
+            continue;
+
+        switch (try_issue(issuing_inst)) {
+          case IssueResult::Issued:
+            ++total_issued;
+            break;
+          case IssueResult::Squashed:
+            matrix.clearReady(slot);
+            break;
+          case IssueResult::Busy:
+            fu_busy[op_class] = true;
+            break;
+        }
+    }
+
+    return total_issued;
+}
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_ISSUE_SELECT_HH__
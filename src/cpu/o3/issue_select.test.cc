@@ -0,0 +1,256 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "cpu/o3/issue_select.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+struct TestInst
+{
+    InstSeqNum seqNum;
+    OpClass op;
+    bool squashed = false;
+    int slot = WakeupMatrix::InvalidSlot;
+    /** Number of source operands not written yet. */
+    unsigned waiting = 0;
+
+    OpClass opClass() const { return op; }
+};
+
+using TestInstPtr = TestInst *;
+
+const int NumSlots = 48;
+const int Width = 4;
+const OpClass OpClasses[] = { IntAluOp, IntMultOp, FloatAddOp, MemReadOp };
+/** Number of FUs of each op class above, available every cycle. */
+const int NumFUs[] = { 2, 1, 1, 1 };
+
+/**
+ * Feed the list and the matrix schedulers the same instructions, which
+ * become ready as their producers issue, and check they issue the same
+ * instructions in the same order every cycle.
+ */
+void
+compareIssueOrder(unsigned seed, int num_cycles)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::unique_ptr<TestInst>> insts;
+
+    WakeupMatrix matrix(NumSlots, num_cycles * Width);
+    std::vector<TestInstPtr> slot_inst(NumSlots);
+    std::vector<int> slots;
+    ReadyList<TestInstPtr> list;
+
+    // Instructions in the queue, oldest first.
+    std::deque<TestInstPtr> in_flight;
+    // Instructions issued in the previous cycle, written in this one.
+    std::vector<TestInstPtr> written;
+    int num_issued = 0;
+
+    auto make_ready = [&](TestInstPtr inst) {
+        list.push(inst);
+        matrix.setReady(inst->slot);
+    };
+
+    auto release = [&](TestInstPtr inst) {
+        matrix.release(inst->slot);
+        slot_inst[inst->slot] = nullptr;
+        inst->slot = WakeupMatrix::InvalidSlot;
+    };
+
+    for (int cycle = 0; cycle < num_cycles; ++cycle) {
+        // Write back the instructions issued in the previous cycle.
+        for (auto inst : written) {
+            matrix.wake(inst->seqNum, [&](int slot, unsigned count) {
+                TestInstPtr dep = slot_inst[slot];
+                dep->waiting -= count;
+                if (!dep->waiting)
+                    make_ready(dep);
+            });
+        }
+        written.clear();
+
+        // Release the slots of the instructions squashed in the previous
+        // cycle, which the list scheduler still holds until selected.
+        while (!in_flight.empty() && in_flight.back()->squashed) {
+            release(in_flight.back());
+            in_flight.pop_back();
+        }
+
+        // Dispatch instructions depending on instructions in flight.
+        for (int i = 0; i < Width; ++i) {
+            const InstSeqNum seq_num = insts.size();
+            const int slot = matrix.allocate(seq_num);
+            if (slot == WakeupMatrix::InvalidSlot)
+                break;
+
+            insts.emplace_back(new TestInst);
+            TestInstPtr inst = insts.back().get();
+            inst->seqNum = seq_num;
+            inst->op = OpClasses[rng() % 4];
+            inst->slot = slot;
+            slot_inst[slot] = inst;
+
+            for (int src = rng() % 3; src > 0 && !in_flight.empty(); --src) {
+                TestInstPtr prod = in_flight[rng() % in_flight.size()];
+                if (prod->squashed)
+                    continue;
+                matrix.addDependence(slot, prod->seqNum);
+                ++inst->waiting;
+            }
+            in_flight.push_back(inst);
+
+            if (!inst->waiting)
+                make_ready(inst);
+        }
+
+        // Squash the youngest instructions now and then.
+        if (rng() % 16 == 0) {
+            int num_squashed = rng() % (in_flight.size() + 1);
+            for (auto it = in_flight.rbegin(); num_squashed--; ++it)
+                (*it)->squashed = true;
+        }
+
+        // Issue, with fresh FUs.
+        int list_fus[4], matrix_fus[4];
+        std::copy(NumFUs, NumFUs + 4, list_fus);
+        std::copy(NumFUs, NumFUs + 4, matrix_fus);
+
+        auto try_issue = [](TestInstPtr inst, int *fus,
+                            std::vector<InstSeqNum> &order) {
+            if (inst->squashed)
+                return IssueResult::Squashed;
+            int &free = fus[std::find(OpClasses, OpClasses + 4,
+                                      inst->op) - OpClasses];
+            if (!free)
+                return IssueResult::Busy;
+            --free;
+            order.push_back(inst->seqNum);
+            return IssueResult::Issued;
+        };
+
+        std::vector<InstSeqNum> list_order, matrix_order;
+        const int list_issued = list.issue(Width, [&](TestInstPtr inst) {
+            return try_issue(inst, list_fus, list_order);
+        });
+        const int matrix_issued = issueMatrix(matrix, slot_inst, slots,
+                Width, [&](TestInstPtr inst) {
+            IssueResult result = try_issue(inst, matrix_fus, matrix_order);
+            if (result == IssueResult::Issued) {
+                written.push_back(inst);
+                release(inst);
+            }
+            return result;
+        });
+
+        ASSERT_EQ(list_order, matrix_order) << "Cycle " << cycle;
+        ASSERT_EQ(list_issued, matrix_issued) << "Cycle " << cycle;
+        ASSERT_EQ(list_issued, (int)list_order.size());
+        num_issued += list_issued;
+
+        for (auto it = in_flight.begin(); it != in_flight.end();) {
+            if ((*it)->slot == WakeupMatrix::InvalidSlot)
+                it = in_flight.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    // The sequence must have kept both schedulers busy.
+    EXPECT_GT(num_issued, num_cycles);
+}
+
+} // anonymous namespace
+
+/** Instructions are issued oldest first, across op classes. */
+TEST(IssueSelectTest, ListAgeOrder)
+{
+    TestInst insts[] = {
+        { 5, IntAluOp }, { 2, IntMultOp }, { 7, IntMultOp },
+        { 3, IntAluOp }, { 9, FloatAddOp }
+    };
+    ReadyList<TestInstPtr> list;
+    for (auto &inst : insts)
+        list.push(&inst);
+    ASSERT_FALSE(list.empty());
+    ASSERT_EQ(list.size(IntMultOp), 2u);
+
+    std::vector<InstSeqNum> order;
+    ASSERT_EQ(list.issue(8, [&](TestInstPtr inst) {
+        order.push_back(inst->seqNum);
+        return IssueResult::Issued;
+    }), 5);
+    ASSERT_EQ(order, std::vector<InstSeqNum>({ 2, 3, 5, 7, 9 }));
+    ASSERT_TRUE(list.empty());
+}
+
+/**
+ * A busy op class keeps its instructions, and the younger instructions
+ * of the other op classes are still issued.
+ */
+TEST(IssueSelectTest, ListBusy)
+{
+    TestInst insts[] = {
+        { 1, IntMultOp }, { 2, IntMultOp }, { 3, IntAluOp },
+        { 4, IntAluOp }
+    };
+    ReadyList<TestInstPtr> list;
+    for (auto &inst : insts)
+        list.push(&inst);
+
+    std::vector<InstSeqNum> order;
+    ASSERT_EQ(list.issue(8, [&](TestInstPtr inst) {
+        if (inst->op == IntMultOp)
+            return IssueResult::Busy;
+        order.push_back(inst->seqNum);
+        return IssueResult::Issued;
+    }), 2);
+    ASSERT_EQ(order, std::vector<InstSeqNum>({ 3, 4 }));
+    ASSERT_EQ(list.size(IntMultOp), 2u);
+    ASSERT_EQ(list.order().front().oldestInst, 1u);
+}
+
+/** Both schedulers issue the same instructions in the same order. */
+TEST(IssueSelectTest, MatrixMatchesList)
+{
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        SCOPED_TRACE(seed);
+        compareIssueOrder(seed, 2000);
+        if (HasFatalFailure())
+            return;
+    }
+}
@@ -0,0 +1,145 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/wakeup_matrix.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace gem5
+{
+
+namespace o3
+{
+
+WakeupMatrix::WakeupMatrix(unsigned num_slots, unsigned num_regs)
+    : numSlots(num_slots), numWords((num_slots + WordBits - 1) / WordBits),
+      deps(num_regs * numWords, 0), slotRegs(num_slots),
+      older(num_slots * numWords, 0), seqNums(num_slots, 0),
+      used(numWords, 0), ready(numWords, 0), numWaiting(0), numReady(0)
+{
+}
+
+void
+WakeupMatrix::reset()
+{
+    std::fill(deps.begin(), deps.end(), 0);
+    for (auto &regs : slotRegs)
+        regs.clear();
+    std::fill(used.begin(), used.end(), 0);
+    std::fill(ready.begin(), ready.end(), 0);
+    numWaiting = 0;
+    numReady = 0;
+}
+
+int
+WakeupMatrix::allocate(uint64_t seq_num)
+{
+    int slot = InvalidSlot;
+    for (unsigned w = 0; w < numWords; w++) {
+        if (~used[w] == 0)
+            continue;
+        slot = w * WordBits + findLsbSet(~used[w]);
+        break;
+    }
+    if (slot == InvalidSlot || slot >= (int)numSlots)
+        return InvalidSlot;
+
+    // Order the new slot against the allocated ones. The rows of the
+    // free slots are stale, but they are never read.
+    Word *row = &older[slot * numWords];
+    for (unsigned w = 0; w < numWords; w++) {
+        row[w] = 0;
+        Word bits = used[w];
+        while (bits) {
+            const int other = w * WordBits + findLsbSet(bits);
+            bits &= bits - 1;
+            if (seqNums[other] < seq_num) {
+                row[w] |= Word(1) << (other % WordBits);
+                clearBit(older, other * numWords * WordBits + slot);
+            } else {
+                setBit(older, other * numWords * WordBits + slot);
+            }
+        }
+    }
+
+    seqNums[slot] = seq_num;
+    setBit(used, slot);
+    return slot;
+}
+
+void
+WakeupMatrix::release(int slot)
+{
+    assert(allocated(slot));
+    for (unsigned reg : slotRegs[slot])
+        numWaiting -= clearBit(deps, reg * numWords * WordBits + slot);
+    slotRegs[slot].clear();
+    clearReady(slot);
+    clearBit(used, slot);
+}
+
+void
+WakeupMatrix::addDependence(int slot, unsigned reg)
+{
+    assert(allocated(slot));
+    numWaiting += setBit(deps, reg * numWords * WordBits + slot);
+    slotRegs[slot].push_back(reg);
+}
+
+bool
+WakeupMatrix::hasDependents(unsigned reg) const
+{
+    for (unsigned w = 0; w < numWords; w++) {
+        if (deps[reg * numWords + w])
+            return true;
+    }
+    return false;
+}
+
+void
+WakeupMatrix::readySlots(std::vector<int> &slots) const
+{
+    // The number of ready slots older than a ready slot is its position
+    // in age order
+    slots.resize(numReady);
+    for (unsigned w = 0; w < numWords; w++) {
+        Word bits = ready[w];
+        while (bits) {
+            const int slot = w * WordBits + findLsbSet(bits);
+            bits &= bits - 1;
+
+            const Word *row = &older[slot * numWords];
+            unsigned rank = 0;
+            for (unsigned i = 0; i < numWords; i++)
+                rank += popCount(row[i] & ready[i]);
+            assert(rank < numReady);
+            slots[rank] = slot;
+        }
+    }
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,200 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_WAKEUP_MATRIX_HH__
+#define __CPU_O3_WAKEUP_MATRIX_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Wakeup and ready state of the instructions of an instruction queue,
+ * kept as bit vectors over the entries (slots) of the queue.
+ *
+ * Each physical register has a row holding a bit for every slot whose
+ * instruction waits on that register, so waking up the consumers of a
+ * register is a scan of a single row, and a squashed instruction only
+ * clears the bits of the registers it waits on. A second bit vector
+ * holds the slots whose instructions are ready to issue, from which
+ * the queue selects the instructions to issue in age order. An age
+ * matrix, holding for each slot the slots whose instructions are
+ * older, lists the ready slots in that order without sorting them.
+ */
+class WakeupMatrix
+{
+  public:
+    static constexpr int InvalidSlot = -1;
+
+    WakeupMatrix(unsigned num_slots, unsigned num_regs);
+
+    /** Release all the slots. */
+    void reset();
+
+    /**
+     * Allocate the lowest free slot, or return InvalidSlot if none.
+     *
+     * @param seq_num Sequence number of the instruction of the slot,
+     *                which orders it against the other slots.
+     */
+    int allocate(uint64_t seq_num);
+
+    /**
+     * Release a slot, which stops waiting on any register and is no
+     * longer ready.
+     */
+    void release(int slot);
+
+    bool allocated(int slot) const { return testBit(used, slot); }
+
+    /** Make a slot wait on a register, once per source operand. */
+    void addDependence(int slot, unsigned reg);
+
+    /** Check if any slot waits on a register. */
+    bool hasDependents(unsigned reg) const;
+
+    /** Check if no slot waits on any register. */
+    bool empty() const { return numWaiting == 0; }
+
+    /**
+     * Wake up the slots waiting on a register, in slot order.
+     *
+     * @param reg Register which has been written.
+     * @param wake Function called with each slot waiting on the register
+     *             and the number of times the slot waited on it.
+     * @return The number of dependences woken up.
+     */
+    template <class Wake>
+    unsigned
+    wake(unsigned reg, Wake &&wake)
+    {
+        unsigned woken = 0;
+        Word *row = &deps[reg * numWords];
+        for (unsigned w = 0; w < numWords; w++) {
+            Word bits = row[w];
+            row[w] = 0;
+            while (bits) {
+                const int slot = w * WordBits + findLsbSet(bits);
+                bits &= bits - 1;
+                --numWaiting;
+
+                unsigned count = 0;
+                auto &regs = slotRegs[slot];
+                for (size_t i = 0; i < regs.size();) {
+                    if (regs[i] == reg) {
+                        regs[i] = regs.back();
+                        regs.pop_back();
+                        ++count;
+                    } else {
+                        ++i;
+                    }
+                }
+
+                woken += count;
+                wake(slot, count);
+            }
+        }
+        return woken;
+    }
+
+    /** @{ */
+    /** Ready state of the slots. */
+    void setReady(int slot) { numReady += setBit(ready, slot); }
+    void clearReady(int slot) { numReady -= clearBit(ready, slot); }
+    bool isReady(int slot) const { return testBit(ready, slot); }
+    bool anyReady() const { return numReady != 0; }
+    /** @} */
+
+    /** Get the ready slots, oldest first. */
+    void readySlots(std::vector<int> &slots) const;
+
+  private:
+    using Word = uint64_t;
+    static constexpr unsigned WordBits = 64;
+
+    bool
+    testBit(const std::vector<Word> &vec, unsigned bit) const
+    {
+        return (vec[bit / WordBits] >> (bit % WordBits)) & 1;
+    }
+
+    /** Set a bit, returning whether it was clear. */
+    bool
+    setBit(std::vector<Word> &vec, unsigned bit)
+    {
+        Word &word = vec[bit / WordBits];
+        const Word mask = Word(1) << (bit % WordBits);
+        const bool was_clear = !(word & mask);
+        word |= mask;
+        return was_clear;
+    }
+
+    /** Clear a bit, returning whether it was set. */
+    bool
+    clearBit(std::vector<Word> &vec, unsigned bit)
+    {
+        Word &word = vec[bit / WordBits];
+        const Word mask = Word(1) << (bit % WordBits);
+        const bool was_set = word & mask;
+        word &= ~mask;
+        return was_set;
+    }
+
+    const unsigned numSlots;
+    const unsigned numWords;
+
+    /** Row of waiting slots of each register. */
+    std::vector<Word> deps;
+
+    /** Registers each slot waits on, once per source operand. */
+    std::vector<std::vector<unsigned>> slotRegs;
+
+    /** Row of the slots older than each slot. */
+    std::vector<Word> older;
+
+    /** Sequence number of the instruction of each slot. */
+    std::vector<uint64_t> seqNums;
+
+    std::vector<Word> used;
+    std::vector<Word> ready;
+
+    /** Number of bits set in deps. */
+    unsigned numWaiting;
+
+    /** Number of bits set in ready. */
+    unsigned numReady;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_WAKEUP_MATRIX_HH__
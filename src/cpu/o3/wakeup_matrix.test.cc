@@ -0,0 +1,172 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "cpu/o3/wakeup_matrix.hh"
+
+using namespace gem5;
+
+/** Slots are allocated lowest first and reused once released. */
+TEST(WakeupMatrixTest, Allocate)
+{
+    o3::WakeupMatrix matrix(70, 4);
+
+    for (int slot = 0; slot < 70; ++slot)
+        ASSERT_EQ(matrix.allocate(slot), slot);
+    ASSERT_EQ(matrix.allocate(70), o3::WakeupMatrix::InvalidSlot);
+
+    matrix.release(65);
+    matrix.release(3);
+    ASSERT_FALSE(matrix.allocated(3));
+    ASSERT_EQ(matrix.allocate(71), 3);
+    ASSERT_EQ(matrix.allocate(72), 65);
+    ASSERT_EQ(matrix.allocate(73), o3::WakeupMatrix::InvalidSlot);
+
+    matrix.reset();
+    ASSERT_FALSE(matrix.allocated(0));
+    ASSERT_EQ(matrix.allocate(74), 0);
+}
+
+/** Waking a register reports each waiting slot and operand count once. */
+TEST(WakeupMatrixTest, Wake)
+{
+    o3::WakeupMatrix matrix(128, 8);
+    for (int i = 0; i < 128; ++i)
+        matrix.allocate(i);
+
+    matrix.addDependence(1, 5);
+    matrix.addDependence(100, 5);
+    matrix.addDependence(100, 5);
+    matrix.addDependence(100, 2);
+    ASSERT_TRUE(matrix.hasDependents(5));
+    ASSERT_FALSE(matrix.hasDependents(4));
+    ASSERT_FALSE(matrix.empty());
+
+    std::vector<std::pair<int, unsigned>> woken;
+    auto record = [&woken](int slot, unsigned times) {
+        woken.emplace_back(slot, times);
+    };
+
+    ASSERT_EQ(matrix.wake(5, record), 3u);
+    ASSERT_EQ(woken, (std::vector<std::pair<int, unsigned>>{
+        {1, 1}, {100, 2}}));
+    ASSERT_FALSE(matrix.hasDependents(5));
+    ASSERT_TRUE(matrix.hasDependents(2));
+
+    woken.clear();
+    ASSERT_EQ(matrix.wake(5, record), 0u);
+    ASSERT_TRUE(woken.empty());
+
+    ASSERT_EQ(matrix.wake(2, record), 1u);
+    ASSERT_TRUE(matrix.empty());
+}
+
+/** Releasing a slot drops its dependences and its ready state. */
+TEST(WakeupMatrixTest, Release)
+{
+    o3::WakeupMatrix matrix(8, 4);
+    int a = matrix.allocate(1);
+    int b = matrix.allocate(2);
+
+    matrix.addDependence(a, 1);
+    matrix.addDependence(a, 2);
+    matrix.addDependence(b, 2);
+    matrix.setReady(b);
+    ASSERT_TRUE(matrix.anyReady());
+
+    matrix.release(a);
+    ASSERT_FALSE(matrix.hasDependents(1));
+    ASSERT_TRUE(matrix.hasDependents(2));
+
+    matrix.release(b);
+    ASSERT_TRUE(matrix.empty());
+    ASSERT_FALSE(matrix.anyReady());
+
+    // A reused slot doesn't inherit the dependences of its last owner.
+    ASSERT_EQ(matrix.allocate(3), a);
+    int woken = 0;
+    matrix.wake(2, [&woken](int, unsigned) { ++woken; });
+    ASSERT_EQ(woken, 0);
+}
+
+/** The ready slots are reported oldest first. */
+TEST(WakeupMatrixTest, Ready)
+{
+    o3::WakeupMatrix matrix(130, 1);
+    for (int i = 0; i < 130; ++i)
+        matrix.allocate(i);
+
+    matrix.setReady(129);
+    matrix.setReady(7);
+    matrix.setReady(64);
+    matrix.setReady(7);
+    ASSERT_TRUE(matrix.isReady(64));
+    ASSERT_FALSE(matrix.isReady(63));
+
+    std::vector<int> slots;
+    matrix.readySlots(slots);
+    ASSERT_EQ(slots, (std::vector<int>{ 7, 64, 129 }));
+
+    matrix.clearReady(7);
+    matrix.clearReady(7);
+    matrix.clearReady(64);
+    matrix.clearReady(129);
+    ASSERT_FALSE(matrix.anyReady());
+    matrix.readySlots(slots);
+    ASSERT_TRUE(slots.empty());
+}
+
+/** The age order follows the sequence numbers, not the slots. */
+TEST(WakeupMatrixTest, AgeOrder)
+{
+    o3::WakeupMatrix matrix(130, 1);
+    for (int i = 0; i < 130; ++i)
+        matrix.allocate(1000 + i);
+
+    // Reused slots get younger instructions, and instructions may be
+    // allocated out of order, e.g., by different threads.
+    matrix.release(0);
+    matrix.release(100);
+    matrix.release(70);
+    ASSERT_EQ(matrix.allocate(2000), 0);
+    ASSERT_EQ(matrix.allocate(500), 70);
+    ASSERT_EQ(matrix.allocate(1500), 100);
+
+    for (int slot : { 0, 5, 64, 70, 100, 129 })
+        matrix.setReady(slot);
+
+    std::vector<int> slots;
+    matrix.readySlots(slots);
+    ASSERT_EQ(slots, (std::vector<int>{ 70, 5, 64, 129, 100, 0 }));
+
+    // Releasing a slot drops it from the order of the others.
+    matrix.release(64);
+    matrix.readySlots(slots);
+    ASSERT_EQ(slots, (std::vector<int>{ 70, 5, 129, 100, 0 }));
+}
@@ -50,7 +50,8 @@ namespace gem5
 {
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+    : trace(filename),
+      readAhead([this](TraceElement& element) { return fetch(element); })
 {
     init();
 }
@@ -71,12 +72,19 @@ TraceGen::InputStream::init()
 void
 TraceGen::InputStream::reset()
 {
+    readAhead.stop();
     trace.reset();
     init();
 }
 
 bool
 TraceGen::InputStream::read(TraceElement& element)
+{
+    return readAhead.read(element);
+}
+
+bool
+TraceGen::InputStream::fetch(TraceElement& element)
 {
     ProtoMessage::Packet pkt_msg;
     if (trace.read(pkt_msg)) {
@@ -46,6 +46,7 @@
 
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
+#include "base/read_ahead.hh"
 #include "base_gen.hh"
 #include "mem/packet.hh"
 #include "proto/protoio.hh"
@@ -114,6 +115,18 @@ class TraceGen : public BaseGen
         /// Input file stream for the protobuf trace
         ProtoInputStream trace;
 
+        /// Elements decoded ahead of the replay
+        ReadAhead<TraceElement> readAhead;
+
+        /**
+         * Decode the next trace element, called from the read ahead
+         * thread.
+         *
+         * @param element Trace element to populate
+         * @return True if an element could be read successfully
+         */
+        bool fetch(TraceElement& element);
+
       public:
 
         /**
@@ -1198,7 +1198,9 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         const std::string& filename, const double time_multiplier) :
     trace(filename),
     timeMultiplier(time_multiplier),
-    microOpCount(0)
+    microOpCount(0),
+    fetchedOpCount(0),
+    readAhead([this](GraphNode& element) { return fetch(&element); })
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
@@ -1219,11 +1221,22 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
+    readAhead.stop();
     trace.reset();
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
+{
+    if (!readAhead.read(*element))
+        return false;
+
+    microOpCount = element->robNum;
+    return true;
+}
+
+bool
+TraceCPU::ElasticDataGen::InputStream::fetch(GraphNode* element)
 {
     ProtoMessage::InstDepRecord pkt_msg;
     if (trace.read(pkt_msg)) {
@@ -1280,11 +1293,11 @@ TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
             element->pc = 0;
 
         // ROB occupancy number
-        ++microOpCount;
+        ++fetchedOpCount;
         if (pkt_msg.has_weight()) {
-            microOpCount += pkt_msg.weight();
+            fetchedOpCount += pkt_msg.weight();
         }
-        element->robNum = microOpCount;
+        element->robNum = fetchedOpCount;
         return true;
     }
 
@@ -1379,7 +1392,8 @@ TraceCPU::ElasticDataGen::GraphNode::typeToStr() const
 }
 
 TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+    : trace(filename),
+      readAhead([this](TraceElement& element) { return fetch(&element); })
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
@@ -1396,11 +1410,18 @@ TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
 void
 TraceCPU::FixedRetryGen::InputStream::reset()
 {
+    readAhead.stop();
     trace.reset();
 }
 
 bool
 TraceCPU::FixedRetryGen::InputStream::read(TraceElement* element)
+{
+    return readAhead.read(*element);
+}
+
+bool
+TraceCPU::FixedRetryGen::InputStream::fetch(TraceElement* element)
 {
     ProtoMessage::Packet pkt_msg;
     if (trace.read(pkt_msg)) {
@@ -44,6 +44,7 @@
 #include <set>
 #include <unordered_map>
 
+#include "base/read_ahead.hh"
 #include "base/statistics.hh"
 #include "cpu/base.hh"
 #include "debug/TraceCPUData.hh"
@@ -377,6 +378,18 @@ class TraceCPU : public BaseCPU
             // Input file stream for the protobuf trace
             ProtoInputStream trace;
 
+            /** Elements decoded ahead of the replay */
+            ReadAhead<TraceElement> readAhead;
+
+            /**
+             * Decode the next trace element, called from the read
+             * ahead thread.
+             *
+             * @param element Trace element to populate
+             * @return True if an element could be read successfully
+             */
+            bool fetch(TraceElement* element);
+
           public:
             /**
              * Create a trace input stream for a given file name.
@@ -775,12 +788,29 @@ class TraceCPU : public BaseCPU
             /** Count of committed ops read from trace plus the filtered ops */
             uint64_t microOpCount;
 
+            /**
+             * Count of ops decoded by the read ahead thread, which may be
+             * ahead of microOpCount.
+             */
+            uint64_t fetchedOpCount;
+
             /**
              * The window size that is read from the header of the protobuf
              * trace and used to process the dependency trace
              */
             uint32_t windowSize;
 
+            /** Nodes decoded ahead of the replay */
+            ReadAhead<GraphNode> readAhead;
+
+            /**
+             * Decode the next node, called from the read ahead thread.
+             *
+             * @param element Node to populate
+             * @return True if a node could be read successfully
+             */
+            bool fetch(GraphNode* element);
+
           public:
             /**
              * Create a trace input stream for a given file name.
@@ -67,6 +67,14 @@ class DRAMInterface(MemInterface):
     # performance being lower when enabled
     enable_dram_powerdown = Param.Bool(False, "Enable powerdown states")
 
+    # Skip the refresh events of the ranks while nothing is queued for the
+    # interface, e.g. during long idle phases, and account for the skipped
+    # refreshes on the next access or stats event. The power state times
+    # and DRAMPower energy are the same as if every refresh was simulated.
+    # Only applies without powerdown, as idle ranks otherwise stop
+    # refreshing in self-refresh.
+    lazy_refresh = Param.Bool(False, "Skip refresh events of idle ranks")
+
     # For power modelling we need to know if the DRAM has a DLL or not
     dll = Param.Bool(True, "DRAM has DLL or not")
 
@@ -144,6 +144,15 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MiB', "Maximum capacity of snoop filter")
 
+    # By default the lines are tracked in an unbounded hash table, and
+    # max_capacity is only a sanity check. A non-zero associativity
+    # makes the filter a set-associative structure of max_capacity worth
+    # of lines, whose evictions back-invalidate the caches above, and
+    # which needs a replacement policy, e.g., LRURP().
+    assoc = Param.Unsigned(0, "Associativity, 0 for an unbounded filter")
+    replacement_policy = Param.BaseReplacementPolicy(NULL,
+        "Replacement policy of a set-associative filter")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -378,10 +378,10 @@ Cache::handleTimingReqMiss(PacketPtr pkt, CacheBlk *blk, Tick forward_time,
 
         if (!mshr) {
             // copy the request and create a new SoftPFReq packet
-            RequestPtr req = std::make_shared<Request>(pkt->req->getPaddr(),
-                                                    pkt->req->getSize(),
-                                                    pkt->req->getFlags(),
-                                                    pkt->req->requestorId());
+            RequestPtr req = allocRequest(pkt->req->getPaddr(),
+                                          pkt->req->getSize(),
+                                          pkt->req->getFlags(),
+                                          pkt->req->requestorId());
             pf = new Packet(req, pkt->cmd);
             pf->allocate();
             assert(pf->matchAddr(pkt));
@@ -963,7 +963,7 @@ Cache::cleanEvictBlk(CacheBlk *blk)
     assert(blk && blk->isValid() && !blk->isSet(CacheBlk::DirtyBit));
 
     // Creating a zero sized write, a message to the snoop filter
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = allocRequest(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1110,6 +1110,9 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
                     __func__, pkt->print(), blk->print());
             PacketPtr wb_pkt =
                 writecleanBlk(blk, pkt->req->getDest(), pkt->id);
+            if (pkt->isBackInvalidation()) {
+                wb_pkt->setBackInvalidation();
+            }
             PacketList writebacks;
             writebacks.push_back(wb_pkt);
 
@@ -1321,7 +1324,7 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
         // state to determine if it is dirty and writable, we use the
         // command and fields of the writeback packet
         bool respond = wb_pkt->cmd == MemCmd::WritebackDirty &&
-            pkt->needsResponse();
+            pkt->needsResponse() && !pkt->isBackInvalidation();
         bool have_writable = !wb_pkt->hasSharers();
         bool invalidate = pkt->isInvalidate();
 
@@ -1342,7 +1345,47 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                                    false, false);
         }
 
-        if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
+        if (pkt->isBackInvalidation() &&
+            wb_pkt->cmd == MemCmd::WritebackDirty) {
+            // the back-invalidation of a snoop filter cannot be
+            // responded to, instead, as in handleSnoop, the dirty line
+            // is written down by a WriteClean that carries its id, and
+            // that the crossbar of the filter stops at the memory below
+            DPRINTF(Cache, "%s: Cleaning %s on writequeue hit\n",
+                    __func__, wb_pkt->print());
+            RequestPtr req = allocRequest(wb_pkt->getAddr(), blkSize, 0,
+                                          Request::wbRequestorId);
+            if (wb_pkt->isSecure()) {
+                req->setFlags(Request::SECURE);
+            }
+            req->taskId(wb_pkt->req->taskId());
+
+            PacketPtr wc_pkt = new Packet(req, MemCmd::WriteClean, blkSize,
+                                          pkt->id);
+            wc_pkt->setBackInvalidation();
+            if (pkt->req->getDest()) {
+                req->setFlags(pkt->req->getDest());
+                wc_pkt->setWriteThrough();
+            }
+            if (wb_pkt->hasSharers()) {
+                wc_pkt->setHasSharers();
+            }
+            wc_pkt->allocate();
+            wc_pkt->setData(wb_pkt->getConstPtr<uint8_t>());
+
+            PacketList writebacks;
+            writebacks.push_back(wc_pkt);
+
+            // Note: markInService will remove entry from writeback buffer.
+            markInService(wb_entry);
+            delete wb_pkt;
+
+            // anything that is merely forwarded pays for the forward
+            // latency and the delay provided by the crossbar
+            doWritebacks(writebacks,
+                         clockEdge(forwardLatency) + pkt->headerDelay);
+            pkt->setSatisfied();
+        } else if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
             // Invalidation trumps our writeback... discard here
             // Note: markInService will remove entry from writeback buffer.
             markInService(wb_entry);
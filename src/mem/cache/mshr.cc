@@ -495,8 +495,10 @@ MSHR::handleSnoop(PacketPtr pkt, Counter _order)
         // the packet and the request as part of handling the deferred
         // snoop.
         PacketPtr cp_pkt = will_respond ? new Packet(pkt, true, true) :
-            new Packet(std::make_shared<Request>(*pkt->req), pkt->cmd,
-                       blkSize, pkt->id);
+            new Packet(allocRequest(*pkt->req), pkt->cmd, blkSize, pkt->id);
+        if (pkt->isBackInvalidation()) {
+            cp_pkt->setBackInvalidation();
+        }
 
         if (will_respond) {
             // we are the ordering point, and will consequently
@@ -540,7 +542,11 @@ MSHR::handleSnoop(PacketPtr pkt, Counter _order)
         pkt->setHasSharers();
     }
 
-    return will_respond;
+    // A clean and invalidate that finds us awaiting a writable copy
+    // is only done once we have it, and the cache must not invalidate
+    // the copy it has now, as the response may not bring any data
+    return will_respond ||
+        (isPendingModified() && pkt->isClean() && pkt->isInvalidate());
 }
 
 MSHR::TargetList
@@ -785,7 +791,7 @@ void
 MSHR::updateLockedRMWReadTarget(PacketPtr pkt)
 {
     assert(!targets.empty() && targets.front().pkt == pkt);
-    RequestPtr r = std::make_shared<Request>(*(pkt->req));
+    RequestPtr r = allocRequest(*(pkt->req));
     targets.front().pkt = new Packet(r, MemCmd::LockedRMWReadReq);
 }
 
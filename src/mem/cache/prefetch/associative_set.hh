@@ -106,6 +106,15 @@ class AssociativeSet
      */
     std::vector<Entry *> getPossibleEntries(const Addr addr) const;
 
+    /**
+     * Get one of the possible entries of an address, without building
+     * the list of all of them
+     * @param addr address of the entry
+     * @param way way of the entry
+     * @result the possible entry of the given way
+     */
+    Entry* getPossibleEntry(const Addr addr, unsigned way) const;
+
     /**
      * Indicate that an entry has just been inserted
      * @param addr key of the container
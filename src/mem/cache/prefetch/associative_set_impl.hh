@@ -108,6 +108,13 @@ AssociativeSet<Entry>::getPossibleEntries(const Addr addr) const
     return entries;
 }
 
+template<class Entry>
+Entry*
+AssociativeSet<Entry>::getPossibleEntry(const Addr addr, unsigned way) const
+{
+    return static_cast<Entry *>(indexingPolicy->getPossibleEntry(addr, way));
+}
+
 template<class Entry>
 void
 AssociativeSet<Entry>::insertEntry(Addr addr, bool is_secure, Entry* entry)
@@ -149,6 +149,17 @@ class BaseIndexingPolicy : public SimObject
     virtual std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr)
                                                                     const = 0;
 
+    /**
+     * Get one of the possible entries of an address, without building
+     * the list of all of them, e.g., to look an address up in a hot path.
+     *
+     * @param addr The addr to find a possible entry for.
+     * @param way The way of the possible entry.
+     * @return The possible entry of the given way.
+     */
+    virtual ReplaceableEntry* getPossibleEntry(const Addr addr,
+                                               const uint32_t way) const = 0;
+
     /**
      * Regenerate an entry's address from its tag and assigned indexing bits.
      *
@@ -75,4 +75,10 @@ SetAssociative::getPossibleEntries(const Addr addr) const
     return sets[extractSet(addr)];
 }
 
+ReplaceableEntry*
+SetAssociative::getPossibleEntry(const Addr addr, const uint32_t way) const
+{
+    return sets[extractSet(addr)][way];
+}
+
 } // namespace gem5
@@ -220,4 +220,10 @@ SkewedAssociative::getPossibleEntries(const Addr addr) const
     return entries;
 }
 
+ReplaceableEntry*
+SkewedAssociative::getPossibleEntry(const Addr addr, const uint32_t way) const
+{
+    return sets[extractSet(addr, way)][way];
+}
+
 } // namespace gem5
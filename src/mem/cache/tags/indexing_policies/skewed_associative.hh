@@ -163,6 +163,17 @@ class SkewedAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
                                                                    override;
 
+    /**
+     * Get one of the possible entries of an address, without building
+     * the list of all of them.
+     *
+     * @param addr The addr to find a possible entry for.
+     * @param way The way of the possible entry.
+     * @return The possible entry of the given way.
+     */
+    ReplaceableEntry* getPossibleEntry(const Addr addr, const uint32_t way)
+                                                          const override;
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      * Uses the inverse of the skewing function.
@@ -54,7 +54,8 @@ namespace gem5
 WriteQueue::WriteQueue(const std::string &_label,
                        int num_entries, int reserve, const std::string &name)
     : Queue<WriteQueueEntry>(_label, num_entries, reserve,
-            name + ".write_queue")
+            name + ".write_queue"),
+      _numBackInvalidations(0)
 {}
 
 WriteQueueEntry *
@@ -71,6 +72,8 @@ WriteQueue::allocate(Addr blk_addr, unsigned blk_size, PacketPtr pkt,
     entry->readyIter = addToReadyList(entry);
 
     allocated += 1;
+    if (pkt->isBackInvalidation())
+        _numBackInvalidations += 1;
     return entry;
 }
 
@@ -81,6 +84,8 @@ WriteQueue::markInService(WriteQueueEntry *entry)
     // there is no more to do as we are done from the perspective of
     // this cache, and for uncacheable write we do not need the entry
     // as part of the response handling
+    if (entry->getTarget()->pkt->isBackInvalidation())
+        _numBackInvalidations -= 1;
     entry->popTarget();
     deallocate(entry);
 }
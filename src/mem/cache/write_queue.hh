@@ -96,6 +96,19 @@ class WriteQueue : public Queue<WriteQueueEntry>
      * @param entry The entry to mark in service.
      */
     void markInService(WriteQueueEntry *entry);
+
+    /**
+     * Get the number of writes of lines back-invalidated by a snoop
+     * filter that are waiting to be sent.
+     *
+     * @return The number of back-invalidation writes.
+     */
+    int numBackInvalidations() const { return _numBackInvalidations; }
+
+  private:
+
+    /** The number of back-invalidation writes waiting to be sent. */
+    int _numBackInvalidations;
 };
 
 } // namespace gem5
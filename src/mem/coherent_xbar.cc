@@ -170,6 +170,21 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         return false;
     }
 
+    // the dirty copies of a line evicted from the snoop filter are not
+    // snooped while they are written down, so the requests to the line
+    // wait for them, and retry once the layer is released
+    if (snoopFilter && !is_express_snoop &&
+        snoopFilter->waitForWriteDown(pkt)) {
+        DPRINTF(CoherentXBar, "%s: src %s packet %s WAIT\n", __func__,
+                src_port->name(), pkt->print());
+
+        reqLayers[mem_side_port_id]->succeededTiming(clockEdge(Cycles(1)));
+        [[maybe_unused]] bool layer_free =
+            reqLayers[mem_side_port_id]->tryTiming(src_port);
+        assert(!layer_free);
+        return false;
+    }
+
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             src_port->name(), pkt->print());
 
@@ -284,8 +299,10 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
 
             // make sure that the write request (e.g., WriteClean)
             // will stop at the memory below if this crossbar is its
-            // destination
-            if (pkt->isWrite() && is_destination) {
+            // destination, or if it writes a line back-invalidated by
+            // the snoop filter
+            if (pkt->isWrite() &&
+                (is_destination || isBackInvalidation(pkt))) {
                 pkt->clearWriteThrough();
             }
 
@@ -307,6 +324,12 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         snoopFilter->finishRequest(!success, addr, pkt->isSecure());
     }
 
+    if (success && isBackInvalidation(pkt)) {
+        // the write of a dirty line evicted from the snoop filter is
+        // done, and the requests to the line can go ahead
+        snoopFilter->finishWriteDown(pkt, *src_port);
+    }
+
     // check if we were successful in sending the packet onwards
     if (!success)  {
         // express snoops should never be forced to retry
@@ -808,8 +831,10 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
         if (forwardPacket(pkt)) {
             // make sure that the write request (e.g., WriteClean)
             // will stop at the memory below if this crossbar is its
-            // destination
-            if (pkt->isWrite() && is_destination) {
+            // destination, or if it writes a line back-invalidated by
+            // the snoop filter
+            if (pkt->isWrite() &&
+                (is_destination || isBackInvalidation(pkt))) {
                 pkt->clearWriteThrough();
             }
 
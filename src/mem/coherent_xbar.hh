@@ -253,6 +253,17 @@ class CoherentXBar : public BaseXBar
 
     std::vector<QueuedResponsePort*> snoopPorts;
 
+    /**
+     * Remember where request packets came from so that we can route
+     * responses to the appropriate port. This relies on the fact that
+     * the underlying Request pointer inside the Packet stays
+     * constant. Unlike the non-coherent crossbar, we cannot carry the
+     * route in the packet itself, as a snoop response may be a
+     * different packet for the same request, created by the cache
+     * that supplies the data.
+     */
+    std::unordered_map<RequestPtr, PortID> routeTo;
+
     /**
      * Store the outstanding requests that we are expecting snoop
      * responses from so we can determine which snoop responses we
@@ -414,8 +425,27 @@ class CoherentXBar : public BaseXBar
     bool
     isDestination(const PacketPtr pkt) const
     {
-        return (pkt->req->isToPOC() && pointOfCoherency) ||
-            (pkt->req->isToPOU() && pointOfUnification);
+        return !isBackInvalidation(pkt) &&
+            ((pkt->req->isToPOC() && pointOfCoherency) ||
+             (pkt->req->isToPOU() && pointOfUnification));
+    }
+
+    /**
+     * Determine if the packet is caused by a back-invalidation of the
+     * snoop filter of this crossbar
+     *
+     * The writes of the dirty lines stop at the memory below, and are
+     * not paired with a cache maintenance operation even if this is
+     * the Point of Coherence.
+     *
+     * @param pkt The processed packet
+     *
+     * @return Whether the packet is caused by a back-invalidation
+     */
+    bool
+    isBackInvalidation(const PacketPtr pkt) const
+    {
+        return snoopFilter && snoopFilter->isBackInvalidation(pkt);
     }
 
     statistics::Scalar snoops;
@@ -40,6 +40,8 @@
 
 #include "mem/dram_interface.hh"
 
+#include <algorithm>
+
 #include "base/bitfield.hh"
 #include "base/cprintf.hh"
 #include "base/trace.hh"
@@ -59,116 +61,124 @@ namespace memory
 std::pair<MemPacketQueue::iterator, Tick>
 DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
 {
-    std::vector<uint32_t> earliest_banks(ranksPerChannel, 0);
-
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
-
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
+    // The queue keeps the packets of every bank in arrival order, so
+    // only the oldest row hit and the oldest row miss of each bank can
+    // be selected. Packets of different banks are ordered by their
+    // sequence number, and the selection is the same as if the whole
+    // queue was searched in arrival order:
+    // 1) the oldest row hit that can issue seamlessly
+    // 2) the oldest packet to a closed row of one of the banks with the
+    //    earliest activate, if the bank commands can be hidden
+    // 3) the oldest row hit, the bank being prepped and ready
+    // 4) the oldest packet to a closed row of one of the earliest banks
     // Will select closed rows first to enable more open row possibilies
     // in future selections
-    bool found_hidden_bank = false;
+    const MemPacketQueue::Entry* seamless_hit = nullptr;
+    const MemPacketQueue::Entry* prepped_hit = nullptr;
+    bool found_row_miss = false;
 
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
+    for (int i = 0; i < ranksPerChannel; i++) {
+        // check if rank is not doing a refresh and thus is available,
+        // if not, jump to the next rank
+        if (!ranks[i]->inRefIdleState()) {
+            DPRINTF(DRAM, "%s Rank %d not available\n", __func__, i);
+            continue;
+        }
 
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
+        for (int j = 0; j < banksPerRank; j++) {
+            const auto* bank_queue =
+                queue.bankQueue(pseudoChannel, i * banksPerRank + j);
+            if (!bank_queue)
+                continue;
+
+            const Bank& bank = ranks[i]->banks[j];
+            const MemPacketQueue::Entry* hit = nullptr;
+            for (const auto& entry : *bank_queue) {
+                const MemPacket* pkt = *entry.pkt;
+                if (bank.openRow == pkt->row) {
+                    if (!hit)
+                        hit = &entry;
+                } else {
+                    found_row_miss = true;
+                }
 
-    Tick selected_col_at = MaxTick;
-    auto selected_pkt_it = queue.end();
+                if (hit && found_row_miss)
+                    break;
+            }
 
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        MemPacket* pkt = *i;
+            if (!hit)
+                continue;
 
-        // select optimal DRAM packet in Q
-        if (pkt->isDram() && (pkt->pseudoChannel == pseudoChannel)) {
-            const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
-            const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
-                                                        bank.wrAllowedAt;
+            DPRINTF(DRAM, "%s Row buffer hit in bank %d - Rank %d\n",
+                    __func__, j, i);
 
-            DPRINTF(DRAM, "%s checking DRAM packet in bank %d, row %d\n",
-                    __func__, pkt->bank, pkt->row);
+            // no additional rank-to-rank or same bank-group delays, or
+            // we switched read/write and might as well go for the row hit
+            const Tick col_allowed_at = (*hit->pkt)->isRead() ?
+                bank.rdAllowedAt : bank.wrAllowedAt;
+            const MemPacketQueue::Entry*& oldest_hit =
+                col_allowed_at <= min_col_at ? seamless_hit : prepped_hit;
+            if (!oldest_hit || hit->seq < oldest_hit->seq)
+                oldest_hit = hit;
+        }
+    }
 
-            // check if rank is not doing a refresh and thus is available,
-            // if not, jump to the next packet
-            if (burstReady(pkt)) {
+    const MemPacketQueue::Entry* selected = seamless_hit;
 
-                DPRINTF(DRAM,
-                        "%s bank %d - Rank %d available\n", __func__,
-                        pkt->bank, pkt->rank);
+    if (!selected && found_row_miss) {
+        // determine banks with earliest bank delay, minBankPrep will
+        // give priority to packets that can issue seamlessly
+        std::vector<uint32_t> earliest_banks;
+        bool hidden_bank_prep;
+        std::tie(earliest_banks, hidden_bank_prep) =
+            minBankPrep(queue, min_col_at);
 
-                // check if it is a row hit
-                if (bank.openRow == pkt->row) {
-                    // no additional rank-to-rank or same bank-group
-                    // delays, or we switched read/write and might as well
-                    // go for the row hit
-                    if (col_allowed_at <= min_col_at) {
-                        // FCFS within the hits, giving priority to
-                        // commands that can issue seamlessly, without
-                        // additional delay, such as same rank accesses
-                        // and/or different bank-group accesses
-                        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        // no need to look through the remaining queue entries
-                        break;
-                    } else if (!found_hidden_bank && !found_prepped_pkt) {
-                        // if we did not find a packet to a closed row that can
-                        // issue the bank commands without incurring delay, and
-                        // did not yet find a packet to a prepped row, remember
-                        // the current one
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        found_prepped_pkt = true;
-                        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                    }
-                } else if (!found_earliest_pkt) {
-                    // if we have not initialised the bank status, do it
-                    // now, and only once per scheduling decisions
-                    if (!filled_earliest_banks) {
-                        // determine entries with earliest bank delay
-                        std::tie(earliest_banks, hidden_bank_prep) =
-                            minBankPrep(queue, min_col_at);
-                        filled_earliest_banks = true;
-                    }
+        const MemPacketQueue::Entry* earliest_miss = nullptr;
+        for (int i = 0; i < ranksPerChannel; i++) {
+            for (int j = 0; j < banksPerRank; j++) {
+                if (!bits(earliest_banks[i], j, j))
+                    continue;
 
-                    // bank is amongst first available banks
-                    // minBankPrep will give priority to packets that can
-                    // issue seamlessly
-                    if (bits(earliest_banks[pkt->rank],
-                             pkt->bank, pkt->bank)) {
-                        found_earliest_pkt = true;
-                        found_hidden_bank = hidden_bank_prep;
-
-                        // give priority to packets that can issue
-                        // bank commands 'behind the scenes'
-                        // any additional delay if any will be due to
-                        // col-to-col command requirements
-                        if (hidden_bank_prep || !found_prepped_pkt) {
-                            selected_pkt_it = i;
-                            selected_col_at = col_allowed_at;
+                // the bank is only in the mask if it has DRAM packets
+                // queued and its rank is available
+                const Bank& bank = ranks[i]->banks[j];
+                for (const auto& entry : *queue.bankQueue(pseudoChannel,
+                         i * banksPerRank + j)) {
+                    const MemPacket* pkt = *entry.pkt;
+                    if (bank.openRow != pkt->row) {
+                        if (!earliest_miss ||
+                            entry.seq < earliest_miss->seq) {
+                            earliest_miss = &entry;
                         }
+                        break;
                     }
                 }
-            } else {
-                DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                        pkt->bank, pkt->rank);
             }
         }
+
+        // give priority to packets that can issue bank commands 'behind
+        // the scenes', any additional delay if any will be due to
+        // col-to-col command requirements
+        if (earliest_miss && (hidden_bank_prep || !prepped_hit))
+            selected = earliest_miss;
     }
 
-    if (selected_pkt_it == queue.end()) {
+    if (!selected)
+        selected = prepped_hit;
+
+    if (!selected) {
         DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+        return std::make_pair(queue.end(), MaxTick);
     }
 
-    return std::make_pair(selected_pkt_it, selected_col_at);
+    const MemPacket* pkt = *selected->pkt;
+    const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
+    DPRINTF(DRAM, "%s selected packet in bank %d, row %d\n", __func__,
+            pkt->bank, pkt->row);
+
+    return std::make_pair(selected->pkt,
+                          pkt->isRead() ? bank.rdAllowedAt :
+                                          bank.wrAllowedAt);
 }
 
 void
@@ -508,7 +518,13 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
         bool got_bank_conflict = false;
 
         for (uint8_t i = 0; i < ctrl->numPriorities(); ++i) {
-            auto p = queue[i].begin();
+            // only the packets queued for the same bank of this
+            // interface can be hits or bank conflicts
+            const auto *bank_queue = queue[i].bankQueue(pseudoChannel,
+                                                        mem_pkt->bankId);
+            if (!bank_queue)
+                continue;
+
             // keep on looking until we find a hit or reach the end of the
             // queue
             // 1) if a hit is found, then both open and close adaptive
@@ -517,23 +533,16 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
             //    bank conflict request is waiting in the queue
             // 3) make sure we are not considering the packet that we are
             //    currently dealing with
-            while (!got_more_hits && p != queue[i].end()) {
-
-                if ((*p)->pseudoChannel != pseudoChannel) {
-                    // only consider if this pkt belongs to this interface
-                    ++p;
+            for (const auto& entry : *bank_queue) {
+                const MemPacket* p = *entry.pkt;
+                if (p == mem_pkt)
                     continue;
-                }
 
-                if (mem_pkt != (*p)) {
-                    bool same_rank_bank = (mem_pkt->rank == (*p)->rank) &&
-                                          (mem_pkt->bank == (*p)->bank);
-
-                    bool same_row = mem_pkt->row == (*p)->row;
-                    got_more_hits |= same_rank_bank && same_row;
-                    got_bank_conflict |= same_rank_bank && !same_row;
+                if (p->row == mem_pkt->row) {
+                    got_more_hits = true;
+                    break;
                 }
-                ++p;
+                got_bank_conflict = true;
             }
 
             if (got_more_hits)
@@ -657,6 +666,7 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams &_p)
       maxAccessesPerRow(_p.max_accesses_per_row),
       timeStampOffset(0), activeRank(0),
       enableDRAMPowerdown(_p.enable_dram_powerdown),
+      lazyRefresh(_p.lazy_refresh),
       lastStatsResetTick(0),
       stats(*this)
 {
@@ -919,6 +929,14 @@ DRAMInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
 
 void DRAMInterface::setupRank(const uint8_t rank, const bool is_read)
 {
+    // the interface is not idle anymore, get all ranks to refresh as
+    // usual again
+    if (lazyRefresh) {
+        for (auto r : ranks) {
+            r->catchUpRefresh();
+        }
+    }
+
     // increment entry count of the rank based on packet type
     if (is_read) {
         ++ranks[rank]->readEntries;
@@ -1041,11 +1059,15 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     std::vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->pseudoChannel != pseudoChannel)
+    for (int i = 0; i < ranksPerChannel; i++) {
+        if (!ranks[i]->inRefIdleState())
             continue;
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
-            got_waiting[p->bankId] = true;
+        for (int j = 0; j < banksPerRank; j++) {
+            const auto* bank_queue =
+                queue.bankQueue(pseudoChannel, i * banksPerRank + j);
+            got_waiting[i * banksPerRank + j] =
+                bank_queue && !bank_queue->empty();
+        }
     }
 
     // Find command with optimal bank timing
@@ -1118,7 +1140,8 @@ DRAMInterface::Rank::Rank(const DRAMInterfaceParams &_p,
                          int _rank, DRAMInterface& _dram)
     : EventManager(&_dram), dram(_dram),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
-      pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
+      pwrStateTick(0), refreshDueAt(0), refreshSkipped(false),
+      pwrState(PWR_IDLE),
       refreshState(REF_IDLE), inLowPowerState(false), rank(_rank),
       readEntries(0), writeEntries(0), outstandingEvents(0),
       wakeUpAllowedAt(0), power(_p, false), banks(_p.banks_per_rank),
@@ -1167,10 +1190,12 @@ DRAMInterface::Rank::startup(Tick ref_tick)
 void
 DRAMInterface::Rank::suspend()
 {
+    catchUpRefresh();
+
     deschedule(refreshEvent);
 
     // Update the stats
-    updatePowerStats();
+    updatePowerStats(curTick());
 
     // don't automatically transition back to LP state after next REF
     pwrStatePostRefresh = PWR_IDLE;
@@ -1203,7 +1228,7 @@ DRAMInterface::Rank::checkDrainDone()
 }
 
 void
-DRAMInterface::Rank::flushCmdList()
+DRAMInterface::Rank::flushCmdList(Tick when)
 {
     // at the moment sort the list of commands and update the counters
     // for DRAMPower libray when doing a refresh
@@ -1213,19 +1238,19 @@ DRAMInterface::Rank::flushCmdList()
     // push to commands to DRAMPower
     for ( ; next_iter != cmdList.end() ; ++next_iter) {
          Command cmd = *next_iter;
-         if (cmd.timeStamp <= curTick()) {
-             // Move all commands at or before curTick to DRAMPower
+         if (cmd.timeStamp <= when) {
+             // Move all commands at or before when to DRAMPower
              power.powerlib.doCommand(cmd.type, cmd.bank,
                                       divCeil(cmd.timeStamp, dram.tCK) -
                                       dram.timeStampOffset);
          } else {
-             // done - found all commands at or before curTick()
-             // next_iter references the 1st command after curTick
+             // done - found all commands at or before when
+             // next_iter references the 1st command after when
              break;
          }
     }
-    // reset cmdList to only contain commands after curTick
-    // if there are no commands after curTick, updated cmdList will be empty
+    // reset cmdList to only contain commands after when
+    // if there are no commands after when, updated cmdList will be empty
     // in this case, next_iter is cmdList.end()
     cmdList.assign(next_iter, cmdList.end());
 }
@@ -1413,7 +1438,7 @@ DRAMInterface::Rank::processRefreshEvent()
         cmdList.push_back(Command(MemCommand::REF, 0, curTick()));
 
         // Update the stats
-        updatePowerStats();
+        updatePowerStats(curTick());
 
         DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(curTick(), dram.tCK) -
                 dram.timeStampOffset, rank);
@@ -1672,6 +1697,14 @@ DRAMInterface::Rank::processPowerEvent()
                            " rank %d\n", rank);
             dram.ctrl->restartScheduler(curTick(), dram.pseudoChannel);
         }
+
+        // if idle, stop refreshing until the interface is accessed
+        if (canSkipRefresh()) {
+            DPRINTF(DRAMState, "Rank %d idle, skipping refresh due at "
+                    "%llu\n", rank, refreshDueAt);
+            deschedule(refreshEvent);
+            refreshSkipped = true;
+        }
     }
 
     if ((pwrState == PWR_ACT) && (refreshState == REF_PD_EXIT)) {
@@ -1762,18 +1795,106 @@ DRAMInterface::Rank::processPowerEvent()
 
 }
 
+bool
+DRAMInterface::Rank::canSkipRefresh() const
+{
+    // with power-down enabled, idle ranks already stop refreshing once
+    // they enter self-refresh
+    if (!dram.lazyRefresh || dram.enableDRAMPowerdown)
+        return false;
+
+    // the next refresh must be a plain refresh of an idle rank, with no
+    // bank to close, power-down to exit, or command in flight
+    if (pwrState != PWR_IDLE || refreshState != REF_IDLE ||
+        pwrStatePostRefresh != PWR_IDLE || numBanksActive != 0 ||
+        outstandingEvents != 0 || !refreshEvent.scheduled() ||
+        powerEvent.scheduled() || activateEvent.scheduled() ||
+        prechargeEvent.scheduled() || wakeUpEvent.scheduled())
+        return false;
+
+    if (dram.ctrl->drainState() != DrainState::Running)
+        return false;
+
+    // requests to any rank of the interface could delay the refresh,
+    // so all of them must be done
+    for (auto r : dram.ranks) {
+        if (r->readEntries != 0 || r->writeEntries != 0)
+            return false;
+    }
+
+    return true;
+}
+
 void
-DRAMInterface::Rank::updatePowerStats()
+DRAMInterface::Rank::catchUpRefresh()
+{
+    if (!refreshSkipped)
+        return;
+
+    refreshSkipped = false;
+
+    // go through the refreshes the way processRefreshEvent and
+    // processPowerEvent do for an idle rank: the refresh starts when
+    // the event would have been scheduled, tRP ahead of the due time,
+    // and the rank is back in the idle power state after tRFC
+    Tick ref_at = refreshDueAt - dram.tRP;
+    while (ref_at < curTick()) {
+        stats.pwrStateTime[PWR_IDLE] += ref_at - pwrStateTick;
+        pwrState = PWR_REF;
+        pwrStateTick = ref_at;
+
+        Tick ref_done_at = ref_at + dram.tRFC;
+
+        for (auto &b : banks) {
+            b.actAllowedAt = ref_done_at;
+        }
+
+        cmdList.push_back(Command(MemCommand::REF, 0, ref_at));
+
+        // Update the stats at the time of the refresh, getting the
+        // same energy windows from DRAMPower
+        updatePowerStats(ref_at);
+
+        DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(ref_at, dram.tCK) -
+                dram.timeStampOffset, rank);
+
+        refreshDueAt = ref_at + dram.tREFI;
+
+        if (ref_done_at >= curTick()) {
+            // still refreshing, hand over to the refresh event loop
+            DPRINTF(DRAMState, "Rank %d caught up, refreshing until "
+                    "%llu\n", rank, ref_done_at);
+            pwrStateTrans = PWR_REF;
+            refreshState = REF_RUN;
+            ++outstandingEvents;
+            schedule(refreshEvent, ref_done_at);
+            return;
+        }
+
+        stats.pwrStateTime[PWR_REF] += dram.tRFC;
+        pwrState = PWR_IDLE;
+        pwrStateTick = ref_done_at;
+
+        ref_at = refreshDueAt - dram.tRP;
+    }
+
+    DPRINTF(DRAMState, "Rank %d caught up, next refresh at %llu\n",
+            rank, ref_at);
+    schedule(refreshEvent, ref_at);
+}
+
+void
+DRAMInterface::Rank::updatePowerStats(Tick when)
 {
     // All commands up to refresh have completed
     // flush cmdList to DRAMPower
-    flushCmdList();
+    flushCmdList(when);
 
     // Call the function that calculates window energy at intermediate update
     // events like at refresh, stats dump as well as at simulation exit.
     // Window starts at the last time the calcWindowEnergy function was called
     // and is upto current time.
-    power.powerlib.calcWindowEnergy(divCeil(curTick(), dram.tCK) -
+    power.powerlib.calcWindowEnergy(divCeil(when, dram.tCK) -
                                     dram.timeStampOffset);
 
     // Get the energy from DRAMPower
@@ -1801,7 +1922,7 @@ DRAMInterface::Rank::updatePowerStats()
     // power (mW) = ----------- * ----------
     //              time (tick)   tick_frequency
     stats.averagePower = (stats.totalEnergy.value() /
-                    (curTick() - dram.lastStatsResetTick)) *
+                    (when - dram.lastStatsResetTick)) *
                     (sim_clock::Frequency / 1000000000.0);
 }
 
@@ -1810,8 +1931,10 @@ DRAMInterface::Rank::computeStats()
 {
     DPRINTF(DRAM,"Computing stats due to a dump callback\n");
 
+    catchUpRefresh();
+
     // Update the stats
-    updatePowerStats();
+    updatePowerStats(curTick());
 
     // final update of power state times
     stats.pwrStateTime[pwrState] += (curTick() - pwrStateTick);
@@ -2014,6 +2137,10 @@ DRAMInterface::RankStats::regStats()
 void
 DRAMInterface::RankStats::resetStats()
 {
+    // account for the skipped refreshes before the reset, as if they
+    // had been performed
+    rank.catchUpRefresh();
+
     statistics::Group::resetStats();
 
     rank.resetStats();
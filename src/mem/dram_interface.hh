@@ -256,10 +256,27 @@ class DRAMInterface : public MemInterface
          */
         Tick refreshDueAt;
 
+        /**
+         * Set when the refresh events are not scheduled as the rank is
+         * idle, see catchUpRefresh(). The next refresh then starts at
+         * refreshDueAt - tRP, as if its event was scheduled.
+         */
+        bool refreshSkipped;
+
         /**
          * Function to update Power Stats
+         *
+         * @param when Tick up to which the commands and energy are
+         *             accounted for, no later than curTick()
+         */
+        void updatePowerStats(Tick when);
+
+        /**
+         * Check if the refresh events can stop, i.e. if lazy refresh is
+         * enabled, the rank just completed a refresh, is idle, and
+         * nothing is queued for the whole interface.
          */
-        void updatePowerStats();
+        bool canSkipRefresh() const;
 
         /**
          * Schedule a power state transition in the future, and
@@ -365,6 +382,16 @@ class DRAMInterface : public MemInterface
          */
         void suspend();
 
+        /**
+         * Bring the refresh and power state of a rank that stopped its
+         * refresh events while idle up to date. The refreshes that were
+         * due in the meantime are accounted for in one go, with the same
+         * commands, energy windows and power state times as if each of
+         * them had been performed, and the refresh events are scheduled
+         * again, possibly in the middle of a refresh.
+         */
+        void catchUpRefresh();
+
         /**
          * Check if there is no refresh and no preparation of refresh ongoing
          * i.e. the refresh state machine is in idle
@@ -410,11 +437,13 @@ class DRAMInterface : public MemInterface
 
         /**
          * Push command out of cmdList queue that are scheduled at
-         * or before curTick() to DRAMPower library
+         * or before a given tick to DRAMPower library
          * All commands before curTick are guaranteed to be complete
          * and can safely be flushed.
+         *
+         * @param when Tick up to which commands are flushed
          */
-        void flushCmdList();
+        void flushCmdList(Tick when);
 
         /**
          * Computes stats just prior to dump event
@@ -533,6 +562,12 @@ class DRAMInterface : public MemInterface
     /** Enable or disable DRAM powerdown states. */
     bool enableDRAMPowerdown;
 
+    /**
+     * Stop the refresh events of idle ranks while nothing is queued for
+     * the interface, and catch up with the refreshes on the next access.
+     */
+    bool lazyRefresh;
+
     /** The time when stats were last reset used to calculate average power */
     Tick lastStatsResetTick;
 
@@ -0,0 +1,186 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/fenwick_stack_dist_calc.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+/** Number of slots the table starts with. */
+const uint64_t initialSlots = 1024;
+
+} // anonymous namespace
+
+FenwickStackDistCalc::FenwickStackDistCalc(bool verify_stack)
+    : counts(initialSlots + 1, 0),
+      slotAddr(initialSlots),
+      live(initialSlots, false),
+      nextSlot(0),
+      numLive(0)
+{
+    if (verify_stack)
+        reference.reset(new StackDistCalc());
+}
+
+uint64_t
+FenwickStackDistCalc::countBefore(uint64_t slot) const
+{
+    uint64_t count = 0;
+    for (uint64_t i = slot; i > 0; i &= i - 1)
+        count += counts[i];
+    return count;
+}
+
+void
+FenwickStackDistCalc::addCount(uint64_t slot, int64_t delta)
+{
+    for (uint64_t i = slot + 1; i < counts.size(); i += i & -i)
+        counts[i] += delta;
+}
+
+void
+FenwickStackDistCalc::push(Addr addr, Entry &entry)
+{
+    if (nextSlot == live.size())
+        compact();
+
+    entry.slot = nextSlot++;
+    entry.isMarked = false;
+    slotAddr[entry.slot] = addr;
+    live[entry.slot] = true;
+    addCount(entry.slot, 1);
+    ++numLive;
+}
+
+void
+FenwickStackDistCalc::release(uint64_t slot)
+{
+    live[slot] = false;
+    addCount(slot, -1);
+    --numLive;
+}
+
+void
+FenwickStackDistCalc::compact()
+{
+    // Keep at least half of the table free, so compactions only
+    // happen after as many accesses as there are live slots
+    uint64_t size = live.size();
+    while (numLive * 2 > size)
+        size *= 2;
+
+    uint64_t slot = 0;
+    for (uint64_t i = 0; i < nextSlot; ++i) {
+        if (!live[i])
+            continue;
+        slotAddr[slot] = slotAddr[i];
+        aiMap.find(slotAddr[i])->second.slot = slot;
+        ++slot;
+    }
+    assert(slot == numLive);
+    nextSlot = numLive;
+
+    slotAddr.resize(size);
+    live.assign(size, false);
+    std::fill(live.begin(), live.begin() + numLive, true);
+
+    // Build the Fenwick tree in linear time by pushing the count of
+    // each node to its parent
+    counts.assign(size + 1, 0);
+    for (uint64_t i = 1; i <= numLive; ++i)
+        counts[i] = 1;
+    for (uint64_t i = 1; i <= size; ++i) {
+        const uint64_t parent = i + (i & -i);
+        if (parent <= size)
+            counts[parent] += counts[i];
+    }
+}
+
+std::pair<uint64_t, bool>
+FenwickStackDistCalc::calcStackDist(const Addr r_address, bool mark)
+{
+    std::pair<uint64_t, bool> result(Infinity, false);
+
+    auto ai = aiMap.find(r_address);
+    if (ai != aiMap.end()) {
+        result.first = distance(ai->second.slot);
+        result.second = ai->second.isMarked;
+        ai->second.isMarked = mark;
+    }
+
+    if (reference)
+        verify(r_address, result, reference->calcStackDist(r_address, mark));
+
+    return result;
+}
+
+std::pair<uint64_t, bool>
+FenwickStackDistCalc::calcStackDistAndUpdate(const Addr r_address,
+                                             bool addNewNode)
+{
+    std::pair<uint64_t, bool> result(Infinity, false);
+
+    auto ai = aiMap.find(r_address);
+    if (ai != aiMap.end()) {
+        result.first = distance(ai->second.slot);
+        result.second = ai->second.isMarked;
+        release(ai->second.slot);
+
+        if (addNewNode)
+            push(r_address, ai->second);
+        else
+            aiMap.erase(ai);
+    } else if (addNewNode) {
+        push(r_address, aiMap[r_address]);
+    }
+
+    if (reference) {
+        verify(r_address, result,
+               reference->calcStackDistAndUpdate(r_address, addNewNode));
+    }
+
+    return result;
+}
+
+void
+FenwickStackDistCalc::verify(Addr r_address,
+                             std::pair<uint64_t, bool> result,
+                             std::pair<uint64_t, bool> expected) const
+{
+    panic_if(result != expected,
+             "Expected stack-distance for address %#lx is %#lx (mark %d) "
+             "but found %#lx (mark %d)", r_address, expected.first,
+             expected.second, result.first, result.second);
+}
+
+} // namespace gem5
@@ -0,0 +1,155 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_FENWICK_STACK_DIST_CALC_HH__
+#define __MEM_FENWICK_STACK_DIST_CALC_HH__
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/stack_dist_calc.hh"
+
+namespace gem5
+{
+
+/**
+ * Stack distance calculator based on order statistics over access
+ * times, giving the same results as StackDistCalc.
+ *
+ * Every address in the stack gets a slot, allocated in increasing
+ * order at each access, so the stack distance of an address is the
+ * number of live slots after its own. The live slots are counted by a
+ * Fenwick tree stored in a flat array, and the slot of each address is
+ * found through a hash map, so an access only does a hash lookup and a
+ * couple of logarithmic walks over an array.
+ *
+ * Slots of the addresses removed from the stack are reclaimed by
+ * compacting the live slots once all slots were allocated, which also
+ * grows the table when more than half of it is live.
+ */
+class FenwickStackDistCalc
+{
+  public:
+    /**
+     * @param verify_stack Check every result against StackDistCalc,
+     *        which slows down the simulation considerably.
+     */
+    FenwickStackDistCalc(bool verify_stack = false);
+
+    /**
+     * A convenient way of refering to infinity.
+     */
+    static constexpr uint64_t Infinity = StackDistCalc::Infinity;
+
+    /**
+     * Get the stack distance of an address without updating the
+     * stack, and optionally mark the address.
+     *
+     * @param r_address The current address to process
+     * @param mark Value to set the mark flag of the address to.
+     * @return The stack distance of the address and its previous mark.
+     * @sa StackDistCalc::calcStackDist
+     */
+    std::pair<uint64_t, bool> calcStackDist(const Addr r_address,
+                                            bool mark = false);
+
+    /**
+     * Get the stack distance of an address, removing it from the
+     * stack, and push it on the top of the stack if addNewNode is set.
+     *
+     * @param r_address The current address to process
+     * @param addNewNode If true, the address is pushed on the stack
+     * @return The stack distance of the address and its mark flag.
+     * @sa StackDistCalc::calcStackDistAndUpdate
+     */
+    std::pair<uint64_t, bool> calcStackDistAndUpdate(const Addr r_address,
+                                                     bool addNewNode = true);
+
+  private:
+    /** Position of an address in the stack. */
+    struct Entry
+    {
+        uint64_t slot;
+        bool isMarked;
+    };
+
+    /** Number of live slots before the given one. */
+    uint64_t countBefore(uint64_t slot) const;
+
+    /** Add to the count of a slot in the Fenwick tree. */
+    void addCount(uint64_t slot, int64_t delta);
+
+    /** Number of addresses above the one using the given slot. */
+    uint64_t
+    distance(uint64_t slot) const
+    {
+        return numLive - countBefore(slot + 1);
+    }
+
+    /** Push an address on the top of the stack. */
+    void push(Addr addr, Entry &entry);
+
+    /** Free the slot of an address removed from the stack. */
+    void release(uint64_t slot);
+
+    /**
+     * Move the live slots to the start of the table, in order,
+     * growing the table if needed.
+     */
+    void compact();
+
+    /** Compare a result with the reference implementation. */
+    void verify(Addr r_address, std::pair<uint64_t, bool> result,
+                std::pair<uint64_t, bool> expected) const;
+
+    /** Slot and mark of the addresses in the stack. */
+    std::unordered_map<Addr, Entry> aiMap;
+
+    /** Fenwick tree of the live slot counts, indexed from 1. */
+    std::vector<uint64_t> counts;
+
+    /** Address using each slot. */
+    std::vector<Addr> slotAddr;
+
+    /** Whether each slot is used. */
+    std::vector<bool> live;
+
+    /** Next slot to allocate. */
+    uint64_t nextSlot;
+
+    /** Number of live slots, i.e., the size of the stack. */
+    uint64_t numLive;
+
+    /** Reference implementation, if verifying the results. */
+    std::unique_ptr<StackDistCalc> reference;
+};
+
+} // namespace gem5
+
+#endif //__MEM_FENWICK_STACK_DIST_CALC_HH__
@@ -0,0 +1,146 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "mem/fenwick_stack_dist_calc.hh"
+#include "mem/stack_dist_calc.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Synthetic cache line trace: mostly reuses of recently touched lines,
+ * with a geometric reuse distribution, mixed with streams of lines
+ * that were never touched before.
+ */
+class LineTrace
+{
+  private:
+    std::mt19937_64 rng;
+    std::geometric_distribution<uint64_t> reuse;
+    std::vector<Addr> touched;
+
+  public:
+    LineTrace(double mean_reuse)
+        : rng(0x5eed), reuse(1.0 / mean_reuse)
+    {}
+
+    Addr
+    next()
+    {
+        if (touched.empty() || rng() % 4 == 0) {
+            touched.push_back(touched.size() * 64);
+            return touched.back();
+        }
+        const uint64_t back = reuse(rng) % touched.size();
+        return touched[touched.size() - 1 - back];
+    }
+
+    uint64_t uniqueLines() const { return touched.size(); }
+
+    uint64_t random() { return rng(); }
+};
+
+} // anonymous namespace
+
+/** Both implementations agree on a trace with over a million lines. */
+TEST(FenwickStackDistCalcTest, MatchesTreeOnLargeTrace)
+{
+    StackDistCalc tree;
+    FenwickStackDistCalc fenwick;
+    LineTrace trace(50000);
+
+    for (int i = 0; i < 4200000; ++i) {
+        const Addr addr = trace.next();
+        ASSERT_EQ(fenwick.calcStackDistAndUpdate(addr),
+                  tree.calcStackDistAndUpdate(addr)) << "access " << i;
+    }
+    ASSERT_GT(trace.uniqueLines(), 1000000u);
+}
+
+/**
+ * Both implementations agree when the stack is also inspected, marked
+ * and shrunk, as done for writebacks and invalidations.
+ */
+TEST(FenwickStackDistCalcTest, MatchesTreeWithMarksAndRemovals)
+{
+    StackDistCalc tree;
+    FenwickStackDistCalc fenwick;
+    LineTrace trace(500);
+
+    for (int i = 0; i < 1000000; ++i) {
+        const Addr addr = trace.next();
+        switch (trace.random() % 8) {
+          case 0:
+            ASSERT_EQ(fenwick.calcStackDist(addr, true),
+                      tree.calcStackDist(addr, true)) << "access " << i;
+            break;
+          case 1:
+            ASSERT_EQ(fenwick.calcStackDist(addr, false),
+                      tree.calcStackDist(addr, false)) << "access " << i;
+            break;
+          case 2:
+            ASSERT_EQ(fenwick.calcStackDistAndUpdate(addr, false),
+                      tree.calcStackDistAndUpdate(addr, false))
+                << "access " << i;
+            break;
+          default:
+            ASSERT_EQ(fenwick.calcStackDistAndUpdate(addr),
+                      tree.calcStackDistAndUpdate(addr)) << "access " << i;
+        }
+    }
+}
+
+/** Stack distances of a small, hand-checked sequence. */
+TEST(FenwickStackDistCalcTest, Simple)
+{
+    FenwickStackDistCalc calc;
+    const uint64_t inf = FenwickStackDistCalc::Infinity;
+
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x0).first, inf);
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x40).first, inf);
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x80).first, inf);
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x0).first, 2u);
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x0).first, 0u);
+
+    // Mark a line, the mark is returned by the next access
+    ASSERT_EQ(calc.calcStackDist(0x40, true),
+              std::make_pair(uint64_t(2), false));
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x40),
+              std::make_pair(uint64_t(2), true));
+    ASSERT_EQ(calc.calcStackDist(0x40),
+              std::make_pair(uint64_t(0), false));
+
+    // Remove a line from the stack
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x80, false).first, 2u);
+    ASSERT_EQ(calc.calcStackDist(0x80).first, inf);
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x0).first, 1u);
+}
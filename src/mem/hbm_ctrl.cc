@@ -297,9 +297,9 @@ HBMCtrl::recvTimingReq(PacketPtr pkt)
                 return false;
             } else {
                 if (!addToReadQueue(pkt, pkt_count, pc0Int)) {
-                    if (!nextReqEvent.scheduled()) {
+                    if (!eventScheduled(nextReqEvent)) {
                         DPRINTF(MemCtrl, "Request scheduled immediately\n");
-                        schedule(nextReqEvent, curTick());
+                        scheduleEvent(nextReqEvent, curTick());
                     }
                 }
 
@@ -316,9 +316,9 @@ HBMCtrl::recvTimingReq(PacketPtr pkt)
                 return false;
             } else {
                 if (!addToReadQueue(pkt, pkt_count, pc1Int)) {
-                    if (!nextReqEventPC1.scheduled()) {
+                    if (!eventScheduled(nextReqEventPC1)) {
                         DPRINTF(MemCtrl, "Request scheduled immediately\n");
-                        schedule(nextReqEventPC1, curTick());
+                        scheduleEvent(nextReqEventPC1, curTick());
                     }
                 }
                 stats.readReqs++;
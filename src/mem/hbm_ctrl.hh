@@ -210,7 +210,7 @@ class HBMCtrl : public MemCtrl
      */
     bool respondEventPC1Scheduled() const
     {
-        return respondEventPC1.scheduled();
+        return eventScheduled(respondEventPC1);
     }
 
     /**
@@ -224,7 +224,7 @@ class HBMCtrl : public MemCtrl
             return MemCtrl::requestEventScheduled(pseudo_channel);
         } else {
             assert(pseudo_channel == 1);
-            return nextReqEventPC1.scheduled();
+            return eventScheduled(nextReqEventPC1);
         }
     }
 
@@ -240,7 +240,7 @@ class HBMCtrl : public MemCtrl
         if (pseudo_channel == 0) {
             MemCtrl::restartScheduler(tick);
         } else {
-            schedule(nextReqEventPC1, tick);
+            scheduleEvent(nextReqEventPC1, tick);
         }
     }
 
@@ -159,9 +159,9 @@ HeteroMemCtrl::recvTimingReq(PacketPtr pkt)
             addToWriteQueue(pkt, pkt_count, is_dram ? dram : nvm);
             // If we are not already scheduled to get a request out of the
             // queue, do so now
-            if (!nextReqEvent.scheduled()) {
+            if (!eventScheduled(nextReqEvent)) {
                 DPRINTF(MemCtrl, "Request scheduled immediately\n");
-                schedule(nextReqEvent, curTick());
+                scheduleEvent(nextReqEvent, curTick());
             }
             stats.writeReqs++;
             stats.bytesWrittenSys += size;
@@ -179,9 +179,9 @@ HeteroMemCtrl::recvTimingReq(PacketPtr pkt)
             if (!addToReadQueue(pkt, pkt_count, is_dram ? dram : nvm)) {
                 // If we are not already scheduled to get a request out of the
                 // queue, do so now
-                if (!nextReqEvent.scheduled()) {
+                if (!eventScheduled(nextReqEvent)) {
                     DPRINTF(MemCtrl, "Request scheduled immediately\n");
-                    schedule(nextReqEvent, curTick());
+                    scheduleEvent(nextReqEvent, curTick());
                 }
             }
             stats.readReqs++;
@@ -194,7 +194,7 @@ HeteroMemCtrl::recvTimingReq(PacketPtr pkt)
 
 void
 HeteroMemCtrl::processRespondEvent(MemInterface* mem_intr,
-                        MemPacketQueue& queue,
+                        std::deque<MemPacket*>& queue,
                         EventFunctionWrapper& resp_event,
                         bool& retry_rd_req)
 {
@@ -426,8 +426,8 @@ HeteroMemCtrl::drain()
 
         // the only queue that is not drained automatically over time
         // is the write queue, thus kick things into action if needed
-        if (!totalWriteQueueSize && !nextReqEvent.scheduled()) {
-            schedule(nextReqEvent, curTick());
+        if (!totalWriteQueueSize && !eventScheduled(nextReqEvent)) {
+            scheduleEvent(nextReqEvent, curTick());
         }
 
         dram->drainRanks();
@@ -82,6 +82,11 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     const bool expect_response = pkt->needsResponse() &&
         !pkt->cacheResponding();
 
+    // remember where to route the response to, before the packet is
+    // on its way
+    if (expect_response)
+        pushRoute(pkt, cpu_side_port_id);
+
     // since it is a normal request, attempt to send the packet
     bool success = memSidePorts[mem_side_port_id]->sendTimingReq(pkt);
 
@@ -89,6 +94,10 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         DPRINTF(HMCController, "recvTimingReq: src %s %s 0x%x RETRY\n",
                 src_port->name(), pkt->cmdString(), pkt->getAddr());
 
+        // the requestor gets its packet back as it was
+        if (expect_response)
+            popRoute(pkt);
+
         // restore the header delay as it is additive
         pkt->headerDelay = old_header_delay;
 
@@ -99,12 +108,6 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         return false;
     }
 
-    // remember where to route the response to
-    if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = cpu_side_port_id;
-    }
-
     reqLayers[mem_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
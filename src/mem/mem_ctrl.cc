@@ -40,6 +40,8 @@
 
 #include "mem/mem_ctrl.hh"
 
+#include <algorithm>
+
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/Drain.hh"
@@ -48,6 +50,7 @@
 #include "debug/QOS.hh"
 #include "mem/dram_interface.hh"
 #include "mem/mem_interface.hh"
+#include "mem/multi_channel_mem_ctrl.hh"
 #include "mem/nvm_interface.hh"
 #include "sim/system.hh"
 
@@ -65,6 +68,7 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
                          respondEvent, nextReqEvent, retryWrReq);}, name()),
     respondEvent([this] {processRespondEvent(dram, respQueue,
                          respondEvent, retryRdReq); }, name()),
+    multiChannel(nullptr), channelIndex(0),
     dram(p.dram),
     readBufferSize(dram->readBufferSize),
     writeBufferSize(dram->writeBufferSize),
@@ -97,7 +101,11 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
 void
 MemCtrl::init()
 {
-   if (!port.isConnected()) {
+    if (multiChannel) {
+        // the multi-channel controller takes care of the requests
+        fatal_if(port.isConnected(), "MemCtrl %s is a channel of %s and "
+                 "should not be connected\n", name(), multiChannel->name());
+    } else if (!port.isConnected()) {
         fatal("MemCtrl %s is unconnected!\n", name());
     } else {
         port.sendRangeChange();
@@ -445,9 +453,9 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
             addToWriteQueue(pkt, pkt_count, dram);
             // If we are not already scheduled to get a request out of the
             // queue, do so now
-            if (!nextReqEvent.scheduled()) {
+            if (!eventScheduled(nextReqEvent)) {
                 DPRINTF(MemCtrl, "Request scheduled immediately\n");
-                schedule(nextReqEvent, curTick());
+                scheduleEvent(nextReqEvent, curTick());
             }
             stats.writeReqs++;
             stats.bytesWrittenSys += size;
@@ -465,9 +473,9 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
             if (!addToReadQueue(pkt, pkt_count, dram)) {
                 // If we are not already scheduled to get a request out of the
                 // queue, do so now
-                if (!nextReqEvent.scheduled()) {
+                if (!eventScheduled(nextReqEvent)) {
                     DPRINTF(MemCtrl, "Request scheduled immediately\n");
-                    schedule(nextReqEvent, curTick());
+                    scheduleEvent(nextReqEvent, curTick());
                 }
             }
             stats.readReqs++;
@@ -480,7 +488,7 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
 
 void
 MemCtrl::processRespondEvent(MemInterface* mem_intr,
-                        MemPacketQueue& queue,
+                        std::deque<MemPacket*>& queue,
                         EventFunctionWrapper& resp_event,
                         bool& retry_rd_req)
 {
@@ -518,8 +526,8 @@ MemCtrl::processRespondEvent(MemInterface* mem_intr,
 
     if (!queue.empty()) {
         assert(queue.front()->readyTime >= curTick());
-        assert(!resp_event.scheduled());
-        schedule(resp_event, queue.front()->readyTime);
+        assert(!eventScheduled(resp_event));
+        scheduleEvent(resp_event, queue.front()->readyTime);
     } else {
         // if there is nothing left in any queue, signal a drain
         if (drainState() == DrainState::Draining &&
@@ -543,7 +551,7 @@ MemCtrl::processRespondEvent(MemInterface* mem_intr,
     // so if there is a read that was forced to wait, retry now
     if (retry_rd_req) {
         retry_rd_req = false;
-        port.sendRetryReq();
+        sendRetryReq();
     }
 }
 
@@ -637,7 +645,10 @@ MemCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency,
 
         // queue the packet in the response queue to be sent out after
         // the static latency has passed
-        port.schedTimingResp(pkt, response_time);
+        if (multiChannel)
+            multiChannel->schedTimingResp(pkt, response_time);
+        else
+            port.schedTimingResp(pkt, response_time);
     } else {
         // @todo the packet is going to be deleted, and the MemPacket
         // is still having a pointer to it
@@ -870,7 +881,7 @@ MemCtrl::nonDetermReads(MemInterface* mem_intr) {
 
 void
 MemCtrl::processNextReqEvent(MemInterface* mem_intr,
-                        MemPacketQueue& resp_queue,
+                        std::deque<MemPacket*>& resp_queue,
                         EventFunctionWrapper& resp_event,
                         EventFunctionWrapper& next_req_event,
                         bool& retry_wr_req) {
@@ -1005,11 +1016,11 @@ MemCtrl::processNextReqEvent(MemInterface* mem_intr,
             // Insert into response queue. It will be sent back to the
             // requestor at its readyTime
             if (resp_queue.empty()) {
-                assert(!resp_event.scheduled());
-                schedule(resp_event, mem_pkt->readyTime);
+                assert(!eventScheduled(resp_event));
+                scheduleEvent(resp_event, mem_pkt->readyTime);
             } else {
                 assert(resp_queue.back()->readyTime <= mem_pkt->readyTime);
-                assert(resp_event.scheduled());
+                assert(eventScheduled(resp_event));
             }
 
             resp_queue.push_back(mem_pkt);
@@ -1120,12 +1131,13 @@ MemCtrl::processNextReqEvent(MemInterface* mem_intr,
     }
     // It is possible that a refresh to another rank kicks things back into
     // action before reaching this point.
-    if (!next_req_event.scheduled())
-        schedule(next_req_event, std::max(mem_intr->nextReqTime, curTick()));
+    if (!eventScheduled(next_req_event))
+        scheduleEvent(next_req_event,
+                      std::max(mem_intr->nextReqTime, curTick()));
 
     if (retry_wr_req && totalWriteQueueSize < writeBufferSize) {
         retry_wr_req = false;
-        port.sendRetryReq();
+        sendRetryReq();
     }
 }
 
@@ -1406,8 +1418,8 @@ MemCtrl::drain()
 
         // the only queue that is not drained automatically over time
         // is the write queue, thus kick things into action if needed
-        if (!totalWriteQueueSize && !nextReqEvent.scheduled()) {
-            schedule(nextReqEvent, curTick());
+        if (!totalWriteQueueSize && !eventScheduled(nextReqEvent)) {
+            scheduleEvent(nextReqEvent, curTick());
         }
 
         dram->drainRanks();
@@ -1436,6 +1448,48 @@ MemCtrl::drainResume()
     isTimingMode = system()->isTimingMode();
 }
 
+int
+MemCtrl::multiChannelEvent(const EventFunctionWrapper& event) const
+{
+    if (!multiChannel)
+        return -1;
+    else if (&event == &nextReqEvent)
+        return 2 * channelIndex;
+    else if (&event == &respondEvent)
+        return 2 * channelIndex + 1;
+    else
+        return -1;
+}
+
+void
+MemCtrl::scheduleEvent(EventFunctionWrapper& event, Tick when)
+{
+    const int index = multiChannelEvent(event);
+    if (index >= 0)
+        multiChannel->scheduleEvent(index, when);
+    else
+        schedule(event, when);
+}
+
+bool
+MemCtrl::eventScheduled(const EventFunctionWrapper& event) const
+{
+    const int index = multiChannelEvent(event);
+    if (index >= 0)
+        return multiChannel->eventScheduled(index);
+    else
+        return event.scheduled();
+}
+
+void
+MemCtrl::sendRetryReq()
+{
+    if (multiChannel)
+        multiChannel->sendRetryReq();
+    else
+        port.sendRetryReq();
+}
+
 AddrRangeList
 MemCtrl::getAddrRanges()
 {
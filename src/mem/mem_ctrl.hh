@@ -55,6 +55,7 @@
 #include "base/callback.hh"
 #include "base/statistics.hh"
 #include "enums/MemSched.hh"
+#include "mem/mem_packet_queue.hh"
 #include "mem/qos/mem_ctrl.hh"
 #include "mem/qport.hh"
 #include "params/MemCtrl.hh"
@@ -69,6 +70,7 @@ namespace memory
 class MemInterface;
 class DRAMInterface;
 class NVMInterface;
+class MultiChannelMemCtrl;
 
 /**
  * A burst helper helps organize and manage a packet that is larger than
@@ -215,11 +217,6 @@ class MemPacket
 
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
-
-
 /**
  * The memory controller is a single-channel memory controller capturing
  * the most important timing constraints associated with a
@@ -245,6 +242,8 @@ typedef std::deque<MemPacket*> MemPacketQueue;
  */
 class MemCtrl : public qos::MemCtrl
 {
+    friend class MultiChannelMemCtrl;
+
   protected:
 
     // For now, make use of a queued response port to avoid dealing with
@@ -297,18 +296,63 @@ class MemCtrl : public qos::MemCtrl
      * in these methods
      */
     virtual void processNextReqEvent(MemInterface* mem_intr,
-                          MemPacketQueue& resp_queue,
+                          std::deque<MemPacket*>& resp_queue,
                           EventFunctionWrapper& resp_event,
                           EventFunctionWrapper& next_req_event,
                           bool& retry_wr_req);
     EventFunctionWrapper nextReqEvent;
 
     virtual void processRespondEvent(MemInterface* mem_intr,
-                        MemPacketQueue& queue,
+                        std::deque<MemPacket*>& queue,
                         EventFunctionWrapper& resp_event,
                         bool& retry_rd_req);
     EventFunctionWrapper respondEvent;
 
+    /**
+     * Multi-channel controller this controller is a channel of, if
+     * any. It then processes the request and response events, and
+     * owns the port used for the requests and responses.
+     */
+    MultiChannelMemCtrl* multiChannel;
+
+    /**
+     * Index of this controller among the channels of the multi-channel
+     * controller, if any
+     */
+    unsigned channelIndex;
+
+    /**
+     * Get the index of one of the controller events among the events
+     * of the multi-channel controller.
+     *
+     * @param event Event of this controller
+     * @return The event index, or -1 if the event is not handed over
+     */
+    int multiChannelEvent(const EventFunctionWrapper& event) const;
+
+    /**
+     * Schedule one of the controller events. The request and response
+     * events are handed over to the multi-channel controller if there
+     * is one.
+     *
+     * @param event Event to schedule
+     * @param when Tick when the event should be processed
+     */
+    void scheduleEvent(EventFunctionWrapper& event, Tick when);
+
+    /**
+     * Is one of the controller events scheduled?
+     *
+     * @param event Event to check
+     * @return true if the event is scheduled
+     */
+    bool eventScheduled(const EventFunctionWrapper& event) const;
+
+    /**
+     * Let the requestor know it can retry a rejected request
+     */
+    void sendRetryReq();
+
     /**
      * Check if the read queue has room for more entries
      *
@@ -723,7 +767,10 @@ class MemCtrl : public qos::MemCtrl
      *
      * @return true if event is scheduled
      */
-    bool respondEventScheduled() const { return respondEvent.scheduled(); }
+    bool respondEventScheduled() const
+    {
+        return eventScheduled(respondEvent);
+    }
 
     /**
      * Is there a read/write burst Event scheduled?
@@ -733,7 +780,7 @@ class MemCtrl : public qos::MemCtrl
     virtual bool requestEventScheduled(uint8_t pseudo_channel = 0) const
     {
         assert(pseudo_channel == 0);
-        return nextReqEvent.scheduled();
+        return eventScheduled(nextReqEvent);
     }
 
     /**
@@ -748,7 +795,7 @@ class MemCtrl : public qos::MemCtrl
     virtual void restartScheduler(Tick tick, uint8_t pseudo_channel = 0)
     {
         assert(pseudo_channel == 0);
-        schedule(nextReqEvent, tick);
+        scheduleEvent(nextReqEvent, tick);
     }
 
     /**
@@ -0,0 +1,114 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/mem_packet_queue.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/logging.hh"
+#include "mem/mem_ctrl.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+MemPacketQueue::MemPacketQueue()
+    : nodes(1, Node{nullptr, Sentinel, Sentinel}), freeNodes(Sentinel),
+      numPackets(0), nextSeq(0)
+{
+}
+
+MemPacketQueue::MemPacketQueue(const MemPacketQueue &other)
+    : MemPacketQueue()
+{
+    panic_if(!other.empty(), "Copying a non-empty memory packet queue");
+}
+
+void
+MemPacketQueue::push_back(MemPacket *pkt)
+{
+    uint32_t node = freeNodes;
+    if (node != Sentinel) {
+        freeNodes = nodes[node].next;
+    } else {
+        node = nodes.size();
+        nodes.emplace_back();
+    }
+
+    const uint32_t last = nodes[Sentinel].prev;
+    nodes[node] = Node{pkt, last, Sentinel};
+    nodes[last].next = node;
+    nodes[Sentinel].prev = node;
+    ++numPackets;
+
+    const uint64_t seq = nextSeq++;
+    if (!pkt->isDram())
+        return;
+
+    if (pkt->pseudoChannel >= banks.size())
+        banks.resize(pkt->pseudoChannel + 1);
+    auto &channel = banks[pkt->pseudoChannel];
+    if (pkt->bankId >= channel.size())
+        channel.resize(pkt->bankId + 1);
+    channel[pkt->bankId].push_back({seq, iterator(this, node)});
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::erase(iterator it)
+{
+    const MemPacket *pkt = *it;
+    if (pkt->isDram()) {
+        auto &bank_queue = banks[pkt->pseudoChannel][pkt->bankId];
+        auto entry = std::find_if(bank_queue.begin(), bank_queue.end(),
+            [it](const Entry &e) { return e.pkt == it; });
+        assert(entry != bank_queue.end());
+        bank_queue.erase(entry);
+    }
+
+    const uint32_t node = it.node;
+    const uint32_t next = nodes[node].next;
+    nodes[nodes[node].prev].next = next;
+    nodes[next].prev = nodes[node].prev;
+    nodes[node].next = freeNodes;
+    freeNodes = node;
+    --numPackets;
+
+    return iterator(this, next);
+}
+
+const MemPacketQueue::BankQueue *
+MemPacketQueue::bankQueue(uint8_t pseudo_channel, uint16_t bank_id) const
+{
+    if (pseudo_channel >= banks.size())
+        return nullptr;
+    const auto &channel = banks[pseudo_channel];
+    return bank_id < channel.size() ? &channel[bank_id] : nullptr;
+}
+
+} // namespace memory
+} // namespace gem5
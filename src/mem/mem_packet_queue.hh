@@ -0,0 +1,194 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_MEM_PACKET_QUEUE_HH__
+#define __MEM_MEM_PACKET_QUEUE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace gem5
+{
+
+namespace memory
+{
+
+class MemPacket;
+
+/**
+ * Queue of the memory packets of one QoS priority, in arrival order.
+ *
+ * The DRAM packets are also indexed by pseudo channel and bank id, with
+ * the packets of each bank kept in arrival order as well. This lets the
+ * FR-FCFS scheduler look at the oldest row hit and row miss of every
+ * bank instead of walking the whole queue, which otherwise dominates the
+ * controller cost with large read and write buffers. Every packet is
+ * given a sequence number when it is queued, so that the packets of
+ * different banks can still be ordered by age.
+ *
+ * The arrival order is a doubly linked list whose nodes are pooled in a
+ * vector and reused, so queueing a packet does not allocate once the
+ * queue has reached its largest size.
+ */
+class MemPacketQueue
+{
+  private:
+    /** Index of the sentinel node, which is the end of the list. */
+    static constexpr uint32_t Sentinel = 0;
+
+    struct Node
+    {
+        MemPacket *pkt;
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    template <class Queue, class Ref>
+    class Iterator
+    {
+      public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef MemPacket *value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::remove_reference_t<Ref> *pointer;
+        typedef Ref reference;
+
+        Iterator() : queue(nullptr), node(Sentinel) {}
+
+        reference operator*() const { return queue->nodes[node].pkt; }
+
+        Iterator &
+        operator++()
+        {
+            node = queue->nodes[node].next;
+            return *this;
+        }
+
+        Iterator
+        operator++(int)
+        {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        Iterator &
+        operator--()
+        {
+            node = queue->nodes[node].prev;
+            return *this;
+        }
+
+        Iterator
+        operator--(int)
+        {
+            Iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(const Iterator &o) const { return node == o.node; }
+        bool operator!=(const Iterator &o) const { return node != o.node; }
+
+      private:
+        friend class MemPacketQueue;
+
+        Iterator(Queue *_queue, uint32_t _node)
+            : queue(_queue), node(_node)
+        {}
+
+        Queue *queue;
+        uint32_t node;
+    };
+
+  public:
+    typedef Iterator<MemPacketQueue, MemPacket *&> iterator;
+    typedef Iterator<const MemPacketQueue, MemPacket *const &>
+        const_iterator;
+
+    /** A queued packet and its position in the arrival order. */
+    struct Entry
+    {
+        uint64_t seq;
+        iterator pkt;
+    };
+
+    /** The queued packets of a bank, oldest first. */
+    typedef std::vector<Entry> BankQueue;
+
+    MemPacketQueue();
+
+    /** The nodes refer to the queue, which cannot be copied once used. */
+    MemPacketQueue(const MemPacketQueue &other);
+    MemPacketQueue &operator=(const MemPacketQueue &other) = delete;
+
+    iterator begin() { return iterator(this, nodes[Sentinel].next); }
+    iterator end() { return iterator(this, Sentinel); }
+    const_iterator
+    begin() const
+    {
+        return const_iterator(this, nodes[Sentinel].next);
+    }
+    const_iterator end() const { return const_iterator(this, Sentinel); }
+
+    size_t size() const { return numPackets; }
+    bool empty() const { return numPackets == 0; }
+
+    void push_back(MemPacket *pkt);
+    iterator erase(iterator it);
+
+    /**
+     * Get the DRAM packets queued for a bank.
+     *
+     * @param pseudo_channel Pseudo channel of the bank
+     * @param bank_id Bank id, as in MemPacket::bankId
+     * @return The bank packets, or nullptr if none were ever queued
+     */
+    const BankQueue *bankQueue(uint8_t pseudo_channel,
+                               uint16_t bank_id) const;
+
+  private:
+    /** Nodes of the list, starting with the sentinel. */
+    std::vector<Node> nodes;
+
+    /** First node of the list of free nodes, or the sentinel if none. */
+    uint32_t freeNodes;
+
+    size_t numPackets;
+
+    /** DRAM packets of each bank, indexed by pseudo channel and bank id. */
+    std::vector<std::vector<BankQueue>> banks;
+
+    /** Sequence number of the next queued packet. */
+    uint64_t nextSeq;
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_MEM_PACKET_QUEUE_HH__
@@ -0,0 +1,239 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "mem/mem_ctrl.hh"
+#include "mem/mem_packet_queue.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+namespace
+{
+
+const unsigned BanksPerRank = 16;
+
+Tick tick = 0;
+
+/** Owns the memory packets of a test and the packet they wrap. */
+class Packets
+{
+  private:
+    std::unique_ptr<Packet> pkt;
+    std::vector<std::unique_ptr<MemPacket>> packets;
+
+  public:
+    Packets()
+    {
+        Gem5Internal::_curTickPtr = &tick;
+        pkt.reset(new Packet(std::make_shared<Request>(0, 64, 0, 0),
+                             MemCmd::ReadReq));
+    }
+
+    MemPacket *
+    dram(uint8_t channel, uint8_t rank, uint8_t bank, uint32_t row)
+    {
+        packets.emplace_back(new MemPacket(pkt.get(), true, true, channel,
+            rank, bank, row, rank * BanksPerRank + bank, 0, 64));
+        return packets.back().get();
+    }
+
+    MemPacket *
+    nvm(uint8_t bank)
+    {
+        packets.emplace_back(new MemPacket(pkt.get(), true, false, 0, 0,
+            bank, 0, bank, 0, 64));
+        return packets.back().get();
+    }
+};
+
+std::vector<MemPacket *>
+contents(const MemPacketQueue &queue)
+{
+    return std::vector<MemPacket *>(queue.begin(), queue.end());
+}
+
+std::vector<MemPacket *>
+contents(const MemPacketQueue::BankQueue *bank_queue)
+{
+    std::vector<MemPacket *> pkts;
+    if (bank_queue) {
+        for (const auto &entry : *bank_queue)
+            pkts.push_back(*entry.pkt);
+    }
+    return pkts;
+}
+
+} // anonymous namespace
+
+TEST(MemPacketQueueTest, ArrivalOrder)
+{
+    Packets packets;
+    MemPacketQueue queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.begin(), queue.end());
+
+    std::vector<MemPacket *> pkts;
+    for (int i = 0; i < 8; ++i) {
+        pkts.push_back(packets.dram(0, 0, i % 3, 0));
+        queue.push_back(pkts.back());
+    }
+    EXPECT_EQ(queue.size(), 8U);
+    EXPECT_EQ(contents(queue), pkts);
+
+    auto it = queue.end();
+    for (auto pkt = pkts.rbegin(); pkt != pkts.rend(); ++pkt)
+        EXPECT_EQ(*--it, *pkt);
+    EXPECT_EQ(it, queue.begin());
+}
+
+TEST(MemPacketQueueTest, Erase)
+{
+    Packets packets;
+    MemPacketQueue queue;
+    std::vector<MemPacket *> pkts;
+    for (int i = 0; i < 6; ++i) {
+        pkts.push_back(packets.dram(0, 0, 0, i));
+        queue.push_back(pkts.back());
+    }
+
+    // erase the second packet and check the next one is returned
+    auto it = std::next(queue.begin());
+    it = queue.erase(it);
+    EXPECT_EQ(*it, pkts[2]);
+    pkts.erase(pkts.begin() + 1);
+    EXPECT_EQ(contents(queue), pkts);
+    EXPECT_EQ(contents(queue.bankQueue(0, 0)), pkts);
+
+    // erase the last packet
+    it = queue.erase(std::prev(queue.end()));
+    EXPECT_EQ(it, queue.end());
+    pkts.pop_back();
+    EXPECT_EQ(contents(queue), pkts);
+
+    while (!queue.empty())
+        queue.erase(queue.begin());
+    EXPECT_EQ(queue.size(), 0U);
+    EXPECT_TRUE(contents(queue.bankQueue(0, 0)).empty());
+}
+
+/** Only the DRAM packets are indexed by pseudo channel and bank id. */
+TEST(MemPacketQueueTest, BankQueues)
+{
+    Packets packets;
+    MemPacketQueue queue;
+    MemPacket *a = packets.dram(0, 0, 3, 0);
+    MemPacket *b = packets.dram(0, 1, 3, 0);
+    MemPacket *c = packets.dram(1, 0, 3, 0);
+    MemPacket *d = packets.dram(0, 0, 3, 1);
+    MemPacket *e = packets.nvm(3);
+    for (MemPacket *pkt : { a, b, c, d, e })
+        queue.push_back(pkt);
+
+    EXPECT_EQ(contents(queue.bankQueue(0, 3)),
+              std::vector<MemPacket *>({ a, d }));
+    EXPECT_EQ(contents(queue.bankQueue(0, BanksPerRank + 3)),
+              std::vector<MemPacket *>({ b }));
+    EXPECT_EQ(contents(queue.bankQueue(1, 3)),
+              std::vector<MemPacket *>({ c }));
+    EXPECT_TRUE(contents(queue.bankQueue(0, 4)).empty());
+    EXPECT_EQ(queue.bankQueue(2, 3), nullptr);
+    EXPECT_EQ(queue.bankQueue(0, 2 * BanksPerRank), nullptr);
+    EXPECT_EQ(queue.size(), 5U);
+
+    // the sequence numbers order the packets of different banks by age
+    const auto *bank_a = queue.bankQueue(0, 3);
+    const auto *bank_b = queue.bankQueue(0, BanksPerRank + 3);
+    EXPECT_LT((*bank_a)[0].seq, (*bank_b)[0].seq);
+    EXPECT_LT((*bank_b)[0].seq, (*bank_a)[1].seq);
+}
+
+/** The nodes of the erased packets are reused by the next ones. */
+TEST(MemPacketQueueTest, NodeReuse)
+{
+    Packets packets;
+    MemPacketQueue queue;
+    std::deque<MemPacket *> reference;
+    std::mt19937 gen(1);
+
+    for (int i = 0; i < 10000; ++i) {
+        if (reference.size() < 32 && (reference.empty() || gen() % 2)) {
+            MemPacket *pkt =
+                packets.dram(0, gen() % 2, gen() % BanksPerRank, gen() % 4);
+            queue.push_back(pkt);
+            reference.push_back(pkt);
+        } else {
+            const int idx = gen() % reference.size();
+            queue.erase(std::next(queue.begin(), idx));
+            reference.erase(reference.begin() + idx);
+        }
+        ASSERT_EQ(queue.size(), reference.size());
+    }
+    EXPECT_EQ(contents(queue), std::vector<MemPacket *>(
+        reference.begin(), reference.end()));
+
+    for (unsigned bank_id = 0; bank_id < 2 * BanksPerRank; ++bank_id) {
+        std::vector<MemPacket *> expected;
+        for (MemPacket *pkt : reference) {
+            if (pkt->bankId == bank_id)
+                expected.push_back(pkt);
+        }
+        EXPECT_EQ(contents(queue.bankQueue(0, bank_id)), expected);
+    }
+}
+
+/**
+ * The QoS escalation queues a packet at another priority before
+ * erasing it from its own queue, so a packet can briefly be in two
+ * queues.
+ */
+TEST(MemPacketQueueTest, Escalation)
+{
+    Packets packets;
+    std::vector<MemPacketQueue> queues(2);
+    MemPacket *a = packets.dram(0, 0, 1, 0);
+    MemPacket *b = packets.dram(0, 0, 1, 1);
+    queues[0].push_back(a);
+    queues[0].push_back(b);
+
+    for (auto it = queues[0].begin(); it != queues[0].end();) {
+        queues[1].push_back(*it);
+        it = queues[0].erase(it);
+    }
+
+    EXPECT_TRUE(queues[0].empty());
+    EXPECT_TRUE(contents(queues[0].bankQueue(0, 1)).empty());
+    EXPECT_EQ(contents(queues[1]), std::vector<MemPacket *>({ a, b }));
+    EXPECT_EQ(contents(queues[1].bankQueue(0, 1)),
+              std::vector<MemPacket *>({ a, b }));
+}
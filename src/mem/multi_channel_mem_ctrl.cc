@@ -0,0 +1,261 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/multi_channel_mem_ctrl.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/MemCtrl.hh"
+#include "mem/mem_ctrl.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+MultiChannelMemCtrl::MultiChannelMemCtrl(const MultiChannelMemCtrlParams &p) :
+    SimObject(p),
+    port(name() + ".port", *this),
+    channels(p.channels), nextSeq(0), processing(false), retryReq(false),
+    channelEvent([this]{ processChannelEvents(); }, name()),
+    stats(*this)
+{
+    fatal_if(channels.empty(), "MultiChannelMemCtrl %s has no channels\n",
+             name());
+
+    for (unsigned i = 0; i < channels.size(); ++i) {
+        MemCtrl* ctrl = channels[i];
+        fatal_if(ctrl->multiChannel, "MemCtrl %s is a channel of both %s "
+                 "and %s\n", ctrl->name(), ctrl->multiChannel->name(),
+                 name());
+        ctrl->multiChannel = this;
+        ctrl->channelIndex = i;
+
+        for (const auto& range : ctrl->getAddrRanges()) {
+            fatal_if(channelMap.insert(range, ctrl) == channelMap.end(),
+                     "Range %s of MemCtrl %s overlaps another channel of "
+                     "%s\n", range.to_string(), ctrl->name(), name());
+        }
+
+        // take over the request and response events of the channel
+        channelEvents.push_back({&ctrl->nextReqEvent, MaxTick});
+        channelEvents.push_back({&ctrl->respondEvent, MaxTick});
+    }
+}
+
+void
+MultiChannelMemCtrl::init()
+{
+    if (!port.isConnected()) {
+        fatal("MultiChannelMemCtrl %s is unconnected!\n", name());
+    } else {
+        port.sendRangeChange();
+    }
+}
+
+Port &
+MultiChannelMemCtrl::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name != "port") {
+        return SimObject::getPort(if_name, idx);
+    } else {
+        return port;
+    }
+}
+
+MemCtrl*
+MultiChannelMemCtrl::findChannel(Addr addr) const
+{
+    auto it = channelMap.contains(addr);
+    panic_if(it == channelMap.end(), "Can't handle address range for "
+             "packet %#x\n", addr);
+    return it->second;
+}
+
+void
+MultiChannelMemCtrl::scheduleEvent(size_t index, Tick when)
+{
+    auto& ev = channelEvents[index];
+    panic_if(ev.when != MaxTick, "event %s of %s scheduled twice\n",
+             ev.event->name(), name());
+    assert(when >= curTick());
+
+    ev.when = when;
+    pendingEvents.push({when, nextSeq++, index});
+
+    // while processing, the shared event is scheduled once done
+    if (processing)
+        return;
+
+    if (!channelEvent.scheduled())
+        schedule(channelEvent, when);
+    else if (when < channelEvent.when())
+        reschedule(channelEvent, when);
+}
+
+void
+MultiChannelMemCtrl::processChannelEvents()
+{
+    processing = true;
+    stats.batches++;
+
+    // the events scheduled for now while processing go on top, as the
+    // most recently scheduled ones
+    while (!pendingEvents.empty() &&
+           pendingEvents.top().when == curTick()) {
+        auto& ev = channelEvents[pendingEvents.top().index];
+        pendingEvents.pop();
+
+        DPRINTF(MemCtrl, "Processing %s\n", ev.event->name());
+        ev.when = MaxTick;
+        stats.channelEvents++;
+        ev.event->process();
+    }
+
+    processing = false;
+    scheduleChannelEvent();
+}
+
+void
+MultiChannelMemCtrl::scheduleChannelEvent()
+{
+    if (!pendingEvents.empty())
+        schedule(channelEvent, pendingEvents.top().when);
+}
+
+void
+MultiChannelMemCtrl::sendRetryReq()
+{
+    if (retryReq) {
+        retryReq = false;
+        port.sendRetryReq();
+    }
+}
+
+Tick
+MultiChannelMemCtrl::recvAtomic(PacketPtr pkt)
+{
+    return findChannel(pkt->getAddr())->recvAtomic(pkt);
+}
+
+Tick
+MultiChannelMemCtrl::recvAtomicBackdoor(PacketPtr pkt,
+                                        MemBackdoorPtr &backdoor)
+{
+    return findChannel(pkt->getAddr())->recvAtomicBackdoor(pkt, backdoor);
+}
+
+void
+MultiChannelMemCtrl::recvFunctional(PacketPtr pkt)
+{
+    findChannel(pkt->getAddr())->recvFunctional(pkt);
+}
+
+bool
+MultiChannelMemCtrl::recvTimingReq(PacketPtr pkt)
+{
+    if (findChannel(pkt->getAddr())->recvTimingReq(pkt))
+        return true;
+
+    // the channel remembers to tell us when it has room
+    retryReq = true;
+    return false;
+}
+
+AddrRangeList
+MultiChannelMemCtrl::getAddrRanges() const
+{
+    AddrRangeList ranges;
+    for (auto ctrl : channels) {
+        for (const auto& range : ctrl->getAddrRanges())
+            ranges.push_back(range);
+    }
+    return ranges;
+}
+
+MultiChannelMemCtrl::MultiChannelStats::MultiChannelStats(
+        MultiChannelMemCtrl &ctrl)
+    : statistics::Group(&ctrl),
+
+    ADD_STAT(batches, statistics::units::Count::get(),
+             "Number of times the channel events were processed"),
+    ADD_STAT(channelEvents, statistics::units::Count::get(),
+             "Number of channel request and response events processed"),
+    ADD_STAT(avgChannelEvents, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Average number of channel events processed at once")
+{
+    avgChannelEvents.precision(2);
+    avgChannelEvents = channelEvents / batches;
+}
+
+MultiChannelMemCtrl::MemoryPort::
+MemoryPort(const std::string& name, MultiChannelMemCtrl& _ctrl)
+    : QueuedResponsePort(name, &_ctrl, queue), queue(_ctrl, *this, true),
+      ctrl(_ctrl)
+{ }
+
+AddrRangeList
+MultiChannelMemCtrl::MemoryPort::getAddrRanges() const
+{
+    return ctrl.getAddrRanges();
+}
+
+void
+MultiChannelMemCtrl::MemoryPort::recvFunctional(PacketPtr pkt)
+{
+    pkt->pushLabel(ctrl.name());
+
+    if (!queue.trySatisfyFunctional(pkt)) {
+        // the channel looks at its own queues and memory
+        ctrl.recvFunctional(pkt);
+    }
+
+    pkt->popLabel();
+}
+
+Tick
+MultiChannelMemCtrl::MemoryPort::recvAtomic(PacketPtr pkt)
+{
+    return ctrl.recvAtomic(pkt);
+}
+
+Tick
+MultiChannelMemCtrl::MemoryPort::recvAtomicBackdoor(
+        PacketPtr pkt, MemBackdoorPtr &backdoor)
+{
+    return ctrl.recvAtomicBackdoor(pkt, backdoor);
+}
+
+bool
+MultiChannelMemCtrl::MemoryPort::recvTimingReq(PacketPtr pkt)
+{
+    // pass it to the multi-channel controller
+    return ctrl.recvTimingReq(pkt);
+}
+
+} // namespace memory
+} // namespace gem5
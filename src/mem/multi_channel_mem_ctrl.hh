@@ -0,0 +1,261 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * MultiChannelMemCtrl declaration
+ */
+
+#ifndef __MEM_MULTI_CHANNEL_MEM_CTRL_HH__
+#define __MEM_MULTI_CHANNEL_MEM_CTRL_HH__
+
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "base/addr_range_map.hh"
+#include "base/statistics.hh"
+#include "mem/qport.hh"
+#include "params/MultiChannelMemCtrl.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+class MemCtrl;
+
+/**
+ * A memory controller for wide memory systems made of many channels.
+ * Each channel is an ordinary memory controller with its own queues,
+ * scheduling policy, memory interface and stats, but its port is left
+ * unconnected: the multi-channel controller receives all the requests
+ * on a single port, hands each of them to the channel holding its
+ * address, and sends the responses of all the channels back through a
+ * single response queue.
+ *
+ * The request and response events of the channels are processed by
+ * one event of the multi-channel controller, scheduled when the
+ * earliest of them is due. All the channel events due in a given tick
+ * are processed back to back, most recently scheduled first as the
+ * event queue would do, so that the event queue only sees one event
+ * per tick whatever the number of channels.
+ */
+class MultiChannelMemCtrl : public SimObject
+{
+  private:
+
+    class MemoryPort : public QueuedResponsePort
+    {
+
+        RespPacketQueue queue;
+        MultiChannelMemCtrl& ctrl;
+
+      public:
+
+        MemoryPort(const std::string& name, MultiChannelMemCtrl& _ctrl);
+
+      protected:
+
+        Tick recvAtomic(PacketPtr pkt) override;
+        Tick recvAtomicBackdoor(
+                PacketPtr pkt, MemBackdoorPtr &backdoor) override;
+
+        void recvFunctional(PacketPtr pkt) override;
+
+        bool recvTimingReq(PacketPtr) override;
+
+        AddrRangeList getAddrRanges() const override;
+
+    };
+
+    /**
+     * Our incoming port, shared by all the channels
+     */
+    MemoryPort port;
+
+    /**
+     * The channels, each one being a memory controller
+     */
+    std::vector<MemCtrl*> channels;
+
+    /**
+     * Channel of each address range, used to route the requests
+     */
+    AddrRangeMap<MemCtrl*> channelMap;
+
+    /**
+     * A request or response event of a channel, and when it is due
+     */
+    struct ChannelEvent
+    {
+        EventFunctionWrapper* event;
+        Tick when;
+    };
+
+    /**
+     * The events of all the channels, the request and response events
+     * of channel i being at index 2 * i and 2 * i + 1
+     */
+    std::vector<ChannelEvent> channelEvents;
+
+    /**
+     * A scheduled channel event. The sequence number orders the events
+     * due in the same tick, most recently scheduled first as the event
+     * queue would do.
+     */
+    struct PendingEvent
+    {
+        Tick when;
+        uint64_t seq;
+        size_t index;
+
+        /** The heap puts the greatest element, i.e. the next one, on top */
+        bool
+        operator<(const PendingEvent& other) const
+        {
+            return when > other.when ||
+                (when == other.when && seq < other.seq);
+        }
+    };
+
+    /**
+     * The scheduled channel events, next one first. A channel event
+     * is never descheduled, so it is in the heap until processed.
+     */
+    std::priority_queue<PendingEvent> pendingEvents;
+
+    /**
+     * Sequence number of the next channel event to be scheduled
+     */
+    uint64_t nextSeq;
+
+    /**
+     * Set while the channel events are processed, in which case the
+     * shared event is only rescheduled once they are all done
+     */
+    bool processing;
+
+    /**
+     * Remember if a channel rejected a request, in which case we have
+     * to retry when a channel has room again
+     */
+    bool retryReq;
+
+    /**
+     * Process all the channel events due in the current tick, and
+     * schedule the shared event for the next one.
+     */
+    void processChannelEvents();
+    EventFunctionWrapper channelEvent;
+
+    /**
+     * Schedule the shared event for the earliest channel event.
+     */
+    void scheduleChannelEvent();
+
+    /**
+     * Find the channel holding an address.
+     *
+     * @param addr The address to look up
+     * @return The channel holding the address
+     */
+    MemCtrl* findChannel(Addr addr) const;
+
+    struct MultiChannelStats : public statistics::Group
+    {
+        MultiChannelStats(MultiChannelMemCtrl &ctrl);
+
+        statistics::Scalar batches;
+        statistics::Scalar channelEvents;
+        statistics::Formula avgChannelEvents;
+    };
+
+    MultiChannelStats stats;
+
+  public:
+
+    MultiChannelMemCtrl(const MultiChannelMemCtrlParams &p);
+
+    void init() override;
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    /**
+     * Schedule the request or response event of a channel.
+     *
+     * @param index Index of the event among the channel events
+     * @param when Tick when the event should be processed
+     */
+    void scheduleEvent(size_t index, Tick when);
+
+    /**
+     * Is the request or response event of a channel scheduled?
+     *
+     * @param index Index of the event among the channel events
+     * @return true if the event is scheduled
+     */
+    bool
+    eventScheduled(size_t index) const
+    {
+        return channelEvents[index].when != MaxTick;
+    }
+
+    /**
+     * Queue the response of a channel to be sent out.
+     *
+     * @param pkt The response packet
+     * @param when Tick when the response should be sent
+     */
+    void schedTimingResp(PacketPtr pkt, Tick when)
+    {
+        port.schedTimingResp(pkt, when);
+    }
+
+    /**
+     * Let the requestor know it can retry a request, if one was
+     * rejected by a channel.
+     */
+    void sendRetryReq();
+
+  protected:
+
+    Tick recvAtomic(PacketPtr pkt);
+    Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
+    void recvFunctional(PacketPtr pkt);
+    bool recvTimingReq(PacketPtr pkt);
+    AddrRangeList getAddrRanges() const;
+
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif //__MEM_MULTI_CHANNEL_MEM_CTRL_HH__
@@ -62,6 +62,10 @@
 namespace gem5
 {
 
+// Pooling is enabled by Root, see Root.mem_pools.
+BlockPool Packet::pool("packet", 0, false);
+BlockPool Packet::dataPool("packetData", Packet::PooledDataSize, false);
+
 const MemCmd::CommandInfo
 MemCmd::commandInfo[] =
 {
@@ -53,6 +53,7 @@
 #include <list>
 
 #include "base/addr_range.hh"
+#include "base/block_pool.hh"
 #include "base/cast.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
@@ -350,6 +351,9 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The dynamic data was allocated from the data buffer pool
+        /// and is released to it when the packet is destroyed.
+        POOLED_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -357,7 +361,12 @@ class Packet : public Printable
 
         // Signal block present to squash prefetch and cache evict packets
         // through express snoop flag
-        BLOCK_CACHED          = 0x00010000
+        BLOCK_CACHED          = 0x00010000,
+
+        // The snoop is a back-invalidation of a snoop filter, which is
+        // not tracked by the crossbar and expects no response, or the
+        // write of a dirty line it back-invalidated
+        BACK_INVALIDATION     = 0x00020000
     };
 
     Flags flags;
@@ -383,6 +392,9 @@ class Packet : public Printable
     */
     PacketDataPtr data;
 
+    /** Largest payload allocated from the data buffer pool. */
+    static constexpr unsigned PooledDataSize = 64;
+
     /// The address of the request.  This address could be virtual or
     /// physical, depending on the system configuration.
     Addr addr;
@@ -418,6 +430,12 @@ class Packet : public Printable
 
   public:
 
+    /** @{ */
+    /** Pools of the packets and of their data buffers. */
+    static BlockPool pool;
+    static BlockPool dataPool;
+    /** @} */
+
     /**
      * The extra delay from seeing the packet until the header is
      * transmitted. This delay is used to communicate the crossbar
@@ -755,6 +773,11 @@ class Packet : public Printable
     void setBlockCached()          { flags.set(BLOCK_CACHED); }
     bool isBlockCached() const     { return flags.isSet(BLOCK_CACHED); }
     void clearBlockCached()        { flags.clear(BLOCK_CACHED); }
+    void setBackInvalidation()     { flags.set(BACK_INVALIDATION); }
+    bool isBackInvalidation() const
+    {
+        return flags.isSet(BACK_INVALIDATION);
+    }
 
     /**
      * QoS Value getter
@@ -1036,6 +1059,21 @@ class Packet : public Printable
         deleteData();
     }
 
+    /** @{ */
+    /** Packets are allocated from a pool when pooling is enabled. */
+    static void *
+    operator new(std::size_t size)
+    {
+        return pool.allocate(size);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        pool.deallocate(p, size);
+    }
+    /** @} */
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1327,10 +1365,12 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(POOLED_DATA))
+            dataPool.deallocate(data, PooledDataSize);
+        else if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|POOLED_DATA);
         data = NULL;
     }
 
@@ -1343,7 +1383,13 @@ class Packet : public Printable
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            if (getSize() <= PooledDataSize && dataPool.enabled()) {
+                flags.set(POOLED_DATA);
+                data = static_cast<uint8_t *>(
+                    dataPool.allocate(PooledDataSize));
+            } else {
+                data = new uint8_t[getSize()];
+            }
         }
     }
 
@@ -44,11 +44,15 @@
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "base/intmath.hh"
 #include "base/trace.hh"
@@ -76,15 +80,233 @@ namespace gem5
 namespace memory
 {
 
+namespace
+{
+
+/**
+ * Write a buffer to a gzip stream.
+ *
+ * @return False if the buffer could not be written.
+ */
+bool
+gzWriteAll(gzFile file, const uint8_t *data, uint64_t size)
+{
+    uint64_t pass_size = 0;
+
+    // gzwrite fails if (int)len < 0 (gzwrite returns int)
+    for (uint64_t written = 0; written < size; written += pass_size) {
+        pass_size = (uint64_t)INT_MAX < (size - written) ?
+            (uint64_t)INT_MAX : (size - written);
+
+        if (gzwrite(file, data + written,
+                    (unsigned int) pass_size) != (int) pass_size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Read a buffer from a gzip stream.
+ *
+ * @return False if the buffer could not be read entirely.
+ */
+bool
+gzReadAll(gzFile file, uint8_t *data, uint64_t size)
+{
+    uint64_t pass_size = 0;
+
+    for (uint64_t read = 0; read < size; read += pass_size) {
+        pass_size = (uint64_t)INT_MAX < (size - read) ?
+            (uint64_t)INT_MAX : (size - read);
+
+        if (gzread(file, data + read,
+                   (unsigned int) pass_size) != (int) pass_size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Check if a block of memory only holds zeros. */
+bool
+isZero(const uint8_t *data, uint64_t size)
+{
+    uint64_t i = 0;
+    for (; i + sizeof(long) <= size; i += sizeof(long)) {
+        if (*(const long*)(data + i) != 0)
+            return false;
+    }
+    for (; i < size; i++) {
+        if (data[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Write a block of memory to a gzip file. A sparse file starts with a
+ * bitmap of the pages of the block holding non-zero bytes, followed by
+ * the contents of these pages only.
+ *
+ * @param sparse_page_size Page size of a sparse file, 0 if dense.
+ * @return False if the file could not be written.
+ */
+bool
+writeCompressed(const std::string &filepath, const uint8_t *data,
+                uint64_t size, uint64_t sparse_page_size)
+{
+    gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
+    if (compressed_mem == NULL)
+        return false;
+
+    bool success = true;
+    if (sparse_page_size == 0) {
+        success = gzWriteAll(compressed_mem, data, size);
+    } else {
+        const uint64_t num_pages = divCeil(size, sparse_page_size);
+        std::vector<uint8_t> bitmap(divCeil(num_pages, 8), 0);
+        for (uint64_t page = 0; page < num_pages; page++) {
+            const uint64_t offset = page * sparse_page_size;
+            if (!isZero(data + offset,
+                        std::min(sparse_page_size, size - offset))) {
+                bitmap[page / 8] |= 1 << (page % 8);
+            }
+        }
+
+        success = gzWriteAll(compressed_mem, bitmap.data(), bitmap.size());
+        for (uint64_t page = 0; success && page < num_pages; page++) {
+            if (bitmap[page / 8] & (1 << (page % 8))) {
+                const uint64_t offset = page * sparse_page_size;
+                success = gzWriteAll(compressed_mem, data + offset,
+                    std::min(sparse_page_size, size - offset));
+            }
+        }
+    }
+
+    // close the compressed stream and check that the exit status
+    // is zero
+    return gzclose(compressed_mem) == 0 && success;
+}
+
+/**
+ * Read a block of memory from a gzip file, which the block is assumed
+ * to be zeroed before. A dense file may be shorter than the block, in
+ * which case the reading stops at its end. Only the pages present in a
+ * sparse file are written to, so the other pages of the block don't
+ * need to be backed by host memory.
+ *
+ * @param sparse_page_size Page size of a sparse file, 0 if dense.
+ * @return False if the file could not be read.
+ */
+bool
+readCompressed(const std::string &filepath, uint8_t *data, uint64_t size,
+               uint64_t sparse_page_size)
+{
+    const uint32_t chunk_size = 16384;
+
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        return false;
+
+    bool success = true;
+    if (sparse_page_size != 0) {
+        const uint64_t num_pages = divCeil(size, sparse_page_size);
+        std::vector<uint8_t> bitmap(divCeil(num_pages, 8));
+        success = gzReadAll(compressed_mem, bitmap.data(), bitmap.size());
+        for (uint64_t page = 0; success && page < num_pages; page++) {
+            if (bitmap[page / 8] & (1 << (page % 8))) {
+                const uint64_t offset = page * sparse_page_size;
+                success = gzReadAll(compressed_mem, data + offset,
+                    std::min(sparse_page_size, size - offset));
+            }
+        }
+        return gzclose(compressed_mem) == 0 && success;
+    }
+
+    uint64_t curr_size = 0;
+    long* temp_page = new long[chunk_size];
+    long* pmem_current;
+    uint32_t bytes_read;
+    while (curr_size < size) {
+        bytes_read = gzread(compressed_mem, temp_page,
+                            std::min<uint64_t>(chunk_size, size - curr_size));
+        if (bytes_read == 0)
+            break;
+
+        assert(bytes_read % sizeof(long) == 0);
+
+        for (uint32_t x = 0; x < bytes_read / sizeof(long); x++) {
+            // Only copy bytes that are non-zero, so we don't give
+            // the VM system hell
+            if (*(temp_page + x) != 0) {
+                pmem_current = (long*)(data + curr_size + x * sizeof(long));
+                *pmem_current = *(temp_page + x);
+            }
+        }
+        curr_size += bytes_read;
+    }
+
+    delete[] temp_page;
+
+    return gzclose(compressed_mem) == 0;
+}
+
+/**
+ * Run a number of independent jobs on a pool of threads, which pick
+ * the next job to run until all jobs have been run.
+ *
+ * @param num_threads Number of threads, 0 for one per host core.
+ * @param num_jobs Number of jobs.
+ * @param job Function running the given job, returning false on errors.
+ * @return The index of a failed job, or num_jobs if all jobs succeeded.
+ */
+size_t
+runJobs(unsigned num_threads, size_t num_jobs,
+        const std::function<bool(size_t)> &job)
+{
+    if (num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    num_threads = std::min<size_t>(num_threads, num_jobs);
+
+    std::atomic<size_t> next_job(0);
+    std::atomic<size_t> failed_job(num_jobs);
+    auto worker = [&]() {
+        for (size_t i = next_job++; i < num_jobs; i = next_job++) {
+            if (!job(i))
+                failed_job = i;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < num_threads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+        thread.join();
+
+    return failed_job;
+}
+
+} // anonymous namespace
+
 PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
                                const std::string& shared_backstore,
-                               bool auto_unlink_shared_backstore) :
+                               bool auto_unlink_shared_backstore,
+                               uint64_t cpt_chunk_size,
+                               unsigned cpt_threads,
+                               bool cpt_sparse) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
     sharedBackstore(shared_backstore), sharedBackstoreSize(0),
-    pageSize(sysconf(_SC_PAGE_SIZE))
+    pageSize(sysconf(_SC_PAGE_SIZE)), cptChunkSize(cpt_chunk_size),
+    cptThreads(cpt_threads), cptSparse(cpt_sparse)
 {
+    fatal_if(cptChunkSize % sizeof(long) != 0,
+             "The memory checkpoint chunk size must be a multiple of %d.",
+             sizeof(long));
+
     // Register cleanup callback if requested.
     if (auto_unlink_shared_backstore && !sharedBackstore.empty()) {
         registerExitCallback([=]() { shm_unlink(shared_backstore.c_str()); });
@@ -376,34 +598,42 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
 
-    // write memory file
-    std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
-    gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'\n",
-              filename);
-
-    uint64_t pass_size = 0;
+    // sparse files only hold the pages with non-zero bytes
+    uint64_t sparse_page_size = cptSparse ? pageSize : 0;
+    if (cptSparse)
+        SERIALIZE_SCALAR(sparse_page_size);
 
-    // gzwrite fails if (int)len < 0 (gzwrite returns int)
-    for (uint64_t written = 0; written < range.size();
-         written += pass_size) {
-        pass_size = (uint64_t)INT_MAX < (range.size() - written) ?
-            (uint64_t)INT_MAX : (range.size() - written);
-
-        if (gzwrite(compressed_mem, pmem + written,
-                    (unsigned int) pass_size) != (int) pass_size) {
+    if (cptChunkSize == 0 || range_size <= cptChunkSize) {
+        // write memory file
+        std::string filepath = CheckpointIn::dir() + "/" + filename;
+        if (!writeCompressed(filepath, pmem, range_size, sparse_page_size))
             fatal("Write failed on physical memory checkpoint file '%s'\n",
                   filename);
-        }
+        return;
     }
 
-    // close the compressed stream and check that the exit status
-    // is zero
-    if (gzclose(compressed_mem))
-        fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
-
+    // split the store in chunks which are compressed in parallel, and
+    // list the files of the chunks in the checkpoint
+    uint64_t chunk_size = cptChunkSize;
+    std::vector<std::string> chunk_files;
+    for (uint64_t offset = 0; offset < range_size; offset += chunk_size)
+        chunk_files.push_back(filename + "." +
+                              std::to_string(chunk_files.size()));
+
+    SERIALIZE_SCALAR(chunk_size);
+    SERIALIZE_CONTAINER(chunk_files);
+
+    size_t failed = runJobs(cptThreads, chunk_files.size(), [&](size_t i) {
+        uint64_t offset = i * chunk_size;
+        return writeCompressed(CheckpointIn::dir() + "/" + chunk_files[i],
+                               pmem + offset,
+                               std::min<uint64_t>(chunk_size,
+                                                  range_size - offset),
+                               sparse_page_size);
+    });
+    if (failed != chunk_files.size())
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              chunk_files[failed]);
 }
 
 void
@@ -434,19 +664,11 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
     std::string filename;
     UNSERIALIZE_SCALAR(filename);
-    std::string filepath = cp.getCptDir() + "/" + filename;
-
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
 
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
@@ -462,33 +684,38 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
-    uint64_t curr_size = 0;
-    long* temp_page = new long[chunk_size];
-    long* pmem_current;
-    uint32_t bytes_read;
-    while (curr_size < range.size()) {
-        bytes_read = gzread(compressed_mem, temp_page, chunk_size);
-        if (bytes_read == 0)
-            break;
-
-        assert(bytes_read % sizeof(long) == 0);
-
-        for (uint32_t x = 0; x < bytes_read / sizeof(long); x++) {
-            // Only copy bytes that are non-zero, so we don't give
-            // the VM system hell
-            if (*(temp_page + x) != 0) {
-                pmem_current = (long*)(pmem + curr_size + x * sizeof(long));
-                *pmem_current = *(temp_page + x);
-            }
-        }
-        curr_size += bytes_read;
+    // stores without a page size were written to dense files
+    uint64_t sparse_page_size = 0;
+    UNSERIALIZE_OPT_SCALAR(sparse_page_size);
+
+    // stores without a chunk size were written to a single file
+    uint64_t chunk_size = 0;
+    UNSERIALIZE_OPT_SCALAR(chunk_size);
+    if (chunk_size == 0) {
+        std::string filepath = cp.getCptDir() + "/" + filename;
+        if (!readCompressed(filepath, pmem, range_size, sparse_page_size))
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filename);
+        return;
     }
 
-    delete[] temp_page;
-
-    if (gzclose(compressed_mem))
-        fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+    std::vector<std::string> chunk_files;
+    UNSERIALIZE_CONTAINER(chunk_files);
+    fatal_if(chunk_files.size() != divCeil(range_size, chunk_size),
+             "Physical memory checkpoint %s has %d chunks, expected %d\n",
+             filename, chunk_files.size(), divCeil(range_size, chunk_size));
+
+    size_t failed = runJobs(cptThreads, chunk_files.size(), [&](size_t i) {
+        uint64_t offset = i * chunk_size;
+        return readCompressed(cp.getCptDir() + "/" + chunk_files[i],
+                              pmem + offset,
+                              std::min<uint64_t>(chunk_size,
+                                                 range_size - offset),
+                              sparse_page_size);
+    });
+    if (failed != chunk_files.size())
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              chunk_files[failed]);
 }
 
 } // namespace memory
@@ -158,6 +158,16 @@ class PhysicalMemory : public Serializable
 
     long pageSize;
 
+    // Size of the chunks each store is split into when checkpointing,
+    // or zero to write every store to a single file
+    const uint64_t cptChunkSize;
+
+    // Number of threads (de)compressing the chunks of a store
+    const unsigned cptThreads;
+
+    // Only checkpoint the pages holding non-zero bytes
+    const bool cptSparse;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -191,7 +201,10 @@ class PhysicalMemory : public Serializable
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
                    const std::string& shared_backstore,
-                   bool auto_unlink_shared_backstore);
+                   bool auto_unlink_shared_backstore,
+                   uint64_t cpt_chunk_size = 0,
+                   unsigned cpt_threads = 0,
+                   bool cpt_sparse = false);
 
     /**
      * Unmap all the backing store we have used.
@@ -275,7 +288,12 @@ class PhysicalMemory : public Serializable
     void serialize(CheckpointOut &cp) const override;
 
     /**
-     * Serialize a specific store.
+     * Serialize a specific store. The store is either written to a
+     * single file or, if a chunk size is set, split into chunks which
+     * are compressed in parallel and written to one file each. The
+     * files of the chunks are listed in the checkpoint section of the
+     * store. In sparse checkpoints, the files only hold the pages with
+     * non-zero bytes, along with a bitmap of these pages.
      *
      * @param store_id Unique identifier of this backing store
      * @param range The address range of this backing store
@@ -293,6 +311,9 @@ class PhysicalMemory : public Serializable
 
     /**
      * Unserialize a specific backing store, identified by a section.
+     * Both single-file and chunked stores are supported, and so are
+     * sparse stores, whose zero pages are not written to and thus stay
+     * unbacked when the store is mapped with MAP_NORESERVE.
      */
     void unserializeStore(CheckpointIn &cp);
 
@@ -0,0 +1,60 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.objects.BaseMemProbe import BaseMemProbe
+
+class ReuseDistProbe(BaseMemProbe):
+    """
+    Probe estimating reuse distances and the miss ratio curve of the
+    observed references using spatially hashed sampling (SHARDS). Unlike
+    StackDistProbe, the memory used is bounded by max_lines whatever the
+    footprint of the workload. The references the samples don't stand for
+    are counted at a reuse distance of 0 when the stats are dumped, as in
+    SHARDS-adj.
+    """
+    type = 'ReuseDistProbe'
+    cxx_header = "mem/probes/reuse_dist.hh"
+    cxx_class = 'gem5::ReuseDistProbe'
+
+    system = Param.System(Parent.any,
+                          "System to use when determining system cache "
+                          "line size")
+
+    line_size = Param.Unsigned(Parent.cache_line_size,
+                               "Cache line size in bytes (must be larger or "
+                               "equal to the system's line size)")
+
+    sampling_rate = Param.Float(0.01, "Initial fraction of the cache lines "
+                                "sampled")
+    max_lines = Param.Unsigned(8192, "Maximum number of sampled lines "
+                               "tracked, lowering the sampling rate when "
+                               "exceeded (0 for no limit)")
+
+    mrc_sizes = VectorParam.MemorySize(
+        ['64KiB', '128KiB', '256KiB', '512KiB', '1MiB', '2MiB', '4MiB',
+         '8MiB', '16MiB', '32MiB', '64MiB', '128MiB'],
+        "Cache sizes at which the miss ratio is estimated")
+
+    hist_bins = Param.Unsigned(32, "Bins in the reuse distance histogram")
@@ -100,12 +100,14 @@ MemFootprintProbe::handleRequest(const probing::PacketInfo &pi)
     if (!pi.cmd.isRequest() || !system->isMemAddr(pi.addr))
         return;
 
-    const Addr cl_addr = (pi.addr >> cacheLineSizeLg2) << cacheLineSizeLg2;
-    const Addr page_addr = (pi.addr >> pageSizeLg2) << pageSizeLg2;
-    insertAddr(cl_addr, &cacheLines, totalCacheLinesInMem);
-    insertAddr(cl_addr, &cacheLinesAll, totalCacheLinesInMem);
-    insertAddr(page_addr, &pages, totalPagesInMem);
-    insertAddr(page_addr, &pagesAll, totalPagesInMem);
+    // The sets hold line and page numbers, which keeps the keys of
+    // neighbouring lines and pages in the same bitmap chunks
+    const Addr cl_num = pi.addr >> cacheLineSizeLg2;
+    const Addr page_num = pi.addr >> pageSizeLg2;
+    insertAddr(cl_num, &cacheLines, totalCacheLinesInMem);
+    insertAddr(cl_num, &cacheLinesAll, totalCacheLinesInMem);
+    insertAddr(page_num, &pages, totalPagesInMem);
+    insertAddr(page_num, &pagesAll, totalPagesInMem);
 
     assert(cacheLines.size() <= cacheLinesAll.size());
     assert(pages.size() <= pagesAll.size());
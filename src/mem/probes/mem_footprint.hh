@@ -39,9 +39,8 @@
 #ifndef __MEM_PROBES_MEM_FOOTPRINT_HH__
 #define __MEM_PROBES_MEM_FOOTPRINT_HH__
 
-#include <unordered_set>
-
 #include "base/callback.hh"
+#include "base/sparse_bitset.hh"
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "sim/stats.hh"
@@ -57,7 +56,7 @@ struct MemFootprintProbeParams;
 class MemFootprintProbe : public BaseMemProbe
 {
   public:
-    typedef std::unordered_set<Addr> AddrSet;
+    typedef SparseBitSet AddrSet;
 
     MemFootprintProbe(const MemFootprintProbeParams &p);
     // Fix footprint tracking state on stat reset
@@ -71,6 +70,7 @@ class MemFootprintProbe : public BaseMemProbe
     const uint64_t totalCacheLinesInMem;
     const uint64_t totalPagesInMem;
 
+    /// Insert a cache line or page number in a set
     void insertAddr(Addr addr, AddrSet *set, uint64_t limit);
     void handleRequest(const probing::PacketInfo &pkt_info) override;
 
@@ -88,13 +88,15 @@ class MemFootprintProbe : public BaseMemProbe
         statistics::Scalar pageTotal;
     };
 
-    // Addr set to track unique cache lines accessed
+    // Set of the numbers of the unique cache lines accessed
     AddrSet cacheLines;
-    // Addr set to track unique cache lines accessed since simulation begin
+    // Set of the numbers of the unique cache lines accessed since
+    // simulation begin
     AddrSet cacheLinesAll;
-    // Addr set to track unique pages accessed
+    // Set of the numbers of the unique pages accessed
     AddrSet pages;
-    // Addr set to track unique pages accessed since simulation begin
+    // Set of the numbers of the unique pages accessed since simulation
+    // begin
     AddrSet pagesAll;
     System *system;
 
@@ -0,0 +1,155 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/probes/reuse_dist.hh"
+
+#include <cmath>
+#include <string>
+
+#include "base/intmath.hh"
+#include "params/ReuseDistProbe.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+ReuseDistProbe::ReuseDistProbe(const ReuseDistProbeParams &p)
+    : BaseMemProbe(p),
+      lineSize(p.line_size),
+      calc(p.sampling_rate, p.max_lines),
+      stats(this)
+{
+    fatal_if(p.system->cacheLineSize() > p.line_size,
+             "The reuse distance probe must use a cache line size that is "
+             "larger or equal to the system's cache line size.");
+
+    for (uint64_t size : p.mrc_sizes)
+        mrcLines.push_back(size / lineSize);
+}
+
+ReuseDistProbe::ReuseDistProbeStats::ReuseDistProbeStats(
+    ReuseDistProbe *parent)
+    : statistics::Group(parent),
+      probe(*parent),
+      ADD_STAT(refs, statistics::units::Count::get(),
+               "Number of references observed"),
+      ADD_STAT(sampledRefs, statistics::units::Count::get(),
+               "Number of references sampled"),
+      ADD_STAT(samplingRate, statistics::units::Ratio::get(),
+               "Current fraction of the cache lines sampled"),
+      ADD_STAT(reuseDistHist, statistics::units::Count::get(),
+               "Estimated reuse distances in cache lines"),
+      ADD_STAT(coldRefs, statistics::units::Count::get(),
+               "Estimated number of first references to a cache line"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Estimated misses of a fully associative LRU cache"),
+      ADD_STAT(missRatio, statistics::units::Ratio::get(),
+               "Estimated miss ratio of a fully associative LRU cache")
+{
+    using namespace statistics;
+
+    const ReuseDistProbeParams &p =
+        dynamic_cast<const ReuseDistProbeParams &>(parent->params());
+
+    samplingRate.functor([parent]{ return parent->calc.samplingRate(); });
+
+    reuseDistHist
+        .init(p.hist_bins)
+        .flags(pdf);
+
+    misses
+        .init(p.mrc_sizes.size())
+        .flags(nozero);
+
+    for (int i = 0; i < p.mrc_sizes.size(); ++i) {
+        const uint64_t size = p.mrc_sizes[i];
+        std::string name;
+        if (size % (1 << 20) == 0)
+            name = std::to_string(size >> 20) + "MiB";
+        else if (size % (1 << 10) == 0)
+            name = std::to_string(size >> 10) + "KiB";
+        else
+            name = std::to_string(size) + "B";
+        misses.subname(i, name);
+    }
+
+    missRatio = misses / refs;
+}
+
+void
+ReuseDistProbe::ReuseDistProbeStats::resetStats()
+{
+    statistics::Group::resetStats();
+
+    probe.calc.resetAdjustment();
+    adjustment = 0;
+}
+
+void
+ReuseDistProbe::ReuseDistProbeStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    // Bring the references added at a distance of 0 up to date, which
+    // leaves the misses unchanged
+    const int target = std::lround(probe.calc.adjustment());
+    if (target != adjustment) {
+        reuseDistHist.sample(0, target - adjustment);
+        adjustment = target;
+    }
+}
+
+void
+ReuseDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
+{
+    // only capturing read and write requests (which allocate in the
+    // cache)
+    if (!pkt_info.cmd.isRead() && !pkt_info.cmd.isWrite())
+        return;
+
+    stats.refs++;
+
+    ShardsCalc::Sample sample;
+    if (!calc.access(roundDown(pkt_info.addr, lineSize), sample))
+        return;
+
+    stats.sampledRefs++;
+
+    if (sample.distance == ShardsCalc::Infinity) {
+        stats.coldRefs += sample.weight;
+    } else {
+        // Histograms count whole samples, so this rounds the number of
+        // references each sample stands for
+        stats.reuseDistHist.sample(sample.distance,
+                                   std::lround(sample.weight));
+    }
+
+    for (int i = 0; i < mrcLines.size(); ++i) {
+        if (sample.distance >= mrcLines[i])
+            stats.misses[i] += sample.weight;
+    }
+}
+
+} // namespace gem5
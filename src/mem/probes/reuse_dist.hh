@@ -0,0 +1,105 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_PROBES_REUSE_DIST_HH__
+#define __MEM_PROBES_REUSE_DIST_HH__
+
+#include <vector>
+
+#include "mem/packet.hh"
+#include "mem/probes/base.hh"
+#include "mem/shards_calc.hh"
+#include "sim/stats.hh"
+
+namespace gem5
+{
+
+struct ReuseDistProbeParams;
+
+/**
+ * Probe estimating the reuse distances of the observed references,
+ * and the miss ratio of fully associative LRU caches of various sizes,
+ * from a bounded sample of the cache lines.
+ *
+ * The references the samples don't stand for are counted at a reuse
+ * distance of 0 in the histogram when the stats are dumped, so that
+ * the histogram and the miss ratios are relative to all the references
+ * observed (SHARDS-adj), see ShardsCalc.
+ */
+class ReuseDistProbe : public BaseMemProbe
+{
+  public:
+    ReuseDistProbe(const ReuseDistProbeParams &params);
+
+  protected:
+    void handleRequest(const probing::PacketInfo &pkt_info) override;
+
+  protected:
+    // Cache line size to simulate
+    const unsigned lineSize;
+
+    // Sizes of the caches in lines, for the miss ratio curve
+    std::vector<uint64_t> mrcLines;
+
+    ShardsCalc calc;
+
+    struct ReuseDistProbeStats : public statistics::Group
+    {
+        ReuseDistProbeStats(ReuseDistProbe *parent);
+
+        void resetStats() override;
+        void preDumpStats() override;
+
+        ReuseDistProbe &probe;
+
+        // References added to the histogram at a distance of 0
+        int adjustment = 0;
+
+        // Number of references observed
+        statistics::Scalar refs;
+
+        // Number of references sampled
+        statistics::Scalar sampledRefs;
+
+        // Current sampling rate of the cache lines
+        statistics::Value samplingRate;
+
+        // Estimated reuse distances, in cache lines
+        statistics::Histogram reuseDistHist;
+
+        // Estimated number of first references to a line
+        statistics::Scalar coldRefs;
+
+        // Estimated misses for each cache size
+        statistics::Vector misses;
+
+        // Estimated miss ratio for each cache size
+        statistics::Formula missRatio;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif //__MEM_PROBES_REUSE_DIST_HH__
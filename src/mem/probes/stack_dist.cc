@@ -108,7 +108,7 @@ StackDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
 
     // Calculate the stack distance
     const uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
-    if (sd == StackDistCalc::Infinity) {
+    if (sd == FenwickStackDistCalc::Infinity) {
         stats.infiniteSD++;
         return;
     }
@@ -38,9 +38,9 @@
 #ifndef __MEM_PROBES_STACK_DIST_HH__
 #define __MEM_PROBES_STACK_DIST_HH__
 
+#include "mem/fenwick_stack_dist_calc.hh"
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
-#include "mem/stack_dist_calc.hh"
 #include "sim/stats.hh"
 
 namespace gem5
@@ -67,7 +67,7 @@ class StackDistProbe : public BaseMemProbe
     const bool disableLogHists;
 
   protected:
-    StackDistCalc calc;
+    FenwickStackDistCalc calc;
 
     struct StackDistProbeStats : public statistics::Group
     {
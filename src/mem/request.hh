@@ -54,9 +54,11 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
+#include "base/block_pool.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
 #include "base/types.hh"
@@ -1100,8 +1102,27 @@ class Request
     bool isCacheInvalidate() const { return _flags.isSet(INVALIDATE); }
     bool isCacheMaintenance() const { return _flags.isSet(CLEAN|INVALIDATE); }
     /** @} */
+
+    /** Pool of the requests created with allocRequest(). */
+    static BlockPool pool;
 };
 
+/**
+ * Create a request, from the request pool when pooling is enabled. This
+ * is meant for the requests created for every access, e.g., by the
+ * caches for writebacks and snoops.
+ *
+ * @param args Arguments of the constructor of the request.
+ */
+template <class... Args>
+RequestPtr
+allocRequest(Args&&... args)
+{
+    return std::allocate_shared<Request>(
+        BlockPoolAllocator<Request>(Request::pool),
+        std::forward<Args>(args)...);
+}
+
 } // namespace gem5
 
 #endif // __MEM_REQUEST_HH__
@@ -37,6 +37,7 @@
 
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
+#include "mem/ruby/network/garnet/PortMask.hh"
 #include "mem/ruby/network/garnet/flitBuffer.hh"
 
 namespace gem5
@@ -63,6 +64,7 @@ class CrossbarSwitch : public Consumer
     update_sw_winner(int inport, flit *t_flit)
     {
         switchBuffers[inport].insert(t_flit);
+        m_busy_inports.set(inport);
     }
 
     inline double get_crossbar_activity() { return m_crossbar_activity; }
@@ -75,6 +77,9 @@ class CrossbarSwitch : public Consumer
     int m_num_vcs;
     double m_crossbar_activity;
     std::vector<flitBuffer> switchBuffers;
+
+    // Inports with a flit in their switch buffer
+    PortMask m_busy_inports;
 };
 
 } // namespace garnet
@@ -116,6 +116,9 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
+        // the router stops looking at this inport once it is empty
+        if (--m_num_buffered_flits == 0)
+            m_router->getActiveInports().clear(m_id);
         return virtualChannels[vc].getTopFlit();
     }
 
@@ -167,6 +170,9 @@ class InputUnit : public Consumer
     // Input Virtual channels
     std::vector<VirtualChannel> virtualChannels;
 
+    // Number of flits buffered in all the VCs
+    int m_num_buffered_flits;
+
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
@@ -112,7 +112,7 @@ NetworkBridge::scheduleFlit(flit *t_flit, Cycles latency)
     t_flit->set_time(sendTime);
     lastScheduledAt = sendTime;
     linkBuffer.insert(t_flit);
-    link_consumer->scheduleEventAbsolute(sendTime);
+    wakeupConsumer(sendTime);
 }
 
 void
@@ -50,7 +50,8 @@ NetworkLink::NetworkLink(const Params &p)
       m_type(NUM_LINK_TYPES_),
       m_latency(p.link_latency), m_link_utilized(0),
       m_virt_nets(p.virt_nets), linkBuffer(),
-      link_consumer(nullptr), link_srcQueue(nullptr)
+      link_consumer(nullptr), link_srcQueue(nullptr),
+      m_consumer_ports(nullptr), m_consumer_port(-1)
 {
     int num_vnets = (p.supported_vnets).size();
     mVnets.resize(num_vnets);
@@ -66,6 +67,13 @@ NetworkLink::setLinkConsumer(Consumer *consumer)
     link_consumer = consumer;
 }
 
+void
+NetworkLink::setConsumerPort(PortMask *pending_ports, int port)
+{
+    m_consumer_ports = pending_ports;
+    m_consumer_port = port;
+}
+
 void
 NetworkLink::setVcsPerVnet(uint32_t consumerVcs)
 {
@@ -99,7 +107,7 @@ NetworkLink::wakeup()
         }
         t_flit->set_time(clockEdge(m_latency));
         linkBuffer.insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
+        wakeupConsumer(clockEdge(m_latency));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
     }
@@ -38,6 +38,7 @@
 
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
+#include "mem/ruby/network/garnet/PortMask.hh"
 #include "mem/ruby/network/garnet/flitBuffer.hh"
 #include "params/NetworkLink.hh"
 #include "sim/clocked_object.hh"
@@ -61,6 +62,7 @@ class NetworkLink : public ClockedObject, public Consumer
     ~NetworkLink() = default;
 
     void setLinkConsumer(Consumer *consumer);
+    void setConsumerPort(PortMask *pending_ports, int port);
     void setSourceQueue(flitBuffer *src_queue, ClockedObject *srcClockObject);
     virtual void setVcsPerVnet(uint32_t consumerVcs);
     void setType(link_type type) { m_type = type; }
@@ -104,6 +106,20 @@ class NetworkLink : public ClockedObject, public Consumer
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
 
+    // Ports of the consumer with something on their link, if it keeps
+    // track of them, and the port this link is connected to
+    PortMask *m_consumer_ports;
+    int m_consumer_port;
+
+    // Wake up the consumer when the flit just inserted is due
+    void
+    wakeupConsumer(Tick when)
+    {
+        if (m_consumer_ports)
+            m_consumer_ports->set(m_consumer_port);
+        link_consumer->scheduleEventAbsolute(when);
+    }
+
 };
 
 } // namespace garnet
@@ -134,6 +134,9 @@ OutputUnit::wakeup()
 {
     if (m_credit_link->isReady(curTick())) {
         Credit *t_credit = (Credit*) m_credit_link->consumeLink();
+        if (m_credit_link->getBuffer()->isEmpty())
+            m_router->getPendingOutports().clear(m_id);
+
         increment_credit(t_credit->get_vc());
 
         if (t_credit->is_free_signal())
@@ -35,7 +35,6 @@
 #include <iostream>
 #include <vector>
 
-#include "base/compiler.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
 #include "mem/ruby/network/garnet/NetworkLink.hh"
@@ -108,7 +107,7 @@ class OutputUnit : public Consumer
 
   private:
     Router *m_router;
-    GEM5_CLASS_VAR_USED int m_id;
+    int m_id;
     PortDirection m_direction;
     int m_vc_per_vnet;
     NetworkLink *m_out_link;
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 The gem5 authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_0_PORTMASK_HH__
+#define __MEM_RUBY_NETWORK_GARNET_0_PORTMASK_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+namespace garnet
+{
+
+// A set of router ports, stored as a bitmask, used to only visit the
+// ports that have something to do. The ports of a set are visited in
+// increasing order with:
+//     for (int port = mask.first(); port >= 0; port = mask.next(port))
+// and the visited port may be removed from the set within the loop.
+class PortMask
+{
+  public:
+    // Make room for a number of ports, keeping the current ones
+    void resize(int num_ports) { m_words.resize((num_ports + 63) / 64); }
+
+    void set(int port) { m_words[port / 64] |= bit(port); }
+    void clear(int port) { m_words[port / 64] &= ~bit(port); }
+    bool test(int port) const { return m_words[port / 64] & bit(port); }
+
+    int first() const { return findFrom(0); }
+    int next(int port) const { return findFrom(port + 1); }
+
+  private:
+    static uint64_t bit(int port) { return 1ULL << (port % 64); }
+
+    // First port of the set at or after the given one, -1 if none
+    int
+    findFrom(int port) const
+    {
+        int word = port / 64;
+        if (word >= m_words.size())
+            return -1;
+
+        uint64_t bits = m_words[word] & (~0ULL << (port % 64));
+        while (!bits) {
+            if (++word == m_words.size())
+                return -1;
+            bits = m_words[word];
+        }
+        return word * 64 + ctz64(bits);
+    }
+
+    std::vector<uint64_t> m_words;
+};
+
+} // namespace garnet
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_NETWORK_GARNET_0_PORTMASK_HH__
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 The gem5 authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "mem/ruby/network/garnet/PortMask.hh"
+
+using namespace gem5::ruby::garnet;
+
+namespace
+{
+
+std::vector<int>
+ports(const PortMask &mask)
+{
+    std::vector<int> result;
+    for (int port = mask.first(); port >= 0; port = mask.next(port))
+        result.push_back(port);
+    return result;
+}
+
+} // anonymous namespace
+
+/** An empty set, or one with no port past the last visited, ends in -1. */
+TEST(PortMaskTest, EndMarker)
+{
+    PortMask mask;
+    EXPECT_EQ(mask.first(), -1);
+
+    mask.resize(5);
+    EXPECT_EQ(mask.first(), -1);
+
+    mask.set(4);
+    EXPECT_EQ(mask.first(), 4);
+    EXPECT_EQ(mask.next(4), -1);
+
+    mask.resize(64);
+    mask.set(63);
+    EXPECT_EQ(mask.next(4), 63);
+    EXPECT_EQ(mask.next(63), -1);
+}
+
+/** Sets of more than 64 ports span several words. */
+TEST(PortMaskTest, ManyPorts)
+{
+    PortMask mask;
+    mask.resize(200);
+    const std::vector<int> set_ports = { 0, 1, 63, 64, 65, 127, 128, 199 };
+    for (int port : set_ports)
+        mask.set(port);
+
+    EXPECT_EQ(ports(mask), set_ports);
+    EXPECT_TRUE(mask.test(64));
+    EXPECT_FALSE(mask.test(66));
+    EXPECT_FALSE(mask.test(126));
+    EXPECT_EQ(mask.next(65), 127);
+    EXPECT_EQ(mask.next(199), -1);
+
+    // Growing the set keeps its ports
+    mask.resize(300);
+    mask.set(256);
+    EXPECT_EQ(mask.next(199), 256);
+    EXPECT_EQ(mask.next(256), -1);
+}
+
+/**
+ * The visited port, and the ports already visited or still to visit,
+ * may be removed from the set within the loop.
+ */
+TEST(PortMaskTest, ClearWhileIterating)
+{
+    PortMask mask;
+    mask.resize(130);
+    for (int port = 0; port < 130; port += 3)
+        mask.set(port);
+
+    std::vector<int> visited;
+    for (int port = mask.first(); port >= 0; port = mask.next(port)) {
+        visited.push_back(port);
+        mask.clear(port);
+        // Skip the next port of the set in the same word, if any
+        if (port + 3 < 130 && (port + 3) / 64 == port / 64)
+            mask.clear(port + 3);
+    }
+
+    std::vector<int> expected;
+    for (int port = 0; port < 130; port += 3) {
+        if (expected.empty() || expected.back() + 3 != port ||
+            port / 64 != expected.back() / 64) {
+            expected.push_back(port);
+        }
+    }
+    EXPECT_EQ(visited, expected);
+    EXPECT_EQ(mask.first(), -1);
+
+    // Clearing a port that is not set leaves the set unchanged
+    mask.set(100);
+    mask.clear(101);
+    EXPECT_EQ(ports(mask), std::vector<int>({ 100 }));
+}
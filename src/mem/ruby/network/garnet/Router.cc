@@ -74,8 +74,9 @@ Router::wakeup()
     DPRINTF(RubyNetwork, "Router %d woke up\n", m_id);
     assert(clockEdge() == curTick());
 
-    // check for incoming flits
-    for (int inport = 0; inport < m_input_unit.size(); inport++) {
+    // check for incoming flits, on the inports whose link has some
+    for (int inport = m_pending_inports.first(); inport >= 0;
+         inport = m_pending_inports.next(inport)) {
         m_input_unit[inport]->wakeup();
     }
 
@@ -85,7 +86,8 @@ Router::wakeup()
     //     credit traversal (1-cycle) + SA (1-cycle) + Link Traversal (1-cycle)
     // if we want the credit update to take place after SA, this loop should
     // be moved after the SA request
-    for (int outport = 0; outport < m_output_unit.size(); outport++) {
+    for (int outport = m_pending_outports.first(); outport >= 0;
+         outport = m_pending_outports.next(outport)) {
         m_output_unit[outport]->wakeup();
     }
 
@@ -110,11 +112,14 @@ Router::addInPort(PortDirection inport_dirn,
     input_unit->set_in_link(in_link);
     input_unit->set_credit_link(credit_link);
     in_link->setLinkConsumer(this);
+    in_link->setConsumerPort(&m_pending_inports, port_num);
     in_link->setVcsPerVnet(get_vc_per_vnet());
     credit_link->setSourceQueue(input_unit->getCreditQueue(), this);
     credit_link->setVcsPerVnet(get_vc_per_vnet());
 
     m_input_unit.push_back(std::shared_ptr<InputUnit>(input_unit));
+    m_pending_inports.resize(m_input_unit.size());
+    m_active_inports.resize(m_input_unit.size());
 
     routingUnit.addInDirection(inport_dirn, port_num);
 }
@@ -135,11 +140,13 @@ Router::addOutPort(PortDirection outport_dirn,
     output_unit->set_out_link(out_link);
     output_unit->set_credit_link(credit_link);
     credit_link->setLinkConsumer(this);
+    credit_link->setConsumerPort(&m_pending_outports, port_num);
     credit_link->setVcsPerVnet(consumerVcs);
     out_link->setSourceQueue(output_unit->getOutQueue(), this);
     out_link->setVcsPerVnet(consumerVcs);
 
     m_output_unit.push_back(std::shared_ptr<OutputUnit>(output_unit));
+    m_pending_outports.resize(m_output_unit.size());
 
     routingUnit.addRoute(routing_table_entry);
     routingUnit.addWeight(link_weight);
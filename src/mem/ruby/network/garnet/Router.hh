@@ -42,6 +42,7 @@
 #include "mem/ruby/network/garnet/CommonTypes.hh"
 #include "mem/ruby/network/garnet/CrossbarSwitch.hh"
 #include "mem/ruby/network/garnet/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet/PortMask.hh"
 #include "mem/ruby/network/garnet/RoutingUnit.hh"
 #include "mem/ruby/network/garnet/SwitchAllocator.hh"
 #include "mem/ruby/network/garnet/flit.hh"
@@ -111,6 +112,14 @@ class Router : public BasicRouter, public Consumer
         return m_output_unit[port].get();
     }
 
+    // Inports with flits buffered in their VCs
+    PortMask& getActiveInports() { return m_active_inports; }
+
+    // Inports with flits on their link, and outports with credits on
+    // their credit link
+    PortMask& getPendingInports() { return m_pending_inports; }
+    PortMask& getPendingOutports() { return m_pending_outports; }
+
     int getBitWidth() { return m_bit_width; }
 
     PortDirection getOutportDirection(int outport);
@@ -154,6 +163,12 @@ class Router : public BasicRouter, public Consumer
     std::vector<std::shared_ptr<InputUnit>> m_input_unit;
     std::vector<std::shared_ptr<OutputUnit>> m_output_unit;
 
+    // Ports the router stages have to look at, so that a large router
+    // with light traffic does not visit all of its ports every cycle
+    PortMask m_active_inports;
+    PortMask m_pending_inports;
+    PortMask m_pending_outports;
+
     // Statistical variables required for power computations
     statistics::Scalar m_buffer_reads;
     statistics::Scalar m_buffer_writes;
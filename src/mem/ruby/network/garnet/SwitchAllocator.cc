@@ -66,6 +66,7 @@ SwitchAllocator::init()
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_inports);
     m_vc_winners.resize(m_num_inports);
+    m_requested_outports.resize(m_num_outports);
 
     for (int i = 0; i < m_num_inports; i++) {
         m_round_robin_invc[i] = 0;
@@ -98,8 +99,8 @@ SwitchAllocator::wakeup()
 }
 
 /*
- * SA-I (or SA-i) loops through all input VCs at every input port,
- * and selects one in a round robin manner.
+ * SA-I (or SA-i) loops through all input VCs at every input port with
+ * buffered flits, and selects one in a round robin manner.
  *    - For HEAD/HEAD_TAIL flits only selects an input VC whose output port
  *     has at least one free output VC.
  *    - For BODY/TAIL flits, only selects an input VC that has credits
@@ -112,7 +113,10 @@ SwitchAllocator::arbitrate_inports()
 {
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
-    for (int inport = 0; inport < m_num_inports; inport++) {
+    // Input ports without any buffered flit have nothing to request
+    PortMask& active_inports = m_router->getActiveInports();
+    for (int inport = active_inports.first(); inport >= 0;
+         inport = active_inports.next(inport)) {
         int invc = m_round_robin_invc[inport];
 
         for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
@@ -133,6 +137,7 @@ SwitchAllocator::arbitrate_inports()
                     m_input_arbiter_activity++;
                     m_port_requests[inport] = outport;
                     m_vc_winners[inport] = invc;
+                    m_requested_outports.set(outport);
 
                     break; // got one vc winner for this port
                 }
@@ -146,7 +151,7 @@ SwitchAllocator::arbitrate_inports()
 }
 
 /*
- * SA-II (or SA-o) loops through all output ports,
+ * SA-II (or SA-o) loops through all output ports requested during SA-I,
  * and selects one input VC (that placed a request during SA-I)
  * as the winner for this output port in a round robin manner.
  *      - For HEAD/HEAD_TAIL flits, performs simplified outvc allocation.
@@ -165,7 +170,8 @@ SwitchAllocator::arbitrate_outports()
     // Now there are a set of input vc requests for output vcs.
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
-    for (int outport = 0; outport < m_num_outports; outport++) {
+    for (int outport = m_requested_outports.first(); outport >= 0;
+         outport = m_requested_outports.next(outport)) {
         int inport = m_round_robin_inport[outport];
 
         for (int inport_iter = 0; inport_iter < m_num_inports;
@@ -362,7 +368,8 @@ SwitchAllocator::check_for_wakeup()
         return;
     }
 
-    for (int i = 0; i < m_num_inports; i++) {
+    PortMask& active_inports = m_router->getActiveInports();
+    for (int i = active_inports.first(); i >= 0; i = active_inports.next(i)) {
         for (int j = 0; j < m_num_vcs; j++) {
             if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
@@ -386,7 +393,18 @@ SwitchAllocator::get_vnet(int invc)
 void
 SwitchAllocator::clear_request_vector()
 {
-    std::fill(m_port_requests.begin(), m_port_requests.end(), -1);
+    // Only the input ports with buffered flits may have made a request
+    // that was not granted
+    PortMask& active_inports = m_router->getActiveInports();
+    for (int inport = active_inports.first(); inport >= 0;
+         inport = active_inports.next(inport)) {
+        m_port_requests[inport] = -1;
+    }
+
+    for (int outport = m_requested_outports.first(); outport >= 0;
+         outport = m_requested_outports.next(outport)) {
+        m_requested_outports.clear(outport);
+    }
 }
 
 void
@@ -37,6 +37,7 @@
 
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
+#include "mem/ruby/network/garnet/PortMask.hh"
 
 namespace gem5
 {
@@ -90,6 +91,9 @@ class SwitchAllocator : public Consumer
     std::vector<int> m_round_robin_inport;
     std::vector<int> m_port_requests;
     std::vector<int> m_vc_winners;
+
+    // Output ports requested during SA-I
+    PortMask m_requested_outports;
 };
 
 } // namespace garnet
@@ -0,0 +1,79 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_SLICC_INTERFACE_MESSAGEPOOL_HH__
+#define __MEM_RUBY_SLICC_INTERFACE_MESSAGEPOOL_HH__
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/block_pool.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * Pool of the memory blocks holding the messages of one type, and their
+ * shared_ptr control blocks, so message traffic neither calls malloc in
+ * steady state nor contends on the allocator when several event queues
+ * run Ruby objects in parallel.
+ *
+ * Every SLICC message type has a pool, which messages are allocated from
+ * through makeMessage().
+ */
+class MessagePool : public BlockPool
+{
+  public:
+    explicit MessagePool(const std::string &name);
+
+    /** All the message pools, in construction order. */
+    static const std::vector<MessagePool *> &pools();
+};
+
+template <class T>
+using MessageAllocator = BlockPoolAllocator<T>;
+
+/**
+ * Create a message from the pool of its type.
+ *
+ * @param args Arguments of the constructor of the message.
+ */
+template <class Msg, class... Args>
+std::shared_ptr<Msg>
+makeMessage(Args&&... args)
+{
+    return std::allocate_shared<Msg>(MessageAllocator<Msg>(Msg::pool),
+                                     std::forward<Args>(args)...);
+}
+
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_SLICC_INTERFACE_MESSAGEPOOL_HH__
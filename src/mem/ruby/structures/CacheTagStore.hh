@@ -0,0 +1,97 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_CACHETAGSTORE_HH__
+#define __MEM_RUBY_STRUCTURES_CACHETAGSTORE_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+// The CacheTagStore holds the line address cached in each way of a
+// set-associative cache in a single contiguous array, set after set.
+// Looking a tag up scans the ways of its set, which are adjacent in
+// memory, so lookups neither hash nor chase pointers, and the store
+// uses a fixed amount of memory whatever the occupancy of the cache.
+
+class CacheTagStore
+{
+  public:
+    CacheTagStore() : m_assoc(0) {}
+
+    void
+    init(int64_t num_sets, int assoc)
+    {
+        m_assoc = assoc;
+        m_tags.assign(num_sets * assoc, InvalidTag);
+    }
+
+    // Returns the way of the set holding the tag, or -1 if the tag is
+    // not in the set.
+    int
+    find(int64_t set, Addr tag) const
+    {
+        assert(tag != InvalidTag);
+        const Addr *ways = &m_tags[set * m_assoc];
+        for (int way = 0; way < m_assoc; way++) {
+            if (ways[way] == tag)
+                return way;
+        }
+        return -1;
+    }
+
+    void
+    insert(int64_t set, int way, Addr tag)
+    {
+        assert(tag != InvalidTag);
+        m_tags[set * m_assoc + way] = tag;
+    }
+
+    void
+    erase(int64_t set, int way)
+    {
+        m_tags[set * m_assoc + way] = InvalidTag;
+    }
+
+  private:
+    // Line addresses are aligned, so this never matches a line.
+    static constexpr Addr InvalidTag = MaxAddr;
+
+    int m_assoc;
+    std::vector<Addr> m_tags;
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_STRUCTURES_CACHETAGSTORE_HH__
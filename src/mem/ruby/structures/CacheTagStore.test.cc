@@ -0,0 +1,55 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "mem/ruby/structures/CacheTagStore.hh"
+
+using namespace gem5;
+using namespace gem5::ruby;
+
+TEST(CacheTagStoreTest, FindInsertErase)
+{
+    CacheTagStore tags;
+    tags.init(4, 2);
+
+    EXPECT_EQ(tags.find(1, 0x40), -1);
+    tags.insert(1, 0, 0x40);
+    tags.insert(1, 1, 0x140);
+    tags.insert(2, 1, 0x80);
+    EXPECT_EQ(tags.find(1, 0x40), 0);
+    EXPECT_EQ(tags.find(1, 0x140), 1);
+    EXPECT_EQ(tags.find(2, 0x80), 1);
+    EXPECT_EQ(tags.find(2, 0x40), -1);
+
+    tags.erase(1, 0);
+    EXPECT_EQ(tags.find(1, 0x40), -1);
+    EXPECT_EQ(tags.find(1, 0x140), 1);
+
+    // Line 0 is a valid tag.
+    tags.insert(0, 1, 0);
+    EXPECT_EQ(tags.find(0, 0), 1);
+}
+
@@ -53,6 +53,7 @@
 #include "debug/RubySystem.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
+#include "mem/ruby/slicc_interface/MessagePool.hh"
 #include "mem/ruby/system/DMASequencer.hh"
 #include "mem/ruby/system/Sequencer.hh"
 #include "mem/simple_mem.hh"
@@ -78,7 +79,7 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params &p)
     : ClockedObject(p), m_access_backing_store(p.access_backing_store),
-      m_cache_recorder(NULL)
+      messagePoolStats(this), m_cache_recorder(NULL)
 {
     m_randomization = p.randomization;
 
@@ -480,6 +481,53 @@ RubySystem::resetStats()
     ClockedObject::resetStats();
 }
 
+RubySystem::MessagePoolStats::MessagePoolStats(statistics::Group *parent)
+    : statistics::Group(parent, "messagePool"),
+      ADD_STAT(allocations, statistics::units::Count::get(),
+               "Number of messages allocated"),
+      ADD_STAT(reuses, statistics::units::Count::get(),
+               "Number of messages allocated from a pooled block")
+{
+}
+
+void
+RubySystem::MessagePoolStats::regStats()
+{
+    statistics::Group::regStats();
+
+    const auto &pools = MessagePool::pools();
+    allocations.init(pools.size()).flags(statistics::nozero);
+    reuses.init(pools.size()).flags(statistics::nozero);
+    for (std::size_t i = 0; i < pools.size(); i++) {
+        allocations.subname(i, pools[i]->name());
+        reuses.subname(i, pools[i]->name());
+    }
+    allocationsBase.resize(pools.size(), 0);
+    reusesBase.resize(pools.size(), 0);
+}
+
+void
+RubySystem::MessagePoolStats::resetStats()
+{
+    statistics::Group::resetStats();
+
+    const auto &pools = MessagePool::pools();
+    for (std::size_t i = 0; i < pools.size(); i++) {
+        allocationsBase[i] = pools[i]->allocations();
+        reusesBase[i] = pools[i]->reuses();
+    }
+}
+
+void
+RubySystem::MessagePoolStats::update()
+{
+    const auto &pools = MessagePool::pools();
+    for (std::size_t i = 0; i < pools.size(); i++) {
+        allocations[i] = pools[i]->allocations() - allocationsBase[i];
+        reuses[i] = pools[i]->reuses() - reusesBase[i];
+    }
+}
+
 #ifndef PARTIAL_FUNC_READS
 bool
 RubySystem::functionalRead(PacketPtr pkt)
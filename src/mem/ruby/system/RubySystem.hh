@@ -90,7 +90,12 @@ class RubySystem : public ClockedObject
     void regStats() override {
         ClockedObject::regStats();
     }
-    void collateStats() { m_profiler->collateStats(); }
+    void
+    collateStats()
+    {
+        m_profiler->collateStats();
+        messagePoolStats.update();
+    }
     void resetStats() override;
 
     void memWriteback() override;
@@ -154,6 +159,25 @@ class RubySystem : public ClockedObject
     std::unordered_map<RequestorID, unsigned> requestorToNetwork;
     std::unordered_map<unsigned, std::vector<AbstractController*>> netCntrls;
 
+    /** Allocation counts of the messages, by message type. */
+    struct MessagePoolStats : public statistics::Group
+    {
+        MessagePoolStats(statistics::Group *parent);
+
+        void regStats() override;
+        void resetStats() override;
+
+        /** Update the stats with the current counts of the pools. */
+        void update();
+
+        statistics::Vector allocations;
+        statistics::Vector reuses;
+
+        /** Counts of the pools when the stats were last reset. */
+        std::vector<uint64_t> allocationsBase;
+        std::vector<uint64_t> reusesBase;
+    } messagePoolStats;
+
   public:
     Profiler* m_profiler;
     CacheRecorder* m_cache_recorder;
@@ -0,0 +1,94 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/shards_calc.hh"
+
+#include <cmath>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+ShardsCalc::ShardsCalc(double sampling_rate, uint64_t max_lines)
+    : threshold(std::llround(sampling_rate * modulus)),
+      maxLines(max_lines)
+{
+    fatal_if(sampling_rate <= 0 || sampling_rate > 1,
+             "The sampling rate must be in (0, 1], got %f.", sampling_rate);
+    fatal_if(threshold == 0, "The sampling rate %f is too low.",
+             sampling_rate);
+}
+
+uint64_t
+ShardsCalc::hash(Addr line)
+{
+    // Finalizer of MurmurHash3, mixing all the address bits into the
+    // ones used for sampling
+    uint64_t h = line;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h & (modulus - 1);
+}
+
+bool
+ShardsCalc::access(Addr line, Sample &sample)
+{
+    ++refs;
+    const uint64_t h = hash(line);
+    if (h >= threshold)
+        return false;
+
+    const double rate = samplingRate();
+    const uint64_t dist = stack.calcStackDistAndUpdate(line).first;
+    if (dist == Infinity) {
+        sample.distance = Infinity;
+        lines.emplace(h, line);
+        if (maxLines && lines.size() > maxLines)
+            evict();
+    } else {
+        sample.distance = std::llround(dist / rate);
+    }
+    sample.weight = 1 / rate;
+    sampleWeight += sample.weight;
+    return true;
+}
+
+void
+ShardsCalc::evict()
+{
+    // Stop sampling the lines with the largest hash, and all the ones
+    // above, dropping them from the stack
+    threshold = lines.top().first;
+    while (!lines.empty() && lines.top().first >= threshold) {
+        stack.calcStackDistAndUpdate(lines.top().second, false);
+        lines.pop();
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,147 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_SHARDS_CALC_HH__
+#define __MEM_SHARDS_CALC_HH__
+
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/fenwick_stack_dist_calc.hh"
+
+namespace gem5
+{
+
+/**
+ * Approximate reuse distance calculator based on spatially hashed
+ * sampling (SHARDS), as described by Waldspurger et al. in "Efficient
+ * MRC Construction with SHARDS", FAST 2015.
+ *
+ * Only the cache lines whose hashed address falls below a threshold
+ * are tracked, so a fraction R of the lines, and all the references to
+ * them, are sampled. The stack distance between sampled lines, scaled
+ * by 1/R, estimates the reuse distance of the reference, and every
+ * sampled reference stands for 1/R references.
+ *
+ * The number of lines tracked can be bounded, making the memory used
+ * independent of the footprint of the workload. When the bound is
+ * exceeded, the lines with the largest hashes are dropped and the
+ * threshold is lowered accordingly, which lowers the sampling rate of
+ * the following references.
+ *
+ * The sampled lines may be referenced more or less often than the
+ * average line, so the weights of the samples don't add up to the
+ * number of references exactly. As in SHARDS-adj, the difference is
+ * accounted for at the shortest reuse distance, see adjustment().
+ */
+class ShardsCalc
+{
+  public:
+    /**
+     * @param sampling_rate Initial fraction of the lines to sample.
+     * @param max_lines Maximum number of lines tracked, 0 for no limit.
+     */
+    ShardsCalc(double sampling_rate, uint64_t max_lines);
+
+    /** Reuse distance of the first reference to a line. */
+    static constexpr uint64_t Infinity = FenwickStackDistCalc::Infinity;
+
+    /** Estimate derived from a sampled reference. */
+    struct Sample
+    {
+        /** Estimated reuse distance in lines, or Infinity. */
+        uint64_t distance;
+
+        /** Number of references the sample stands for. */
+        double weight;
+    };
+
+    /**
+     * Process a reference to a cache line.
+     *
+     * @param line Address of the cache line referenced.
+     * @param sample Estimate derived from the reference, if sampled.
+     * @return True if the reference was sampled.
+     */
+    bool access(Addr line, Sample &sample);
+
+    /** Current fraction of the lines sampled. */
+    double
+    samplingRate() const
+    {
+        return double(threshold) / modulus;
+    }
+
+    /** Number of lines tracked. */
+    uint64_t numLines() const { return lines.size(); }
+
+    /**
+     * Number of references to add at a reuse distance of 0 so that the
+     * samples stand for all the references processed (SHARDS-adj). This
+     * is negative if the sampled lines are referenced more often than
+     * expected.
+     */
+    double adjustment() const { return refs - sampleWeight; }
+
+    /** Restart the count of references used by adjustment(). */
+    void
+    resetAdjustment()
+    {
+        refs = 0;
+        sampleWeight = 0;
+    }
+
+  private:
+    /** Spatial hash of a line, in [0, modulus). */
+    static uint64_t hash(Addr line);
+
+    /** Drop the lines with the largest hashes to meet the bound. */
+    void evict();
+
+    /** Range of the hash values. */
+    static constexpr uint64_t modulus = 1ULL << 24;
+
+    /** Lines whose hash is below the threshold are sampled. */
+    uint64_t threshold;
+
+    const uint64_t maxLines;
+
+    /** Stack of the sampled lines. */
+    FenwickStackDistCalc stack;
+
+    /** Sampled lines in the stack, largest hash first. */
+    std::priority_queue<std::pair<uint64_t, Addr>> lines;
+
+    /** References processed, and number of them the samples stand for. */
+    uint64_t refs = 0;
+    double sampleWeight = 0;
+};
+
+} // namespace gem5
+
+#endif //__MEM_SHARDS_CALC_HH__
@@ -0,0 +1,183 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "mem/fenwick_stack_dist_calc.hh"
+#include "mem/shards_calc.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Miss ratio curve of a trace, at a set of cache sizes given in lines,
+ * built either from exact stack distances or from SHARDS samples.
+ */
+struct MissRatioCurve
+{
+    std::vector<uint64_t> sizes;
+    std::vector<double> misses;
+    double refs = 0;
+
+    MissRatioCurve(const std::vector<uint64_t> &sizes)
+        : sizes(sizes), misses(sizes.size(), 0)
+    {}
+
+    void
+    add(uint64_t distance, double weight)
+    {
+        refs += weight;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            if (distance >= sizes[i])
+                misses[i] += weight;
+        }
+    }
+
+    double missRatio(size_t i) const { return misses[i] / refs; }
+};
+
+/**
+ * Run a synthetic trace mixing a hot working set, a larger warm one
+ * and streaming accesses through both calculators and compare the
+ * resulting miss ratio curves.
+ */
+double
+maxMissRatioError(double sampling_rate, uint64_t max_lines,
+                  uint64_t *lines_tracked = nullptr)
+{
+    const std::vector<uint64_t> sizes = {
+        1024, 4096, 16384, 65536, 262144 };
+    MissRatioCurve exact(sizes);
+    MissRatioCurve estimate(sizes);
+
+    FenwickStackDistCalc stack;
+    ShardsCalc shards(sampling_rate, max_lines);
+
+    std::mt19937_64 rng(0x5eed);
+    Addr stream = 1ULL << 40;
+    uint64_t max_tracked = 0;
+    for (int i = 0; i < 3000000; ++i) {
+        Addr line;
+        const int kind = rng() % 100;
+        if (kind < 50)
+            line = rng() % 4000;
+        else if (kind < 99)
+            line = 1000000 + rng() % 100000;
+        else
+            line = stream++;
+
+        exact.add(stack.calcStackDistAndUpdate(line).first, 1);
+
+        ShardsCalc::Sample sample;
+        if (shards.access(line, sample))
+            estimate.add(sample.distance, sample.weight);
+        max_tracked = std::max(max_tracked, shards.numLines());
+    }
+
+    if (lines_tracked)
+        *lines_tracked = max_tracked;
+
+    // Count the references missing from the samples as hits, so that
+    // the estimates are relative to the actual number of references
+    estimate.add(0, shards.adjustment());
+    EXPECT_NEAR(estimate.refs, exact.refs, 1e-6 * exact.refs);
+
+    double max_error = 0;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        max_error = std::max(max_error, std::abs(
+            exact.missRatio(i) - estimate.missRatio(i)));
+    }
+    return max_error;
+}
+
+} // anonymous namespace
+
+/** Sampling at a fixed rate approximates the exact curve. */
+TEST(ShardsCalcTest, FixedRate)
+{
+    ASSERT_LT(maxMissRatioError(0.05, 0), 0.05);
+}
+
+/** Bounding the lines tracked lowers the rate but keeps the curve. */
+TEST(ShardsCalcTest, FixedSize)
+{
+    uint64_t lines_tracked;
+    ASSERT_LT(maxMissRatioError(0.5, 8192, &lines_tracked), 0.05);
+    ASSERT_LE(lines_tracked, 8192u);
+}
+
+/**
+ * The adjustment makes up for the references the samples don't stand
+ * for, and is restarted independently of the lines sampled.
+ */
+TEST(ShardsCalcTest, Adjustment)
+{
+    ShardsCalc shards(0.1, 0);
+    ShardsCalc::Sample sample;
+
+    // A single line referenced over and over is either sampled or not
+    Addr line = 0;
+    while (shards.access(line, sample))
+        ++line;
+    shards.resetAdjustment();
+    for (int i = 0; i < 100; ++i)
+        ASSERT_FALSE(shards.access(line, sample));
+    ASSERT_EQ(shards.adjustment(), 100);
+
+    shards.resetAdjustment();
+    for (int i = 0; i < 100; ++i)
+        ASSERT_TRUE(shards.access(0, sample));
+    ASSERT_NEAR(shards.adjustment(), 100 - 100 / shards.samplingRate(),
+                1e-6);
+
+    shards.resetAdjustment();
+    ASSERT_EQ(shards.adjustment(), 0);
+    ASSERT_TRUE(shards.access(0, sample));
+    ASSERT_EQ(sample.distance, 0);
+}
+
+/** Sampling every line gives the exact stack distances. */
+TEST(ShardsCalcTest, FullRate)
+{
+    FenwickStackDistCalc stack;
+    ShardsCalc shards(1.0, 0);
+
+    std::mt19937_64 rng(0x5eed);
+    for (int i = 0; i < 100000; ++i) {
+        const Addr line = rng() % 5000;
+        ShardsCalc::Sample sample;
+        ASSERT_TRUE(shards.access(line, sample));
+        ASSERT_EQ(sample.distance,
+                  stack.calcStackDistAndUpdate(line).first);
+        ASSERT_EQ(sample.weight, 1.0);
+    }
+    ASSERT_EQ(shards.adjustment(), 0);
+}
@@ -221,6 +221,9 @@ class Type(Symbol):
             code('#include "mem/ruby/protocol/$0.hh"', self["interface"])
             parent = " :  public %s" % self["interface"]
 
+        if self.isMessage:
+            code('#include "mem/ruby/slicc_interface/MessagePool.hh"')
+
         code('''
 namespace gem5
 {
@@ -297,8 +300,11 @@ $klass ${{self.c_ident}}$parent
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return makeMessage<${{self.c_ident}}>(*this);
 }
+
+/** \\brief Pool the messages of this type are allocated from. */
+static MessagePool pool;
 ''')
         else:
             code('''
@@ -417,7 +423,14 @@ namespace gem5
 
 namespace ruby
 {
+''')
 
+        if self.isMessage:
+            code('''
+MessagePool ${{self.c_ident}}::pool("${{self.c_ident}}");
+''')
+
+        code('''
 /** \\brief Print the state of this object */
 void
 ${{self.c_ident}}::print(std::ostream& out) const
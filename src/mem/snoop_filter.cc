@@ -42,6 +42,7 @@
 
 #include "mem/snoop_filter.hh"
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -52,15 +53,199 @@ namespace gem5
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::SnoopFilter(const SnoopFilterParams &p)
+    : SimObject(p), system(p.system),
+      requestorId(p.assoc ? p.system->getRequestorId(this) :
+                  RequestorID(Request::invldRequestorId)),
+      backInvalidationId((PacketId(1) << 63) | requestorId),
+      linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
+      maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
+      stats(this)
+{
+    if (!p.assoc)
+        return;
+
+    fatal_if(maxEntryCount % p.assoc != 0 ||
+             !isPowerOf2(maxEntryCount / p.assoc),
+             "%s: the number of sets (%d entries / %d ways) must be a "
+             "power of 2\n", name(), maxEntryCount, p.assoc);
+    fatal_if(!p.replacement_policy, "%s: a set-associative snoop filter "
+             "needs a replacement policy\n", name());
+
+    sets.reset(new SnoopFilterSets<SnoopItem>(
+        maxEntryCount, p.assoc, linesize, p.replacement_policy));
+}
+
+SnoopFilter::SnoopItem *
+SnoopFilter::findItem(Addr line_addr, bool touch)
+{
+    if (sets) {
+        // A line whose request is being looked up is not allocated yet
+        if (reqLookupResult.item == &reqLookupResult.newItem &&
+            reqLookupResult.lineAddr == line_addr) {
+            return &reqLookupResult.newItem;
+        }
+        if (SnoopItem *sf_item = sets->find(line_addr, touch))
+            return sf_item;
+        if (cachedLocations.empty())
+            return nullptr;
+    }
+
+    auto sf_it = cachedLocations.find(line_addr);
+    return sf_it == cachedLocations.end() ? nullptr : &sf_it->second;
+}
+
+void
+SnoopFilter::allocateItem(Addr line_addr, const SnoopItem &sf_item)
+{
+    // The lines with requests in flight cannot be evicted, as their
+    // requestors are waiting for the responses, and neither can the
+    // lines of the caches still writing an evicted line down, which
+    // would need more room in their write buffers
+    SnoopMask writing_down;
+    for (const auto& wd : writeDowns)
+        writing_down |= wd.second;
+
+    Addr victim_addr;
+    SnoopItem victim;
+    SnoopItem *new_item = sets->allocate(line_addr,
+        [writing_down](const SnoopItem &item) {
+            return item.requested.none() &&
+                (item.holder & writing_down).none();
+        },
+        victim_addr, victim);
+    if (!new_item) {
+        // Rather than stalling the request until a way is released,
+        // track the line in the overflow entries, see moveFromOverflow
+        DPRINTF(SnoopFilter, "%s: none of the ways of the set of %#x can "
+                "be evicted, using an overflow entry\n",
+                __func__, line_addr);
+        stats.overflows++;
+        cachedLocations.emplace(line_addr, sf_item);
+        return;
+    }
+    *new_item = sf_item;
+
+    if (victim_addr != sets->InvalidTag)
+        backInvalidate(victim_addr, victim);
+}
+
+void
+SnoopFilter::eraseIfNullEntry(Addr line_addr, const SnoopItem &sf_item)
+{
+    // The item of a new line is only allocated, or dropped, once its
+    // request is accepted or will retry
+    if ((sf_item.requested | sf_item.holder).any() ||
+        &sf_item == &reqLookupResult.newItem) {
+        return;
+    }
+
+    if (!sets || !sets->erase(line_addr))
+        cachedLocations.erase(line_addr);
+    DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
+            __func__);
+}
+
+void
+SnoopFilter::moveFromOverflow(Addr line_addr, const SnoopItem &sf_item)
+{
+    if (!sets || cachedLocations.empty() || sf_item.requested.any() ||
+        sf_item.holder.none()) {
+        return;
+    }
+
+    auto sf_it = cachedLocations.find(line_addr);
+    if (sf_it == cachedLocations.end())
+        return;
+
+    DPRINTF(SnoopFilter, "%s: moving %#x to its set\n", __func__,
+            line_addr);
+    const SnoopItem item = sf_it->second;
+    cachedLocations.erase(sf_it);
+    allocateItem(line_addr, item);
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::backInvalidate(Addr line_addr, const SnoopItem &sf_item)
+{
+    DPRINTF(SnoopFilter, "%s: evicting %#x SF value %x.%x\n",
+            __func__, line_addr, sf_item.requested, sf_item.holder);
+
+    stats.evictions++;
+
+    // Clean and invalidate the line up to the point of coherency, so
+    // that the dirty copies are written through any cache between the
+    // holders and this filter rather than allocated in them again. The
+    // crossbar of the filter stops the writes at the memory below it,
+    // see isBackInvalidation
+    Request::Flags flags =
+        Request::CLEAN | Request::INVALIDATE | Request::DST_POC;
+    if (line_addr & LineSecure)
+        flags.set(Request::SECURE);
+    RequestPtr req = std::make_shared<Request>(
+        line_addr & ~Addr(LineSecure), linesize, flags, requestorId);
+
+    for (const auto& p : maskToPortList(sf_item.holder)) {
+        // The snoop is sent straight to the holder rather than through
+        // the crossbar, which therefore does not track it. This is only
+        // possible as the caches never respond to it: they write their
+        // dirty copies back instead, see Cache::handleSnoop, and
+        // Packet::isBackInvalidation for the copies in their write
+        // buffers
+        Packet pkt(req, MemCmd::CleanInvalidReq, linesize,
+                   backInvalidationId);
+        pkt.setBackInvalidation();
+        if (system->isTimingMode())
+            p->sendTimingSnoopReq(&pkt);
+        else
+            p->sendAtomicSnoop(&pkt);
+        panic_if(pkt.cacheResponding() || pkt.isResponse(),
+                 "%s: %s responded to the back-invalidation of %#x\n",
+                 name(), p->name(), line_addr);
+        stats.backInvalidations++;
+
+        // In timing mode, a cache that had a dirty copy writes it down
+        // later, see finishWriteDown
+        if (system->isTimingMode() && pkt.satisfied()) {
+            DPRINTF(SnoopFilter, "%s: %s writes %#x down\n", __func__,
+                    p->name(), line_addr);
+            writeDowns[line_addr] |= portToMask(*p);
+        }
+    }
+}
+
+bool
+SnoopFilter::waitForWriteDown(const Packet *cpkt) const
 {
-    SnoopItem& sf_item = sf_it->second;
-    if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
-        DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
-                __func__);
+    if (writeDowns.empty() || isBackInvalidation(cpkt))
+        return false;
+
+    Addr line_addr = cpkt->getBlockAddr(linesize);
+    if (cpkt->isSecure()) {
+        line_addr |= LineSecure;
     }
+    return writeDowns.find(line_addr) != writeDowns.end();
+}
+
+void
+SnoopFilter::finishWriteDown(const Packet *cpkt,
+                             const ResponsePort& cpu_side_port)
+{
+    Addr line_addr = cpkt->getBlockAddr(linesize);
+    if (cpkt->isSecure()) {
+        line_addr |= LineSecure;
+    }
+    auto wd_it = writeDowns.find(line_addr);
+    panic_if(wd_it == writeDowns.end() ||
+             (wd_it->second & portToMask(cpu_side_port)).none(),
+             "%s: unexpected write down of %#x from %s\n", name(),
+             line_addr, cpu_side_port.name());
+
+    DPRINTF(SnoopFilter, "%s: %s wrote %#x down\n", __func__,
+            cpu_side_port.name(), line_addr);
+    wd_it->second &= ~portToMask(cpu_side_port);
+    if (wd_it->second.none())
+        writeDowns.erase(wd_it);
 }
 
 std::pair<SnoopFilter::SnoopList, Cycles>
@@ -78,8 +263,15 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.item = findItem(line_addr, true);
+    reqLookupResult.lineAddr = line_addr;
+    bool is_hit = (reqLookupResult.item != nullptr);
+
+    // Lines evicted from a set-associative filter may still see
+    // writebacks that were issued before the back-invalidation, there is
+    // no need to track them again.
+    if (!is_hit && sets && cpkt->isEviction())
+        allocate = false;
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,12 +279,19 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element and update
+    // iterator, the set-associative storage only allocates it once the
+    // request is accepted
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        if (!sets) {
+            reqLookupResult.item =
+                &cachedLocations.emplace(line_addr, SnoopItem()).first->second;
+        } else {
+            reqLookupResult.newItem = SnoopItem();
+            reqLookupResult.item = &reqLookupResult.newItem;
+        }
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = *reqLookupResult.item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -159,26 +358,32 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            *reqLookupResult.item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        SnoopItem *sf_item = reqLookupResult.item;
+        reqLookupResult.item = nullptr;
+        if (sf_item != &reqLookupResult.newItem) {
+            eraseIfNullEntry(line_addr, *sf_item);
+        } else if ((sf_item->requested | sf_item->holder).any()) {
+            allocateItem(line_addr, *sf_item);
+        }
     }
 }
 
@@ -193,20 +398,29 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem *sf_entry = findItem(line_addr);
+    bool is_hit = (sf_entry != nullptr);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!is_hit && !sets && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
     // If the snoop filter has no entry, simply return a NULL
     // portlist, there is no point creating an entry only to remove it
     // later
-    if (!is_hit)
+    if (!is_hit) {
+        // The copies of an evicted line that are still being written
+        // down are only in the write buffers of the caches above, which
+        // e.g. tell the evictions of the caches below that the line is
+        // still cached
+        auto wd_it = writeDowns.find(line_addr);
+        if (wd_it != writeDowns.end())
+            return snoopSelected(maskToPortList(wd_it->second),
+                                 lookupLatency);
         return snoopDown(lookupLatency);
+    }
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_entry;
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -236,7 +450,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -266,7 +480,11 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem *sf_entry = findItem(line_addr);
+    // The requestor has a request in flight, so the line cannot have
+    // been evicted
+    panic_if(!sf_entry, "SF has no entry for %#x\n", line_addr);
+    SnoopItem& sf_item = *sf_entry;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -297,6 +515,7 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     assert((sf_item.requested | sf_item.holder).any());
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+    moveFromOverflow(line_addr, sf_item);
 }
 
 void
@@ -313,8 +532,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem *sf_entry = findItem(line_addr);
+    bool is_hit = sf_entry != nullptr;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -324,7 +543,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = *sf_entry;
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -332,7 +551,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 }
 
@@ -355,12 +574,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem *sf_entry = findItem(line_addr);
+    if (!sf_entry)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_entry;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -379,7 +598,6 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -388,6 +606,11 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     }
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+
+    if ((sf_item.requested | sf_item.holder).any())
+        moveFromOverflow(line_addr, sf_item);
+    else
+        eraseIfNullEntry(line_addr, sf_item);
 }
 
 SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
@@ -407,7 +630,16 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
+               "(>1) holders of the requested data."),
+      ADD_STAT(evictions, statistics::units::Count::get(),
+               "Number of lines evicted from a set-associative snoop "
+               "filter."),
+      ADD_STAT(backInvalidations, statistics::units::Count::get(),
+               "Number of snoops sent to invalidate the copies of evicted "
+               "lines."),
+      ADD_STAT(overflows, statistics::units::Count::get(),
+               "Number of lines tracked in an overflow entry as none of "
+               "the ways of their set could be evicted.")
 {}
 
 void
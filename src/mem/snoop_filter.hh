@@ -44,12 +44,15 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
+#include "mem/snoop_filter_sets.hh"
 #include "params/SnoopFilter.hh"
 #include "sim/sim_object.hh"
 #include "sim/system.hh"
@@ -85,6 +88,24 @@ namespace gem5
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the tracked lines are kept in a hash table that is only
+ * limited by a sanity check on its capacity. The filter can instead be
+ * made a set-associative structure of a fixed size, as found in
+ * hardware. When a line has to be allocated in a full set, the entry
+ * picked by the replacement policy is evicted and all the copies of its
+ * line above the filter are invalidated (back-invalidation), so that the
+ * filter remains inclusive of the caches it tracks. A new line is only
+ * allocated, and another one possibly evicted, once its request is
+ * accepted, so that a request which is retried does not evict lines.
+ * The lines with requests in flight cannot be evicted. A line whose set
+ * only holds such lines is kept in an overflow entry instead, until its
+ * own requests complete and it can take the place of another line. In
+ * timing mode, the dirty copies of an evicted line are written down
+ * after its back-invalidation, and the requests to the line wait at the
+ * crossbar until they are. The lines of a cache that is still writing
+ * a line down cannot be evicted either, so that each cache has at most
+ * one such write at a time.
  */
 class SnoopFilter : public SimObject
 {
@@ -95,13 +116,7 @@ class SnoopFilter : public SimObject
 
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
-        maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
-        stats(this)
-    {
-    }
+    SnoopFilter(const SnoopFilterParams &p);
 
     /**
      * Init a new snoop filter and tell it about all the cpu_sideports
@@ -200,6 +215,43 @@ class SnoopFilter : public SimObject
      */
     void updateResponse(const Packet *cpkt, const ResponsePort& cpu_side_port);
 
+    /**
+     * Check if a packet is a back-invalidation snoop of this filter, or
+     * a write of a dirty line caused by one. These writes stop at the
+     * memory below the filter rather than at their destination, as no
+     * cache maintenance request travels on to pair them with.
+     *
+     * @param cpkt Pointer to const Packet to check.
+     * @return Whether the packet is caused by a back-invalidation.
+     */
+    bool
+    isBackInvalidation(const Packet *cpkt) const
+    {
+        return cpkt->id == backInvalidationId;
+    }
+
+    /**
+     * Check if a request from above has to wait for the dirty copies of
+     * its line, evicted from the set-associative storage, to be written
+     * down. Until then, these copies sit in the write buffers of the
+     * caches above, where they are no longer snooped, and the memory
+     * below is stale.
+     *
+     * @param cpkt Pointer to const Packet holding the request.
+     * @return Whether the request has to be retried later.
+     */
+    bool waitForWriteDown(const Packet *cpkt) const;
+
+    /**
+     * Let the snoop filter see the write of a dirty copy of a line
+     * evicted from the set-associative storage go down.
+     *
+     * @param cpkt          Pointer to const Packet holding the write.
+     * @param cpu_side_port ResponsePort that sends the write.
+     */
+    void finishWriteDown(const Packet *cpkt,
+                         const ResponsePort& cpu_side_port);
+
     virtual void regStats();
 
   protected:
@@ -258,14 +310,80 @@ class SnoopFilter : public SimObject
 
   private:
 
+    /**
+     * Find the item tracking a line.
+     *
+     * @param line_addr Line address, including the line status bits.
+     * @param touch Update the replacement data of the entry on a hit.
+     * @return The item of the line, or nullptr if it is not tracked.
+     */
+    SnoopItem *findItem(Addr line_addr, bool touch=false);
+
+    /**
+     * Allocate an item for the line of an accepted request in the
+     * set-associative storage, possibly evicting another line.
+     *
+     * @param line_addr Line address, including the line status bits.
+     * @param sf_item Value of the new item.
+     */
+    void allocateItem(Addr line_addr, const SnoopItem &sf_item);
+
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, const SnoopItem &sf_item);
 
-    /** Simple hash set of cached addresses. */
+    /**
+     * Invalidate all the copies of a line evicted from the
+     * set-associative storage.
+     *
+     * @param line_addr Line address, including the line status bits.
+     * @param sf_item Item of the line when it was evicted.
+     */
+    void backInvalidate(Addr line_addr, const SnoopItem &sf_item);
+
+    /**
+     * Move a line from the overflow entries to its set once it has no
+     * request in flight, possibly evicting another line.
+     *
+     * @param line_addr Line address, including the line status bits.
+     * @param sf_item Item of the line.
+     */
+    void moveFromOverflow(Addr line_addr, const SnoopItem &sf_item);
+
+    /**
+     * Simple hash set of cached addresses, which only holds the overflow
+     * entries if the filter is set-associative.
+     */
     SnoopFilterCache cachedLocations;
 
+    /**
+     * Set-associative storage of the lines, used instead of the hash set
+     * if the filter has an associativity.
+     */
+    std::unique_ptr<SnoopFilterSets<SnoopItem>> sets;
+
+    /**
+     * Lines evicted from the set-associative storage in timing mode
+     * whose dirty copies are still being written down, with the ports
+     * they come from.
+     */
+    std::unordered_map<Addr, SnoopMask> writeDowns;
+
+    /** System, used to check the memory mode for back-invalidations. */
+    System *system;
+    /**
+     * Requestor id of the back-invalidation snoops, only registered if
+     * the filter is set-associative.
+     */
+    const RequestorID requestorId;
+    /**
+     * Packet id of the back-invalidation snoops. The other packets are
+     * identified by the address of their request, which never has the
+     * top bit set.
+     */
+    const PacketId backInvalidationId;
+
     /**
      * A request lookup must be followed by a call to finishRequest to inform
      * the operation's success. If a retry is needed, however, all changes
@@ -274,27 +392,25 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Item found or allocated by lookupRequest, if any. */
+        SnoopItem *item = nullptr;
+
+        /** Line address of the item. */
+        Addr lineAddr = 0;
 
         /**
-         * Variable to temporarily store value of snoopfilter entry
-         * in case finishRequest needs to undo changes made in lookupRequest
-         * (because of crossbar retry)
+         * Item of a line missing in the set-associative storage, which
+         * is only allocated by finishRequest when the request is not
+         * retried.
          */
-        SnoopItem retryItem;
+        SnoopItem newItem;
 
         /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
+         * Variable to temporarily store value of snoopfilter entry
+         * in case finishRequest needs to undo changes made in lookupRequest
+         * (because of crossbar retry)
          */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -329,6 +445,10 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar evictions;
+        statistics::Scalar backInvalidations;
+        statistics::Scalar overflows;
     } stats;
 };
 
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 The gem5 authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_SNOOP_FILTER_SETS_HH__
+#define __MEM_SNOOP_FILTER_SETS_HH__
+
+#include <cassert>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+
+namespace gem5
+{
+
+/**
+ * Fixed-size set-associative storage of the lines tracked by a snoop
+ * filter, as found in hardware. The line address of each entry is kept
+ * in a separate tag array, so that a lookup only reads the tags of one
+ * set.
+ *
+ * @tparam Item Tracking information of a line.
+ */
+template <class Item>
+class SnoopFilterSets
+{
+  public:
+    /** Tag of the free entries, no line address can match it. */
+    static constexpr Addr InvalidTag = MaxAddr;
+
+    /**
+     * @param num_entries Number of entries, assoc times a power of 2.
+     * @param assoc Number of ways of each set.
+     * @param line_size Size of the tracked lines.
+     * @param rp Replacement policy picking the victims.
+     */
+    SnoopFilterSets(unsigned num_entries, unsigned assoc,
+                    unsigned line_size, replacement_policy::Base *rp)
+        : assoc(assoc), lineShift(floorLog2(line_size)),
+          setMask(num_entries / assoc - 1), tags(num_entries, InvalidTag),
+          entries(num_entries), replacementPolicy(rp)
+    {
+        assert(num_entries % assoc == 0 && isPowerOf2(num_entries / assoc));
+        for (unsigned slot = 0; slot < num_entries; ++slot) {
+            entries[slot].setPosition(slot / assoc, slot % assoc);
+            entries[slot].replacementData = rp->instantiateEntry();
+        }
+        candidates.reserve(assoc);
+    }
+
+    /**
+     * Find the item of a line.
+     *
+     * @param line_addr Line address, possibly with status bits set
+     *                  below the line size.
+     * @param touch Update the replacement data of the entry on a hit.
+     * @return The item of the line, or nullptr if it is not tracked.
+     */
+    Item *
+    find(Addr line_addr, bool touch=false)
+    {
+        const int slot = findSlot(line_addr);
+        if (slot < 0)
+            return nullptr;
+        if (touch)
+            replacementPolicy->touch(entries[slot].replacementData);
+        return &entries[slot].item;
+    }
+
+    /**
+     * Allocate an empty item for a line that is not tracked. If the set
+     * of the line is full, the replacement policy picks the line to
+     * evict among those accepted by can_evict.
+     *
+     * @param line_addr Line address, possibly with status bits set.
+     * @param can_evict Predicate telling if the line of an item may be
+     *                  evicted.
+     * @param victim_addr Set to the address of the evicted line, or to
+     *                    InvalidTag if no line was evicted.
+     * @param victim Set to the item of the evicted line, if any.
+     * @return The new item, or nullptr if the set is full and none of
+     *         its lines may be evicted.
+     */
+    template <class CanEvict>
+    Item *
+    allocate(Addr line_addr, CanEvict can_evict, Addr &victim_addr,
+             Item &victim)
+    {
+        assert(findSlot(line_addr) < 0);
+        victim_addr = InvalidTag;
+
+        const unsigned first = firstSlot(line_addr);
+        int slot = -1;
+        candidates.clear();
+        for (unsigned way = first; way < first + assoc; ++way) {
+            if (tags[way] == InvalidTag) {
+                slot = way;
+                break;
+            }
+            if (can_evict(entries[way].item))
+                candidates.push_back(&entries[way]);
+        }
+
+        if (slot < 0) {
+            if (candidates.empty())
+                return nullptr;
+            ReplaceableEntry *entry =
+                replacementPolicy->getVictim(candidates);
+            slot = entry->getSet() * assoc + entry->getWay();
+            victim_addr = tags[slot];
+            victim = entries[slot].item;
+        }
+
+        tags[slot] = line_addr;
+        entries[slot].item = Item();
+        replacementPolicy->reset(entries[slot].replacementData);
+        return &entries[slot].item;
+    }
+
+    /**
+     * Stop tracking a line.
+     *
+     * @return Whether the line was tracked.
+     */
+    bool
+    erase(Addr line_addr)
+    {
+        const int slot = findSlot(line_addr);
+        if (slot < 0)
+            return false;
+        tags[slot] = InvalidTag;
+        replacementPolicy->invalidate(entries[slot].replacementData);
+        return true;
+    }
+
+  private:
+    struct Entry : public ReplaceableEntry
+    {
+        Item item;
+    };
+
+    /** First slot of the set a line maps to. */
+    unsigned
+    firstSlot(Addr line_addr) const
+    {
+        return ((line_addr >> lineShift) & setMask) * assoc;
+    }
+
+    /** Slot of a line, or -1. */
+    int
+    findSlot(Addr line_addr) const
+    {
+        const unsigned first = firstSlot(line_addr);
+        for (unsigned slot = first; slot < first + assoc; ++slot) {
+            if (tags[slot] == line_addr)
+                return slot;
+        }
+        return -1;
+    }
+
+    const unsigned assoc;
+    const unsigned lineShift;
+    /** Mask selecting the set of a line number. */
+    const Addr setMask;
+    /** Line address of each slot, InvalidTag if the slot is free. */
+    std::vector<Addr> tags;
+    /** Entries indexed like tags. */
+    std::vector<Entry> entries;
+    replacement_policy::Base *replacementPolicy;
+    /** Scratch list of the replacement candidates of a set. */
+    ReplacementCandidates candidates;
+};
+
+} // namespace gem5
+
+#endif // __MEM_SNOOP_FILTER_SETS_HH__
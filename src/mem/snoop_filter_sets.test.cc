@@ -0,0 +1,169 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/snoop_filter_sets.hh"
+#include "params/LRURP.hh"
+#include "sim/cur_tick.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Tracking information of a line, as kept by the snoop filter. */
+struct Item
+{
+    unsigned holder = 0;
+    bool requested = false;
+};
+
+/** Two sets of two ways of 64-byte lines, with an LRU policy. */
+class SnoopFilterSetsTest : public testing::Test
+{
+  protected:
+    static constexpr Addr InvalidTag = SnoopFilterSets<Item>::InvalidTag;
+
+    Tick tick = 0;
+    std::unique_ptr<replacement_policy::LRU> rp;
+    std::unique_ptr<SnoopFilterSets<Item>> sets;
+
+    void
+    SetUp() override
+    {
+        Gem5Internal::_curTickPtr = &tick;
+
+        LRURPParams params;
+        params.name = "rp";
+        params.eventq_index = 0;
+        rp.reset(new replacement_policy::LRU(params));
+        sets.reset(new SnoopFilterSets<Item>(4, 2, 64, rp.get()));
+    }
+
+    /** Allocate a line held by the given ports, one tick later. */
+    Item *
+    allocate(Addr line_addr, unsigned holder, Addr &victim_addr,
+             Item &victim)
+    {
+        tick++;
+        Item *item = sets->allocate(line_addr,
+            [](const Item &item) { return !item.requested; },
+            victim_addr, victim);
+        if (item)
+            item->holder = holder;
+        return item;
+    }
+};
+
+} // anonymous namespace
+
+/** Lines are found in their set, secure lines apart from the others. */
+TEST_F(SnoopFilterSetsTest, FindAllocated)
+{
+    Addr victim_addr;
+    Item victim;
+    Item *line0 = allocate(0x0, 1, victim_addr, victim);
+    ASSERT_EQ(victim_addr, InvalidTag);
+    Item *line1 = allocate(0x40, 1, victim_addr, victim);
+    ASSERT_EQ(victim_addr, InvalidTag);
+    Item *secure0 = allocate(0x0 | 1, 2, victim_addr, victim);
+    ASSERT_EQ(victim_addr, InvalidTag);
+
+    ASSERT_EQ(sets->find(0x0), line0);
+    ASSERT_EQ(sets->find(0x40), line1);
+    ASSERT_EQ(sets->find(0x0 | 1), secure0);
+    ASSERT_EQ(secure0->holder, 2);
+    ASSERT_EQ(sets->find(0x80), nullptr);
+
+    ASSERT_TRUE(sets->erase(0x0));
+    ASSERT_FALSE(sets->erase(0x0));
+    ASSERT_EQ(sets->find(0x0), nullptr);
+    ASSERT_EQ(sets->find(0x0 | 1), secure0);
+}
+
+/**
+ * Allocating a line in a full set evicts the least recently used line,
+ * whose holders are returned to be back-invalidated.
+ */
+TEST_F(SnoopFilterSetsTest, CapacityEviction)
+{
+    Addr victim_addr;
+    Item victim;
+    allocate(0x0, 1, victim_addr, victim);
+    allocate(0x80, 2, victim_addr, victim);
+    allocate(0x40, 4, victim_addr, victim);
+
+    tick++;
+    ASSERT_NE(sets->find(0x0, true), nullptr);
+
+    ASSERT_NE(allocate(0x100, 8, victim_addr, victim), nullptr);
+    ASSERT_EQ(victim_addr, 0x80);
+    ASSERT_EQ(victim.holder, 2);
+    ASSERT_EQ(sets->find(0x80), nullptr);
+    ASSERT_EQ(sets->find(0x100)->holder, 8);
+
+    // The other set is not affected
+    ASSERT_EQ(sets->find(0x40)->holder, 4);
+
+    ASSERT_NE(allocate(0x180, 16, victim_addr, victim), nullptr);
+    ASSERT_EQ(victim_addr, 0x0);
+    ASSERT_EQ(victim.holder, 1);
+}
+
+/** Lines with requests in flight are never evicted. */
+TEST_F(SnoopFilterSetsTest, BusyLines)
+{
+    Addr victim_addr;
+    Item victim;
+    allocate(0x0, 1, victim_addr, victim)->requested = true;
+    allocate(0x80, 2, victim_addr, victim);
+
+    ASSERT_NE(allocate(0x100, 4, victim_addr, victim), nullptr);
+    ASSERT_EQ(victim_addr, 0x80);
+
+    sets->find(0x100)->requested = true;
+    ASSERT_EQ(allocate(0x180, 8, victim_addr, victim), nullptr);
+    ASSERT_EQ(victim_addr, InvalidTag);
+    ASSERT_NE(sets->find(0x0), nullptr);
+    ASSERT_NE(sets->find(0x100), nullptr);
+}
+
+/** Erased lines free their entry without evicting another line. */
+TEST_F(SnoopFilterSetsTest, ReuseErased)
+{
+    Addr victim_addr;
+    Item victim;
+    allocate(0x0, 1, victim_addr, victim);
+    allocate(0x80, 2, victim_addr, victim);
+
+    ASSERT_TRUE(sets->erase(0x80));
+    ASSERT_NE(allocate(0x100, 4, victim_addr, victim), nullptr);
+    ASSERT_EQ(victim_addr, InvalidTag);
+    ASSERT_NE(sets->find(0x0), nullptr);
+}
@@ -45,6 +45,7 @@
 
 #include "mem/xbar.hh"
 
+#include "base/cast.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -82,6 +83,41 @@ BaseXBar::~BaseXBar()
 
     for (auto port: cpuSidePorts)
         delete port;
+
+    for (auto state: freeRouteStates)
+        delete state;
+}
+
+void
+BaseXBar::pushRoute(PacketPtr pkt, PortID cpu_side_port_id)
+{
+    RouteState *state;
+    if (freeRouteStates.empty()) {
+        state = new RouteState;
+    } else {
+        state = freeRouteStates.back();
+        freeRouteStates.pop_back();
+    }
+
+    state->port = cpu_side_port_id;
+    pkt->pushSenderState(state);
+}
+
+PortID
+BaseXBar::peekRoute(PacketPtr pkt) const
+{
+    const PortID cpu_side_port_id =
+        safe_cast<RouteState*>(pkt->senderState)->port;
+    assert(cpu_side_port_id != InvalidPortID);
+    assert(cpu_side_port_id < cpuSidePorts.size());
+    return cpu_side_port_id;
+}
+
+void
+BaseXBar::popRoute(PacketPtr pkt)
+{
+    freeRouteStates.push_back(
+        safe_cast<RouteState*>(pkt->popSenderState()));
 }
 
 Port &
@@ -47,7 +47,7 @@
 #define __MEM_XBAR_HH__
 
 #include <deque>
-#include <unordered_map>
+#include <vector>
 
 #include "base/addr_range_map.hh"
 #include "base/types.hh"
@@ -319,12 +319,48 @@ class BaseXBar : public ClockedObject
     AddrRangeMap<PortID, 3> portMap;
 
     /**
-     * Remember where request packets came from so that we can route
-     * responses to the appropriate port. This relies on the fact that
-     * the underlying Request pointer inside the Packet stays
-     * constant.
+     * Sender state remembering where a request packet came from, so
+     * that the response can be routed to the appropriate port without
+     * any lookup. This relies on the response being the request
+     * packet turned around, with the sender state stack restored by
+     * anyone below the crossbar.
      */
-    std::unordered_map<RequestPtr, PortID> routeTo;
+    struct RouteState : public Packet::SenderState
+    {
+        PortID port;
+    };
+
+    /**
+     * Route states that are not attached to a packet, kept around to
+     * avoid an allocation per request.
+     */
+    std::vector<RouteState*> freeRouteStates;
+
+    /**
+     * Remember the port a request came from by pushing a route state
+     * on the packet.
+     *
+     * @param pkt The request packet
+     * @param cpu_side_port_id Id of the port the request came from
+     */
+    void pushRoute(PacketPtr pkt, PortID cpu_side_port_id);
+
+    /**
+     * Get the port a response should be routed to, without removing
+     * the route state from the packet.
+     *
+     * @param pkt The response packet
+     * @return Id of the port the request came from
+     */
+    PortID peekRoute(PacketPtr pkt) const;
+
+    /**
+     * Remove the route state from a packet, once the response is on
+     * its way or the request was rejected.
+     *
+     * @param pkt The packet carrying the route state
+     */
+    void popRoute(PacketPtr pkt);
 
     /** all contigous ranges seen by this crossbar */
     AddrRangeList xbarRanges;
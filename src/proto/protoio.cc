@@ -37,45 +37,203 @@
 
 #include "proto/protoio.hh"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 
 #include "base/logging.hh"
+#include "config/have_zstd.hh"
+
+#if HAVE_ZSTD
+#include <zstd.h>
+
+#endif
 
 using namespace google::protobuf;
 
+namespace
+{
+
+/// The magic number at the start of a zstd frame
+const uint8_t zstdMagic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+#if HAVE_ZSTD
+
+/**
+ * A copying stream compressing its data with zstd into a zero copy
+ * stream. The frame is ended when the stream is destroyed.
+ */
+class ZstdOutputStream : public io::CopyingOutputStream
+{
+  public:
+    ZstdOutputStream(io::ZeroCopyOutputStream* out) :
+        out(out), cstream(ZSTD_createCStream())
+    {
+        if (ZSTD_isError(ZSTD_initCStream(cstream, ZSTD_CLEVEL_DEFAULT)))
+            panic("Could not initialize the zstd compressor\n");
+    }
+
+    ~ZstdOutputStream()
+    {
+        size_t remaining;
+        do {
+            ZSTD_outBuffer output = nextOutput();
+            remaining = ZSTD_endStream(cstream, &output);
+            check(remaining);
+            out->BackUp(output.size - output.pos);
+        } while (remaining != 0);
+        ZSTD_freeCStream(cstream);
+    }
+
+    bool
+    Write(const void* buffer, int size) override
+    {
+        ZSTD_inBuffer input = { buffer, size_t(size), 0 };
+        while (input.pos < input.size) {
+            ZSTD_outBuffer output = nextOutput();
+            check(ZSTD_compressStream(cstream, &output, &input));
+            out->BackUp(output.size - output.pos);
+        }
+        return true;
+    }
+
+  private:
+    ZSTD_outBuffer
+    nextOutput()
+    {
+        void* data;
+        int size;
+        if (!out->Next(&data, &size))
+            panic("Could not write the zstd compressed stream\n");
+        return { data, size_t(size), 0 };
+    }
+
+    void
+    check(size_t result)
+    {
+        if (ZSTD_isError(result))
+            panic("zstd compression failed: %s\n",
+                  ZSTD_getErrorName(result));
+    }
+
+    io::ZeroCopyOutputStream* out;
+    ZSTD_CStream* cstream;
+};
+
+/**
+ * A copying stream decompressing the zstd frames read from a zero
+ * copy stream.
+ */
+class ZstdInputStream : public io::CopyingInputStream
+{
+  public:
+    ZstdInputStream(io::ZeroCopyInputStream* in) :
+        in(in), dstream(ZSTD_createDStream()), input{ nullptr, 0, 0 }
+    {
+        if (ZSTD_isError(ZSTD_initDStream(dstream)))
+            panic("Could not initialize the zstd decompressor\n");
+    }
+
+    ~ZstdInputStream()
+    {
+        if (input.pos < input.size)
+            in->BackUp(input.size - input.pos);
+        ZSTD_freeDStream(dstream);
+    }
+
+    int
+    Read(void* buffer, int size) override
+    {
+        ZSTD_outBuffer output = { buffer, size_t(size), 0 };
+        while (output.pos == 0) {
+            if (input.pos == input.size) {
+                const void* data;
+                int data_size;
+                if (!in->Next(&data, &data_size))
+                    return 0;
+                input = { data, size_t(data_size), 0 };
+            }
+            size_t result = ZSTD_decompressStream(dstream, &output, &input);
+            if (ZSTD_isError(result))
+                return -1;
+        }
+        return output.pos;
+    }
+
+  private:
+    io::ZeroCopyInputStream* in;
+    ZSTD_DStream* dstream;
+    ZSTD_inBuffer input;
+};
+
+#endif
+
+} // anonymous namespace
+
 ProtoOutputStream::ProtoOutputStream(const std::string& filename) :
     fileStream(filename.c_str(),
             std::ios::out | std::ios::binary | std::ios::trunc),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+    wrappedFileStream(NULL), compressStream(NULL), zeroCopyStream(NULL),
+    done(false)
 {
     if (!fileStream.good())
         panic("Could not open %s for writing\n", filename);
 
+    std::string extension;
+    if (filename.find_last_of('.') != std::string::npos)
+        extension = filename.substr(filename.find_last_of('.') + 1);
+    panic_if(!HAVE_ZSTD && extension == "zst",
+             "Cannot write %s, gem5 was built without zstd support\n",
+             filename);
+
     // Wrap the output file in a zero copy stream, that in turn is
-    // wrapped in a gzip stream if the filename ends with .gz. The
-    // latter stream is in turn wrapped in a coded stream
+    // wrapped in a gzip or zstd stream if the filename ends with .gz
+    // or .zst. The latter stream is in turn wrapped in a coded stream
     wrappedFileStream = new io::OstreamOutputStream(&fileStream);
-    if (filename.find_last_of('.') != std::string::npos &&
-        filename.substr(filename.find_last_of('.') + 1) == "gz") {
-        gzipStream = new io::GzipOutputStream(wrappedFileStream);
-        zeroCopyStream = gzipStream;
+    if (extension == "gz") {
+        compressStream = new io::GzipOutputStream(wrappedFileStream);
+        zeroCopyStream = compressStream;
+#if HAVE_ZSTD
+    } else if (extension == "zst") {
+        auto adaptor = new io::CopyingOutputStreamAdaptor(
+            new ZstdOutputStream(wrappedFileStream));
+        adaptor->SetOwnsCopyingStream(true);
+        compressStream = adaptor;
+        zeroCopyStream = compressStream;
+#endif
     } else {
         zeroCopyStream = wrappedFileStream;
     }
 
+    buffer.reserve(bufferSize);
+    pending.reserve(bufferSize);
+
     // Write the magic number to the file
-    io::CodedOutputStream codedStream(zeroCopyStream);
-    codedStream.WriteLittleEndian32(magicNumber);
+    uint8_t magic[sizeof(magicNumber)];
+    io::CodedOutputStream::WriteLittleEndian32ToArray(magicNumber, magic);
+    buffer.append(reinterpret_cast<char*>(magic), sizeof(magic));
 
     // Note that each type of stream (packet, instruction etc) should
     // add its own header and perform the appropriate checks
+
+    writer = std::thread([this]{ writeBuffers(); });
 }
 
 ProtoOutputStream::~ProtoOutputStream()
 {
+    // Write what is left in the buffer and wait for the writer
+    // thread to be done with it
+    submitBuffer();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        done = true;
+    }
+    cond.notify_all();
+    writer.join();
+
     // As the compression is optional, see if the stream exists
-    if (gzipStream != NULL)
-        delete gzipStream;
+    if (compressStream != NULL)
+        delete compressStream;
     delete wrappedFileStream;
     fileStream.close();
 }
@@ -83,35 +241,77 @@ ProtoOutputStream::~ProtoOutputStream()
 void
 ProtoOutputStream::write(const Message& msg)
 {
-    // Due to the byte limit of the coded stream we create it for
-    // every single mesage (based on forum discussions around the size
-    // limitation)
-    io::CodedOutputStream codedStream(zeroCopyStream);
-
-    // Write the size of the message to the stream
+    // Serialize the size of the message followed by the message
+    // itself at the end of the buffer
 #   if GOOGLE_PROTOBUF_VERSION < 3001000
-        auto msg_size = msg.ByteSize();
+        size_t msg_size = msg.ByteSize();
 #   else
-        auto msg_size = msg.ByteSizeLong();
+        size_t msg_size = msg.ByteSizeLong();
 #   endif
-    codedStream.WriteVarint32(msg_size);
+    const size_t size_bytes =
+        io::CodedOutputStream::VarintSize32(msg_size);
 
-    // Write the message itself to the stream
-    msg.SerializeWithCachedSizes(&codedStream);
+    const size_t offset = buffer.size();
+    buffer.resize(offset + size_bytes + msg_size);
+    uint8_t* target = reinterpret_cast<uint8_t*>(&buffer[offset]);
+    target = io::CodedOutputStream::WriteVarint32ToArray(msg_size, target);
+    msg.SerializeWithCachedSizesToArray(target);
+
+    if (buffer.size() >= bufferSize)
+        submitBuffer();
+}
+
+void
+ProtoOutputStream::submitBuffer()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    cond.wait(guard, [this]{ return pending.empty(); });
+    pending.swap(buffer);
+    cond.notify_all();
+}
+
+void
+ProtoOutputStream::writeBuffers()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        cond.wait(guard, [this]{ return done || !pending.empty(); });
+        if (pending.empty())
+            break;
+
+        // The simulation thread only touches the pending buffer once
+        // it is empty again, so it can be written without the lock
+        guard.unlock();
+        {
+            // Due to the byte limit of the coded stream we create it
+            // for every buffer
+            io::CodedOutputStream codedStream(zeroCopyStream);
+            codedStream.WriteRaw(pending.data(), pending.size());
+        }
+        guard.lock();
+
+        pending.clear();
+        cond.notify_all();
+    }
 }
 
 ProtoInputStream::ProtoInputStream(const std::string& filename) :
     fileStream(filename.c_str(), std::ios::in | std::ios::binary),
-    fileName(filename), useGzip(false),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+    fileName(filename), useGzip(false), useZstd(false),
+    wrappedFileStream(NULL), compressStream(NULL), zeroCopyStream(NULL)
 {
     if (!fileStream.good())
         panic("Could not open %s for reading\n", filename);
 
-    // check the magic number to see if this is a gzip stream
-    unsigned char bytes[2];
-    fileStream.read((char*) bytes, 2);
+    // check the magic number to see if this is a gzip or zstd stream
+    unsigned char bytes[4];
+    fileStream.read((char*) bytes, 4);
     useGzip = fileStream.good() && bytes[0] == 0x1f && bytes[1] == 0x8b;
+    useZstd = fileStream.good() &&
+        std::equal(bytes, bytes + 4, std::begin(zstdMagic));
+    panic_if(!HAVE_ZSTD && useZstd,
+             "Cannot read %s, gem5 was built without zstd support\n",
+             filename);
 
     // seek to the start of the input file and clear any flags
     fileStream.clear();
@@ -124,16 +324,24 @@ void
 ProtoInputStream::createStreams()
 {
     // All streams should be NULL at this point
-    assert(wrappedFileStream == NULL && gzipStream == NULL &&
+    assert(wrappedFileStream == NULL && compressStream == NULL &&
            zeroCopyStream == NULL);
 
     // Wrap the input file in a zero copy stream, that in turn is
-    // wrapped in a gzip stream if the filename ends with .gz. The
+    // wrapped in a gzip or zstd stream if the file is compressed. The
     // latter stream is in turn wrapped in a coded stream
     wrappedFileStream = new io::IstreamInputStream(&fileStream);
     if (useGzip) {
-        gzipStream = new io::GzipInputStream(wrappedFileStream);
-        zeroCopyStream = gzipStream;
+        compressStream = new io::GzipInputStream(wrappedFileStream);
+        zeroCopyStream = compressStream;
+#if HAVE_ZSTD
+    } else if (useZstd) {
+        auto adaptor = new io::CopyingInputStreamAdaptor(
+            new ZstdInputStream(wrappedFileStream));
+        adaptor->SetOwnsCopyingStream(true);
+        compressStream = adaptor;
+        zeroCopyStream = compressStream;
+#endif
     } else {
         zeroCopyStream = wrappedFileStream;
     }
@@ -150,9 +358,9 @@ void
 ProtoInputStream::destroyStreams()
 {
     // As the compression is optional, see if the stream exists
-    if (gzipStream != NULL) {
-        delete gzipStream;
-        gzipStream = NULL;
+    if (compressStream != NULL) {
+        delete compressStream;
+        compressStream = NULL;
     }
     delete wrappedFileStream;
     wrappedFileStream = NULL;
@@ -49,7 +49,11 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -86,6 +90,12 @@ class ProtoStream
  * basis to avoid having to deal with huge data structures. The latter
  * is made possible by encoding the length of each message in the
  * stream.
+ *
+ * Messages are serialized into a buffer, and full buffers are handed
+ * over to a background thread that compresses them and writes them to
+ * the file, so the compression does not slow down the simulation. The
+ * stream is double buffered: the caller only waits if a buffer fills
+ * up while the previous one is still being written.
  */
 class ProtoOutputStream : public ProtoStream
 {
@@ -94,7 +104,9 @@ class ProtoOutputStream : public ProtoStream
 
     /**
      * Create an output stream for a given file name. If the filename
-     * ends with .gz then the file will be compressed accordinly.
+     * ends with .gz then the file will be compressed accordinly. If
+     * it ends with .zst the file is compressed using zstd, provided
+     * gem5 was built with zstd support.
      *
      * @param filename Path to the file to create or truncate
      */
@@ -116,18 +128,49 @@ class ProtoOutputStream : public ProtoStream
 
   private:
 
+    /**
+     * Hand the current buffer over to the writer thread, waiting for
+     * the previous one to be written if needed.
+     */
+    void submitBuffer();
+
+    /**
+     * Main loop of the writer thread, compressing and writing the
+     * submitted buffers to the file.
+     */
+    void writeBuffers();
+
+    /// Size of a buffer at which it is handed to the writer thread
+    static const size_t bufferSize = 1 << 20;
+
     /// Underlying file output stream
     std::ofstream fileStream;
 
     /// Zero Copy stream wrapping the STL output stream
     google::protobuf::io::OstreamOutputStream* wrappedFileStream;
 
-    /// Optional Gzip stream to wrap the Zero Copy stream
-    google::protobuf::io::GzipOutputStream* gzipStream;
+    /// Optional compression stream to wrap the Zero Copy stream
+    google::protobuf::io::ZeroCopyOutputStream* compressStream;
 
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyOutputStream* zeroCopyStream;
 
+    /// Buffer the messages are serialized into
+    std::string buffer;
+
+    /// Buffer handed over to the writer thread
+    std::string pending;
+
+    /// Set when the writer thread should exit
+    bool done;
+
+    /// Protects pending and done
+    std::mutex lock;
+    std::condition_variable cond;
+
+    /// Thread compressing and writing the buffers
+    std::thread writer;
+
 };
 
 /**
@@ -143,8 +186,9 @@ class ProtoInputStream : public ProtoStream
   public:
 
     /**
-     * Create an input stream for a given file name. If the filename
-     * ends with .gz then the file will be decompressed accordingly.
+     * Create an input stream for a given file name. If the file
+     * is compressed using gzip, or zstd if gem5 was built with zstd
+     * support, then the file will be decompressed accordingly.
      *
      * @param filename Path to the file to read from
      */
@@ -187,14 +231,15 @@ class ProtoInputStream : public ProtoStream
     /// Hold on to the file name for debug messages
     const std::string fileName;
 
-    /// Boolean flag to remember whether we use gzip or not
+    /// Boolean flags to remember whether we use gzip, zstd or neither
     bool useGzip;
+    bool useZstd;
 
     /// Zero Copy stream wrapping the STL input stream
     google::protobuf::io::IstreamInputStream* wrappedFileStream;
 
-    /// Optional Gzip stream to wrap the Zero Copy stream
-    google::protobuf::io::GzipInputStream* gzipStream;
+    /// Optional decompression stream to wrap the Zero Copy stream
+    google::protobuf::io::ZeroCopyInputStream* compressStream;
 
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyInputStream* zeroCopyStream;
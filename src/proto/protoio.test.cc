@@ -0,0 +1,206 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <google/protobuf/wrappers.pb.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "config/have_zstd.hh"
+#include "proto/protoio.hh"
+
+using google::protobuf::StringValue;
+using google::protobuf::UInt64Value;
+
+namespace
+{
+
+/**
+ * Number of messages of a trace, enough for the output stream to hand
+ * several buffers to its writer thread.
+ */
+const uint64_t NumMessages = 400000;
+
+/** Value of the i-th message, using all the bytes of the varint. */
+uint64_t
+value(uint64_t i)
+{
+    return i * 0x9e3779b97f4a7c15ULL;
+}
+
+class ProtoIOTest : public testing::Test
+{
+  protected:
+    std::string dir;
+    std::vector<std::string> files;
+
+    void
+    SetUp() override
+    {
+        char name[] = "protoio-XXXXXX";
+        ASSERT_NE(mkdtemp(name), nullptr);
+        dir = name;
+    }
+
+    void
+    TearDown() override
+    {
+        for (const auto &file : files)
+            std::remove(file.c_str());
+        rmdir(dir.c_str());
+    }
+
+    /** Path of a file in the directory of the test. */
+    std::string
+    path(const std::string &name)
+    {
+        files.push_back(dir + "/" + name);
+        return files.back();
+    }
+
+    /** First bytes of a file. */
+    static std::string
+    head(const std::string &file, size_t size)
+    {
+        std::ifstream is(file, std::ios::binary);
+        std::string bytes(size, '\0');
+        is.read(&bytes[0], size);
+        return bytes.substr(0, is.gcount());
+    }
+
+    static void
+    writeTrace(const std::string &file)
+    {
+        ProtoOutputStream os(file);
+        UInt64Value msg;
+        for (uint64_t i = 0; i < NumMessages; ++i) {
+            msg.set_value(value(i));
+            os.write(msg);
+        }
+    }
+
+    /** Read the trace written by writeTrace, up to count messages. */
+    static void
+    checkTrace(ProtoInputStream &is, uint64_t count=NumMessages)
+    {
+        UInt64Value msg;
+        for (uint64_t i = 0; i < count; ++i) {
+            ASSERT_TRUE(is.read(msg)) << "Message " << i;
+            ASSERT_EQ(msg.value(), value(i)) << "Message " << i;
+        }
+        if (count == NumMessages) {
+            EXPECT_FALSE(is.read(msg));
+        }
+    }
+
+    /** Round-trip a trace and a message larger than a buffer. */
+    void
+    roundTrip(const std::string &name, const std::string &magic)
+    {
+        const std::string file = path(name);
+        writeTrace(file);
+        EXPECT_EQ(head(file, magic.size()), magic);
+        {
+            ProtoInputStream is(file);
+            checkTrace(is);
+        }
+
+        const std::string large_file = path("large-" + name);
+        StringValue large;
+        large.set_value(std::string(3 << 20, 'x'));
+        large.mutable_value()->back() = 'y';
+        {
+            ProtoOutputStream os(large_file);
+            os.write(large);
+            os.write(large);
+        }
+        ProtoInputStream is(large_file);
+        StringValue msg;
+        for (int i = 0; i < 2; ++i) {
+            ASSERT_TRUE(is.read(msg));
+            EXPECT_EQ(msg.value(), large.value());
+        }
+        EXPECT_FALSE(is.read(msg));
+    }
+};
+
+/** The magic number of gem5 traces, in little endian. */
+const std::string gem5Magic = "gem5";
+
+} // anonymous namespace
+
+TEST_F(ProtoIOTest, Uncompressed)
+{
+    roundTrip("trace.pb", gem5Magic);
+}
+
+TEST_F(ProtoIOTest, Gzip)
+{
+    roundTrip("trace.pb.gz", "\x1f\x8b");
+}
+
+#if HAVE_ZSTD
+
+TEST_F(ProtoIOTest, Zstd)
+{
+    roundTrip("trace.pb.zst", "\x28\xb5\x2f\xfd");
+}
+
+#else
+
+/**
+ * Without zstd, writing or reading a zstd trace fails, and the other
+ * traces are still written.
+ */
+TEST_F(ProtoIOTest, NoZstd)
+{
+    const std::string file = path("trace.pb.zst");
+    ASSERT_ANY_THROW(ProtoOutputStream os(file));
+
+    std::ofstream(file, std::ios::binary) << "\x28\xb5\x2f\xfd" << gem5Magic;
+    ASSERT_ANY_THROW(ProtoInputStream is(file));
+
+    writeTrace(path("trace.zstd"));
+    EXPECT_EQ(head(files.back(), gem5Magic.size()), gem5Magic);
+}
+
+#endif
+
+/** Resetting an input stream reads the trace again from the start. */
+TEST_F(ProtoIOTest, Reset)
+{
+    const std::string file = path("trace.pb.gz");
+    writeTrace(file);
+
+    ProtoInputStream is(file);
+    checkTrace(is, NumMessages / 3);
+    is.reset();
+    checkTrace(is);
+}
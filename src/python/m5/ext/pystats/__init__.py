@@ -31,6 +31,7 @@ from .statistic import Statistic
 from .storagetype import StorageType
 from .timeconversion import TimeConversion
 from .jsonloader import JsonLoader
+from .columnar import ColumnarReader
 
 __all__ = [
            "Group",
@@ -40,4 +41,5 @@ __all__ = [
            "StorageType",
            "JsonSerializable",
            "JsonLoader",
+           "ColumnarReader",
           ]
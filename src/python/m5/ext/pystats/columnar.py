@@ -0,0 +1,192 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Reader for the binary, columnar stat files written by the "cols://" stat
+visitor. This module only depends on the Python standard library, so it
+can be used outside of gem5.
+
+The file starts with a schema naming the columns, followed by one row
+of values per stat dump. A stat spans one column per value: scalars
+have a single column named after the stat, while the columns of the
+other stats are named "<stat>::<suffix>" (e.g., "<stat>::<subname>" for
+vector elements or "<stat>::samples" for distributions).
+"""
+
+import gzip
+import struct
+from typing import IO, Dict, Iterator, List, Union
+
+MAGIC = b"gem5cols"
+VERSION = 1
+BYTE_ORDER_MARK = 0x01020304
+
+class ColumnarStat:
+    """
+    A stat of the schema, with the names of its columns.
+    """
+
+    def __init__(self, name: str, desc: str, unit: str,
+                 suffixes: List[str]):
+        self.name = name
+        self.desc = desc
+        self.unit = unit
+        self.columns = [ name + "::" + s if s else name for s in suffixes ]
+
+class ColumnarReader:
+    """
+    Iterates over the stat dumps of a columnar stat file, each dump being
+    a dictionary from column name to value.
+
+    Usage
+    -----
+    ```
+    from m5.ext.pystats.columnar import ColumnarReader
+
+    with ColumnarReader("m5out/stats.cols") as reader:
+        for dump in reader:
+            print(dump["simTicks"])
+    ```
+    """
+
+    def __init__(self, file: Union[str, IO[bytes]]):
+        if isinstance(file, str):
+            with open(file, "rb") as f:
+                compressed = f.read(2) == b"\x1f\x8b"
+            self._file = (gzip.open if compressed else open)(file, "rb")
+            self._owned = True
+        else:
+            self._file = file
+            self._owned = False
+
+        try:
+            self._read_header()
+        except Exception:
+            self.close()
+            raise
+
+        self.stats: List[ColumnarStat] = []
+        self.columns: List[str] = []
+
+    def __enter__(self) -> "ColumnarReader":
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+    def close(self) -> None:
+        if self._owned:
+            self._file.close()
+
+    def _read_header(self) -> None:
+        if self._file.read(len(MAGIC)) != MAGIC:
+            raise ValueError("Not a columnar stat file")
+
+        # The writer uses its host byte order, try both.
+        header = self._read(8)
+        for order in "<>":
+            version, mark = struct.unpack(order + "II", header)
+            if mark == BYTE_ORDER_MARK:
+                self._order = order
+                break
+        else:
+            raise ValueError("Invalid byte order mark")
+
+        if version != VERSION:
+            raise ValueError(f"Unsupported columnar stat file version "
+                             f"{version}")
+
+    def _read(self, size: int) -> bytes:
+        data = self._file.read(size)
+        if len(data) != size:
+            raise EOFError("Truncated columnar stat file")
+        return data
+
+    def _uint(self) -> int:
+        return struct.unpack(self._order + "I", self._read(4))[0]
+
+    def _str(self) -> str:
+        return self._read(self._uint()).decode()
+
+    def _read_schema(self) -> None:
+        self.stats = []
+        for _ in range(self._uint()):
+            name = self._str()
+            desc = self._str()
+            unit = self._str()
+            suffixes = [ self._str() for _ in range(self._uint()) ]
+            self.stats.append(ColumnarStat(name, desc, unit, suffixes))
+        self.columns = [ c for stat in self.stats for c in stat.columns ]
+
+    def rows(self) -> Iterator[List[float]]:
+        """
+        Iterate over the dumps as lists of values, in the order of
+        self.columns as of the dump.
+        """
+
+        values: List[float] = []
+        while True:
+            kind = self._file.read(1)
+            if not kind:
+                return
+            elif kind == b"S":
+                self._read_schema()
+                values = [ 0.0 ] * len(self.columns)
+            elif kind == b"R":
+                count = self._uint()
+                if count != len(self.columns):
+                    raise ValueError("Row doesn't match the schema")
+                values = list(struct.unpack(f"{self._order}{count}d",
+                                            self._read(8 * count)))
+                yield values
+            elif kind == b"D":
+                count = self._uint()
+                data = self._read(12 * count)
+                # The byte order prefix also disables padding, so each
+                # entry takes 12 bytes.
+                for index, value in struct.iter_unpack(self._order + "Id",
+                                                       data):
+                    values[index] = value
+                yield list(values)
+            else:
+                raise ValueError(f"Invalid record type {kind!r}")
+
+    def __iter__(self) -> Iterator[Dict[str, float]]:
+        for values in self.rows():
+            yield dict(zip(self.columns, values))
+
+def load(file: Union[str, IO[bytes]]) -> List[Dict[str, float]]:
+    """
+    Read all the dumps of a columnar stat file.
+
+    Usage
+    -----
+    ```
+    import m5.ext.pystats as pystats
+
+    dumps = pystats.columnar.load("m5out/stats.cols")
+    ```
+    """
+
+    with ColumnarReader(file) as reader:
+        return list(reader)
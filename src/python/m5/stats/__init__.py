@@ -183,6 +183,35 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "cols", ])
+def _columnarFactory(fn, desc=True, formulas=True, delta=True):
+    """Output stats in a binary, columnar format.
+
+    The names of the stats are only written once, along with the
+    layout of their values, and each dump then appends one row holding
+    the values of all the stats. This makes periodic dumps much smaller
+    and faster to write and parse than text dumps. Files with a .gz
+    extension are compressed.
+
+    Known limitations:
+      * Sparse histograms currently unsupported.
+      * Stats hidden by a prerequisite are still dumped.
+
+    The m5.ext.pystats.columnar module reads these files.
+
+    Parameters:
+      * desc (bool): Output stat descriptions (default: True)
+      * formulas (bool): Output derived stats (default: True)
+      * delta (bool): Only store the values that changed since the
+        previous dump when that is smaller (default: True)
+
+    Example:
+      cols://stats.cols?desc=False;delta=False
+
+    """
+
+    return _m5.stats.initColumnar(fn, desc, formulas, delta)
+
 @_url_factory(["json"])
 def _jsonFactory(fn):
     """Output stats in JSON format.
@@ -242,6 +271,38 @@ def printStatVisitorTypes():
         # Try to extract the factory doc string
         print_doc(inspect.getdoc(factory))
 
+def startSampling(fn, period, patterns, buffer_rows=65536):
+    """Periodically sample the raw values of a few stats
+
+    Sampling is much cheaper than dumping the stats periodically: a
+    single event copies the values of the selected stats into an
+    in-memory buffer, which a helper thread writes to a columnar stat
+    file in the background. The m5.ext.pystats.columnar module reads
+    these files. Counters aren't reset between samples and formulas
+    can't be sampled, so rates are computed from the differences
+    between consecutive samples of their operands. This must be called
+    after m5.instantiate(), and replaces any sampling in progress.
+
+    Parameters:
+      * fn (str): Output file, compressed if its name ends in .gz
+      * period (int): Sampling period in ticks
+      * patterns (list of str): Regular expressions selecting the
+        stats to sample by their full name, as printed in stats.txt
+      * buffer_rows (int): Number of samples buffered in memory
+
+    Example:
+      m5.stats.startSampling("samples.cols", m5.ticks.fromSeconds(10e-6),
+          [ "system.cpu.(numCycles|committedInsts)" ])
+
+    """
+
+    _m5.stats.startSampling(fn, period, list(patterns), buffer_rows)
+
+def stopSampling():
+    """Stop sampling stats, and write the pending samples"""
+
+    _m5.stats.stopSampling()
+
 def initSimStats():
     _m5.stats.initSimStats()
     _m5.stats.registerPythonStatsHandlers()
@@ -257,6 +318,11 @@ def _visit_stats(visitor, root=None):
     def for_each_stat(g):
         for stat in g.getStats():
             visitor(g, stat)
+    if root is None:
+        root = Root.getInstance()
+    # The stats of the root itself, including the global ones merged
+    # into it, are not in any of its groups
+    for_each_stat(root)
     _visit_groups(for_each_stat, root=root)
 
 def _bindStatHierarchy(root):
@@ -30,6 +30,9 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.util import fatal
 
+class EventQueueEngine(ScopedEnum):
+    vals = ['linear', 'calendar']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -67,6 +70,31 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Adaptive simulation quantum. The quantum is doubled after a quantum
+    # in which few events crossed event queues and halved after one in
+    # which many did. sim_quantum_max must not exceed the smallest latency
+    # of any event scheduled across event queues.
+    sim_quantum_adaptive = Param.Bool(False,
+        "adapt the simulation quantum to the cross-queue traffic")
+    sim_quantum_min = Param.Tick(0,
+        "smallest adaptive simulation quantum (0: sim_quantum)")
+    sim_quantum_max = Param.Tick(0,
+        "largest adaptive simulation quantum (0: sim_quantum)")
+    sim_quantum_low_traffic = Param.Counter(16,
+        "grow the quantum below this many cross-queue events per quantum")
+    sim_quantum_high_traffic = Param.Counter(256,
+        "shrink the quantum above this many cross-queue events per quantum")
+
+    # Data structure used by the main event queues to keep events sorted.
+    # The calendar queue scales better with thousands of pending events.
+    eventq_engine = Param.EventQueueEngine('linear',
+        "data structure used to sort events on the main event queues")
+
+    # Allocate the packets, their data buffers and the requests created
+    # by the caches from per-thread pools instead of the heap.
+    mem_pools = Param.Bool(False,
+        "allocate packets and requests from per-thread pools")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
@@ -75,6 +75,21 @@ class System(SimObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # Checkpointing a large memory to a single compressed file is bound
+    # by the speed of a single core. When a chunk size is set, each
+    # backing store is instead split into chunks of that size which are
+    # compressed (and decompressed on restore) in parallel.
+    memory_checkpoint_chunk_size = Param.MemorySize("0", "checkpoint the "
+        "backing stores in chunks of this size (0: single file per store)")
+    memory_checkpoint_threads = Param.Unsigned(0, "threads compressing the "
+        "memory checkpoint chunks (0: one per host core)")
+
+    # Sparse memory checkpoints only hold the pages with non-zero bytes.
+    # The zero pages are not touched when restoring, so combined with
+    # mmap_using_noreserve only the pages in use are backed by the host.
+    memory_checkpoint_sparse = Param.Bool(False, "only checkpoint the "
+        "memory pages holding non-zero bytes")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
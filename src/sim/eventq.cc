@@ -30,6 +30,7 @@
 
 #include "sim/eventq.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <mutex>
@@ -46,6 +47,9 @@ namespace gem5
 {
 
 Tick simQuantum = 0;
+AdaptiveQuantum adaptiveSimQuantum;
+
+EventQueue::Engine EventQueue::defaultEngine = EventQueue::Engine::Linear;
 
 //
 // Main Event Queues
@@ -111,6 +115,15 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (_engine == Engine::Calendar) {
+        calendar.insert(event);
+        // If the event joined the bin of the head, it is now the top
+        // of that bin and thus the new head.
+        if (!head || *event <= *head)
+            head = event;
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -170,6 +183,13 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (_engine == Engine::Calendar) {
+        calendar.remove(event);
+        if (event == head)
+            head = calendar.first();
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -202,7 +222,10 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (_engine == Engine::Calendar) {
+        calendar.remove(event);
+        head = calendar.first();
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -292,18 +315,15 @@ EventQueue::dump() const
     cprintf("EventQueue Dump  (cycle %d)\n", curTick());
     cprintf("------------------------------------------------------------\n");
 
-    if (empty())
+    if (empty()) {
         cprintf("<No Events>\n");
-    else {
-        Event *nextBin = head;
-        while (nextBin) {
-            Event *nextInBin = nextBin;
+    } else {
+        for (Event *bin : bins()) {
+            Event *nextInBin = bin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -318,9 +338,8 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
-        Event *nextInBin = nextBin;
+    for (Event *bin : bins()) {
+        Event *nextInBin = bin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
                 cprintf("time goes backwards!");
@@ -345,21 +364,57 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
 }
 
+std::vector<Event *>
+EventQueue::bins() const
+{
+    if (_engine == Engine::Calendar)
+        return calendar.sortedBins();
+
+    std::vector<Event *> list;
+    for (Event *bin = head; bin; bin = bin->nextBin)
+        list.push_back(bin);
+    return list;
+}
+
 Event*
 EventQueue::replaceHead(Event* s)
 {
     Event* t = head;
-    head = s;
+    if (_engine == Engine::Calendar) {
+        // The calendar doesn't link its bins into a single list, so
+        // hand the current events out as one and index the new ones.
+        t = calendar.flatten();
+        calendar.merge(s);
+        head = calendar.first();
+    } else {
+        head = s;
+    }
     return t;
 }
 
+void
+EventQueue::engine(Engine e)
+{
+    if (e == _engine)
+        return;
+
+    Event *list = head;
+    if (_engine == Engine::Calendar)
+        list = calendar.flatten();
+
+    _engine = e;
+    head = list;
+    if (_engine == Engine::Calendar) {
+        calendar.merge(list);
+        head = calendar.first();
+    }
+}
+
 void
 dumpMainQueue()
 {
@@ -416,30 +471,278 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), _engine(defaultEngine),
+      async_queue(nullptr), asyncInsertionCount(0), barrierWaitSeconds(0)
+{
+}
+
+EventCalendar::EventCalendar()
+    : buckets(minBuckets, nullptr), widthShift(0), numBins(0),
+      curBucket(0), curDay(0), numMisses(0)
 {
 }
 
+void
+EventCalendar::insert(Event *event)
+{
+    Event *prev = nullptr;
+    Event *curr = buckets[bucketOf(event->when())];
+    while (curr && *curr < *event) {
+        prev = curr;
+        curr = curr->nextBin;
+    }
+
+    bool new_bin = !curr || *event < *curr;
+    Event *top = Event::insertBefore(event, curr);
+    if (prev)
+        prev->nextBin = top;
+    else
+        buckets[bucketOf(event->when())] = top;
+
+    // Keep the search cursor at or before the earliest bin.
+    if (numBins == 0 || (event->when() >> widthShift) < curDay)
+        setCursor(event->when());
+
+    if (new_bin && ++numBins > 2 * buckets.size())
+        resize(2 * buckets.size());
+}
+
+void
+EventCalendar::insertBin(Event *top)
+{
+    Event *prev = nullptr;
+    Event *curr = buckets[bucketOf(top->when())];
+    while (curr && *curr < *top) {
+        prev = curr;
+        curr = curr->nextBin;
+    }
+    assert(!curr || *curr != *top);
+
+    top->nextBin = curr;
+    if (prev)
+        prev->nextBin = top;
+    else
+        buckets[bucketOf(top->when())] = top;
+}
+
+void
+EventCalendar::remove(Event *event)
+{
+    Event *prev = nullptr;
+    Event *curr = buckets[bucketOf(event->when())];
+    while (curr && *curr < *event) {
+        prev = curr;
+        curr = curr->nextBin;
+    }
+
+    if (!curr || *curr != *event)
+        panic("event not found!");
+
+    bool last_in_bin = event == curr && !curr->nextInBin;
+    Event *top = Event::removeItem(event, curr);
+    if (prev)
+        prev->nextBin = top;
+    else
+        buckets[bucketOf(event->when())] = top;
+
+    if (last_in_bin && --numBins < buckets.size() / 4 &&
+            buckets.size() > minBuckets) {
+        resize(buckets.size() / 2);
+    }
+}
+
+Event *
+EventCalendar::first()
+{
+    if (numBins == 0)
+        return nullptr;
+
+    // Walk the calendar one day at a time starting from the cursor. The
+    // head of a bucket is the earliest bin in that bucket, so the first
+    // one that falls in the current day is the earliest bin overall.
+    size_t bucket = curBucket;
+    Tick day = curDay;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        Event *top = buckets[bucket];
+        if (top && (top->when() >> widthShift) == day) {
+            curBucket = bucket;
+            curDay = day;
+            return top;
+        }
+        bucket = (bucket + 1) & (buckets.size() - 1);
+        ++day;
+    }
+
+    // Nothing within a year of the cursor. If this keeps happening the
+    // bucket width doesn't match the spacing of the events anymore, so
+    // re-estimate it. Otherwise fall back to a direct search of the
+    // bucket heads.
+    if (++numMisses > buckets.size()) {
+        resize(buckets.size());
+        return buckets[curBucket];
+    }
+
+    Event *earliest = nullptr;
+    for (Event *top : buckets) {
+        if (top && (!earliest || *top < *earliest))
+            earliest = top;
+    }
+    setCursor(earliest->when());
+    return earliest;
+}
+
+void
+EventCalendar::collectBins(std::vector<Event *> &bins) const
+{
+    bins.reserve(bins.size() + numBins);
+    for (Event *top : buckets) {
+        for (; top; top = top->nextBin)
+            bins.push_back(top);
+    }
+}
+
+std::vector<Event *>
+EventCalendar::sortedBins() const
+{
+    std::vector<Event *> bins;
+    collectBins(bins);
+    std::sort(bins.begin(), bins.end(),
+              [](const Event *l, const Event *r) { return *l < *r; });
+    return bins;
+}
+
+Event *
+EventCalendar::flatten()
+{
+    std::vector<Event *> bins = sortedBins();
+    Event *list = nullptr;
+    for (auto it = bins.rbegin(); it != bins.rend(); ++it) {
+        (*it)->nextBin = list;
+        list = *it;
+    }
+
+    std::fill(buckets.begin(), buckets.end(), nullptr);
+    numBins = 0;
+    return list;
+}
+
+void
+EventCalendar::merge(Event *list)
+{
+    const bool was_empty = empty();
+    Event *earliest = nullptr;
+    while (list) {
+        Event *next = list->nextBin;
+        if (!earliest || *list < *earliest)
+            earliest = list;
+        insertBin(list);
+        if (++numBins > 2 * buckets.size())
+            resize(2 * buckets.size());
+        list = next;
+    }
+
+    if (earliest &&
+            (was_empty || (earliest->when() >> widthShift) < curDay)) {
+        setCursor(earliest->when());
+    }
+}
+
+void
+EventCalendar::resize(size_t num_buckets)
+{
+    std::vector<Event *> bins;
+    collectBins(bins);
+
+    // Estimate the bucket width from the average separation of the
+    // earliest bins, ignoring outliers such as far-future events, so
+    // that a year of the new calendar covers the dense part of the
+    // queue.
+    const size_t samples = std::min<size_t>(bins.size(), 25);
+    std::partial_sort(bins.begin(), bins.begin() + samples, bins.end(),
+                      [](const Event *l, const Event *r) {
+                          return *l < *r;
+                      });
+
+    Tick width = 1;
+    if (samples > 1) {
+        Tick span = bins[samples - 1]->when() - bins[0]->when();
+        Tick avg = span / (samples - 1);
+        Tick sum = 0;
+        size_t count = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            Tick gap = bins[i]->when() - bins[i - 1]->when();
+            if (gap <= 2 * avg) {
+                sum += gap;
+                ++count;
+            }
+        }
+        if (count && sum) {
+            Tick gap = sum / count;
+            width = gap > MaxTick / 3 ? MaxTick : 3 * gap;
+        }
+    }
+
+    widthShift = 0;
+    while (widthShift < 63 && (Tick(1) << widthShift) < width)
+        ++widthShift;
+
+    buckets.assign(num_buckets, nullptr);
+    numMisses = 0;
+    for (Event *top : bins)
+        insertBin(top);
+
+    if (!bins.empty())
+        setCursor(bins[0]->when());
+}
+
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex.lock();
-    async_queue.push_back(event);
-    async_queue_mutex.unlock();
+    Event *top = async_queue.load(std::memory_order_relaxed);
+    do {
+        event->nextBin = top;
+    } while (!async_queue.compare_exchange_weak(top, event,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
 }
 
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex.lock();
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    Event *stack = async_queue.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack holds the most recent insertion first. Reverse it so
+    // events are inserted in the order they were scheduled, which
+    // keeps global events in the same total order on every queue.
+    Event *list = nullptr;
+    while (stack) {
+        Event *next = stack->nextBin;
+        stack->nextBin = list;
+        list = stack;
+        stack = next;
+    }
+
+    while (list) {
+        Event *next = list->nextBin;
+        if (!list->globalEvent())
+            ++asyncInsertionCount;
+        insert(list);
+        list = next;
     }
+}
 
-    async_queue_mutex.unlock();
+Counter
+EventQueue::pendingAsyncInsertions() const
+{
+    Counter count = 0;
+    for (Event *event = async_queue.load(std::memory_order_acquire);
+         event; event = event->nextBin) {
+        if (!event->globalEvent())
+            ++count;
+    }
+    return count;
 }
 
 } // namespace gem5
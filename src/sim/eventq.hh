@@ -36,6 +36,7 @@
 #define __SIM_EVENTQ_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <functional>
@@ -43,6 +44,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
@@ -56,6 +58,7 @@ namespace gem5
 {
 
 class EventQueue;       // forward declaration
+class EventCalendar;
 class BaseGlobalEvent;
 
 //! Simulation Quantum for multiple eventq simulation.
@@ -65,6 +68,22 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Adaptive simulation quantum for multiple eventq simulation. When
+//! enabled, the quantum is doubled (up to max) after a quantum during
+//! which fewer than lowTraffic events were scheduled across queues, and
+//! halved (down to min) after one during which more than highTraffic
+//! were. The max quantum must still respect the latency constraint of
+//! simQuantum for all events scheduled across queues.
+struct AdaptiveQuantum
+{
+    bool enabled = false;
+    Tick min = 0;
+    Tick max = 0;
+    Counter lowTraffic = 0;
+    Counter highTraffic = 0;
+};
+extern AdaptiveQuantum adaptiveSimQuantum;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -251,6 +270,7 @@ class EventBase
 class Event : public EventBase, public Serializable
 {
     friend class EventQueue;
+    friend class EventCalendar;
 
   private:
     // The event queue is now a linked list of linked lists.  The
@@ -581,6 +601,98 @@ operator!=(const Event &l, const Event &r)
     return l.when() != r.when() || l.priority() != r.priority();
 }
 
+/**
+ * Calendar queue index for the bins of an EventQueue.
+ *
+ * The calendar is an array of buckets, each covering a power-of-two
+ * range of ticks (a "day"). A bin with a given when() is stored in
+ * bucket (when / width) % numBuckets, so the calendar wraps around
+ * once every "year" of numBuckets * width ticks. Within a bucket,
+ * bins are kept in a sorted list linked through Event::nextBin and
+ * the events of a bin are kept in the same LIFO stack (nextInBin) as
+ * the linear event queue, so the service order is identical.
+ *
+ * The number of buckets is kept proportional to the number of bins
+ * and the bucket width is re-estimated from the spacing of the
+ * earliest bins whenever the calendar is resized. This keeps the
+ * bucket lists short, which makes insertion, removal and finding the
+ * next bin O(1) amortized (R. Brown, "Calendar Queues: A Fast O(1)
+ * Priority Queue Implementation for the Simulation Event Set
+ * Problem", CACM 1988).
+ */
+class EventCalendar
+{
+  private:
+    /** Bucket heads, each one a sorted list of bins. */
+    std::vector<Event *> buckets;
+
+    /** log2 of the number of ticks covered by a bucket. */
+    unsigned widthShift;
+
+    /** Number of bins (distinct when+priority pairs) stored. */
+    size_t numBins;
+
+    /** Bucket of the last bin returned by first(). */
+    size_t curBucket;
+
+    /** Day (when / width) covered by curBucket. */
+    Tick curDay;
+
+    /** Searches that found no bin within a year since the last resize. */
+    size_t numMisses;
+
+    static constexpr size_t minBuckets = 16;
+
+    size_t
+    bucketOf(Tick when) const
+    {
+        return (when >> widthShift) & (buckets.size() - 1);
+    }
+
+    /** Move the search cursor to the day containing the given tick. */
+    void
+    setCursor(Tick when)
+    {
+        curBucket = bucketOf(when);
+        curDay = when >> widthShift;
+    }
+
+    /** Link a complete bin (top of its LIFO stack) into its bucket. */
+    void insertBin(Event *top);
+
+    /** Collect the tops of all bins, in no particular order. */
+    void collectBins(std::vector<Event *> &bins) const;
+
+    /** Redistribute all bins over a calendar with the given size. */
+    void resize(size_t num_buckets);
+
+  public:
+    EventCalendar();
+
+    bool empty() const { return numBins == 0; }
+
+    /** Insert an event, creating its bin if needed. */
+    void insert(Event *event);
+
+    /** Remove an event, dropping its bin if it becomes empty. */
+    void remove(Event *event);
+
+    /** Return the top of the earliest bin, or nullptr if empty. */
+    Event *first();
+
+    /** Return the tops of all bins in service order. */
+    std::vector<Event *> sortedBins() const;
+
+    /**
+     * Empty the calendar and return its contents as the linked list of
+     * bins used by the linear event queue.
+     */
+    Event *flatten();
+
+    /** Add all bins of a linked list of bins to the calendar. */
+    void merge(Event *list);
+};
+
 /**
  * Queue of events sorted in time order
  *
@@ -621,6 +733,23 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue
 {
+  public:
+    /**
+     * Data structure used to keep events sorted. The linear engine
+     * walks a linked list of bins on every insertion and removal,
+     * which is cheap for short queues. The calendar engine keeps the
+     * bins in an EventCalendar, which scales to queues with thousands
+     * of outstanding events.
+     */
+    enum class Engine
+    {
+        Linear,
+        Calendar
+    };
+
+    /** Engine used by newly created event queues. */
+    static Engine defaultEngine;
+
   private:
     friend void curEventQueue(EventQueue *);
 
@@ -628,11 +757,27 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    UncontendedMutex async_queue_mutex;
+    Engine _engine;
+
+    //! Bin index used by the calendar engine.
+    EventCalendar calendar;
+
+    /**
+     * Events added by other threads to this event queue. This is a
+     * lock-free stack linked through Event::nextBin, which is unused
+     * until the event is inserted in the queue. Any number of threads
+     * can push to it concurrently, and the owning thread takes the
+     * whole stack at once when draining it, so it never needs a lock.
+     */
+    std::atomic<Event *> async_queue;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! Number of events from other threads merged into this queue,
+    //! not counting the local events of global events.
+    Counter asyncInsertionCount;
+
+    //! Host time the thread servicing this queue has spent waiting for
+    //! other threads in global barriers.
+    double barrierWaitSeconds;
 
     /**
      * Lock protecting event handling.
@@ -666,6 +811,9 @@ class EventQueue
     //! owning thread, should call this function instead of insert().
     void asyncInsert(Event *event);
 
+    //! Return the top event of every bin in service order.
+    std::vector<Event *> bins() const;
+
     EventQueue(const EventQueue &);
 
   public:
@@ -755,6 +903,13 @@ class EventQueue
     void name(const std::string &st) { objName = st; }
     /** @}*/ //end of api_eventq group
 
+    /**
+     * Get or change the engine used to keep the events sorted. Events
+     * that are already scheduled are moved to the new engine.
+     */
+    Engine engine() const { return _engine; }
+    void engine(Engine e);
+
     /**
      * Schedule the given event on this queue. Safe to call from any thread.
      *
@@ -912,6 +1067,28 @@ class EventQueue
      */
     void handleAsyncInsertions();
 
+    /**
+     * Number of events scheduled on this queue by other threads, not
+     * counting global events. Only updated by the thread servicing the
+     * queue when it merges the async_queue.
+     */
+    Counter asyncInsertions() const { return asyncInsertionCount; }
+
+    /**
+     * Number of events scheduled on this queue by other threads that
+     * are still waiting in the async_queue, not counting global events.
+     * Only valid while no other thread can schedule events, e.g., while
+     * processing a global event.
+     */
+    Counter pendingAsyncInsertions() const;
+
+    /**
+     * Host time, in seconds, spent waiting for other threads in global
+     * barriers by the thread servicing this queue.
+     */
+    double barrierWaitTime() const { return barrierWaitSeconds; }
+    void addBarrierWaitTime(double seconds) { barrierWaitSeconds += seconds; }
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
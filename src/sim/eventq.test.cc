@@ -0,0 +1,249 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Synthetic event load modelled after a many-core system: a set of
+ * clocked objects that tick every cycle, short-latency responses
+ * (caches, DRAM), and a few far-future events such as DRAM refresh.
+ * Every event that fires reschedules itself using a random number
+ * generator owned by the workload, so two workloads driven with the
+ * same seed only see the same events if their queues service events
+ * in the same order.
+ */
+class Workload
+{
+  private:
+    EventQueue queue;
+    std::mt19937_64 rng;
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    std::vector<Tick> periods;
+
+  public:
+    /** Ids of the events in the order they were serviced. */
+    std::vector<int> trace;
+
+    Workload(EventQueue::Engine engine, size_t num_events)
+        : queue("test_queue"), rng(0x5eed)
+    {
+        queue.engine(engine);
+
+        for (size_t i = 0; i < num_events; ++i) {
+            const int id = i;
+            // Clocks of 500, 333 and 250 ticks, a mix of response
+            // latencies and one refresh-like event in sixty-four.
+            Tick period;
+            if (i % 64 == 0)
+                period = 7800000;
+            else if (i % 4 == 3)
+                period = 0;
+            else
+                period = (i % 4 == 0) ? 500 : (i % 4 == 1) ? 333 : 250;
+            periods.push_back(period);
+
+            events.emplace_back(new EventFunctionWrapper(
+                [this, id]{ fire(id); }, "test_event", false,
+                Event::Default_Pri + (id % 3) - 1));
+        }
+
+        for (size_t i = 0; i < num_events; ++i)
+            queue.schedule(events[i].get(), nextTick(i));
+    }
+
+    ~Workload()
+    {
+        while (!queue.empty())
+            queue.deschedule(queue.getHead());
+    }
+
+    Tick
+    nextTick(int id)
+    {
+        if (periods[id])
+            return queue.getCurTick() + periods[id];
+        return queue.getCurTick() + 10 + rng() % 1000;
+    }
+
+    void
+    fire(int id)
+    {
+        trace.push_back(id);
+        queue.schedule(events[id].get(), nextTick(id));
+
+        // Occasionally cancel and move another event, as done when
+        // a request is squashed or a clocked object is woken early.
+        if (rng() % 16 == 0) {
+            const int other = rng() % events.size();
+            if (other != id && events[other]->scheduled()) {
+                queue.reschedule(events[other].get(),
+                                 queue.getCurTick() + rng() % 2000);
+            }
+        }
+    }
+
+    void
+    run(size_t count)
+    {
+        for (size_t i = 0; i < count && !queue.empty(); ++i)
+            queue.serviceOne();
+    }
+
+    EventQueue &getQueue() { return queue; }
+};
+
+} // anonymous namespace
+
+/** Both engines must service events in exactly the same order. */
+TEST(EventQueueTest, CalendarMatchesLinear)
+{
+    for (size_t num_events : { 1, 7, 100, 1000 }) {
+        Workload linear(EventQueue::Engine::Linear, num_events);
+        Workload calendar(EventQueue::Engine::Calendar, num_events);
+
+        linear.run(50000);
+        calendar.run(50000);
+
+        ASSERT_TRUE(calendar.getQueue().debugVerify());
+        ASSERT_EQ(linear.trace, calendar.trace);
+    }
+}
+
+/** Events in the same bin are serviced in LIFO order. */
+TEST(EventQueueTest, CalendarBinIsLifo)
+{
+    EventQueue queue("test_queue");
+    queue.engine(EventQueue::Engine::Calendar);
+
+    std::vector<int> trace;
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    for (int i = 0; i < 4; ++i) {
+        events.emplace_back(new EventFunctionWrapper(
+            [&trace, i]{ trace.push_back(i); }, "test_event"));
+    }
+
+    queue.schedule(events[0].get(), 100);
+    queue.schedule(events[1].get(), 100);
+    queue.schedule(events[2].get(), 50);
+    queue.schedule(events[3].get(), 100);
+    queue.deschedule(events[1].get());
+
+    while (!queue.empty())
+        queue.serviceOne();
+
+    ASSERT_EQ(trace, std::vector<int>({ 2, 3, 0 }));
+}
+
+/** Switching engines and replacing the head keep the pending events. */
+TEST(EventQueueTest, EngineSwitch)
+{
+    Workload reference(EventQueue::Engine::Linear, 100);
+    Workload switched(EventQueue::Engine::Linear, 100);
+
+    reference.run(20000);
+    switched.run(5000);
+    switched.getQueue().engine(EventQueue::Engine::Calendar);
+    switched.run(5000);
+
+    // Temporarily run with an empty queue, as done by Ruby warmup.
+    Event *saved = switched.getQueue().replaceHead(nullptr);
+    ASSERT_TRUE(switched.getQueue().empty());
+    switched.getQueue().replaceHead(saved);
+
+    switched.run(5000);
+    switched.getQueue().engine(EventQueue::Engine::Linear);
+    switched.run(5000);
+
+    ASSERT_EQ(reference.trace, switched.trace);
+}
+
+/**
+ * Events scheduled concurrently from other threads end up in the queue
+ * once it drains its asynchronous inbox, in the order each thread
+ * scheduled them, and are counted as pending until then.
+ */
+TEST(EventQueueTest, AsyncInsertions)
+{
+    const int num_threads = 4;
+    const int num_events = 10000;
+
+    EventQueue queue("test_queue");
+    std::vector<int> trace;
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    for (int i = 0; i < num_threads * num_events; ++i) {
+        events.emplace_back(new EventFunctionWrapper(
+            [&trace, i]{ trace.push_back(i); }, "test_event"));
+    }
+
+    EventQueue *saved_queue = curEventQueue();
+    inParallelMode = true;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]{
+            // All events of a thread share a bin, so the service order
+            // within the bin is the reverse of the scheduling order.
+            for (int i = 0; i < num_events; ++i)
+                queue.schedule(events[t * num_events + i].get(), t + 1);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    inParallelMode = false;
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(queue.asyncInsertions(), 0);
+    ASSERT_EQ(queue.pendingAsyncInsertions(), num_threads * num_events);
+
+    curEventQueue(&queue);
+    queue.handleAsyncInsertions();
+    curEventQueue(saved_queue);
+    ASSERT_TRUE(queue.debugVerify());
+    ASSERT_EQ(queue.asyncInsertions(), num_threads * num_events);
+    ASSERT_EQ(queue.pendingAsyncInsertions(), 0);
+
+    while (!queue.empty())
+        queue.serviceOne();
+
+    ASSERT_EQ(trace.size(), size_t(num_threads * num_events));
+    for (int t = 0; t < num_threads; ++t) {
+        for (int i = 0; i < num_events; ++i) {
+            ASSERT_EQ(trace[t * num_events + i],
+                      t * num_events + num_events - 1 - i);
+        }
+    }
+}
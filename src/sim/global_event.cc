@@ -137,6 +137,7 @@ GlobalEvent::BarrierEvent::process()
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
     globalBarrier();
+    commitWaitTime();
 }
 
 
@@ -151,6 +152,7 @@ GlobalSyncEvent::BarrierEvent::process()
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
     globalBarrier();
+    commitWaitTime();
     curEventQueue()->handleAsyncInsertions();
 }
 
@@ -30,6 +30,7 @@
 #ifndef __SIM_GLOBAL_EVENT_HH__
 #define __SIM_GLOBAL_EVENT_HH__
 
+#include <chrono>
 #include <mutex>
 #include <vector>
 
@@ -81,8 +82,11 @@ class BaseGlobalEvent : public EventBase
       protected:
         BaseGlobalEvent *_globalEvent;
 
+        //! Host time spent in the barriers of the current global event.
+        double waitTime;
+
         BarrierEvent(BaseGlobalEvent *global_event, Priority p, Flags f)
-            : Event(p, f), _globalEvent(global_event)
+            : Event(p, f), _globalEvent(global_event), waitTime(0)
         {
         }
 
@@ -101,7 +105,23 @@ class BaseGlobalEvent : public EventBase
             // while waiting on the barrier to prevent deadlocks if
             // another thread wants to lock the event queue.
             EventQueue::ScopedRelease release(curEventQueue());
-            return _globalEvent->barrier.wait();
+            auto start = std::chrono::steady_clock::now();
+            bool last = _globalEvent->barrier.wait();
+            waitTime += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+            return last;
+        }
+
+        /**
+         * Account the time spent in the barriers to the event queue.
+         * This must be called after the final barrier of the global
+         * event, where no other thread may be reading the statistics.
+         */
+        void
+        commitWaitTime()
+        {
+            curEventQueue()->addBarrierWaitTime(waitTime);
+            waitTime = 0;
         }
 
       public:
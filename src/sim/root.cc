@@ -39,10 +39,16 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <array>
+
+#include "base/block_pool.hh"
 #include "base/hostinfo.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/TimeSync.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
 #include "sim/eventq.hh"
@@ -56,6 +62,20 @@ Root *Root::_root = NULL;
 Root::RootStats Root::RootStats::instance;
 Root::RootStats &rootStats = Root::RootStats::instance;
 
+namespace
+{
+
+/** Pools of the objects created for every memory access. */
+const std::array<BlockPool *, 3> &
+memPools()
+{
+    static const std::array<BlockPool *, 3> pools{
+        &Packet::pool, &Packet::dataPool, &Request::pool};
+    return pools;
+}
+
+} // anonymous namespace
+
 Root::RootStats::RootStats()
     : statistics::Group(nullptr),
     ADD_STAT(simSeconds, statistics::units::Second::get(),
@@ -75,6 +95,22 @@ Root::RootStats::RootStats()
              "The number of ticks simulated per host second (ticks/s)"),
     ADD_STAT(hostMemory, statistics::units::Byte::get(),
              "Number of bytes of host memory used"),
+    ADD_STAT(simQuantum, statistics::units::Tick::get(),
+             "Current simulation quantum of the parallel event queues"),
+    ADD_STAT(barrierWaitTime, statistics::units::Second::get(),
+             "Real time each event queue thread waited on other threads "
+             "in global barriers"),
+    ADD_STAT(asyncInsertions, statistics::units::Count::get(),
+             "Number of events scheduled on each event queue by other "
+             "threads"),
+    ADD_STAT(memPoolAllocations, statistics::units::Count::get(),
+             "Number of allocations from each memory object pool"),
+    ADD_STAT(memPoolHits, statistics::units::Count::get(),
+             "Number of allocations served by the free lists of each "
+             "memory object pool"),
+    ADD_STAT(memPoolHitRate, statistics::units::Ratio::get(),
+             "Fraction of the allocations served by the free lists of "
+             "each memory object pool"),
 
     statTime(true),
     startTick(0)
@@ -101,6 +137,48 @@ Root::RootStats::RootStats()
 
     simSeconds = simTicks / simFreq;
     hostTickRate = simTicks / hostSeconds;
+
+    simQuantum.functor([]() { return ::gem5::simQuantum; });
+}
+
+void
+Root::RootStats::regStats()
+{
+    statistics::Group::regStats();
+
+    // All event queues have been created by the time the stats are
+    // registered since SimObjects allocate them when constructed.
+    const uint32_t num_queues = std::max<uint32_t>(numMainEventQueues, 1);
+    barrierWaitTime
+        .init(num_queues)
+        .precision(2)
+        .flags(statistics::nozero)
+        ;
+    asyncInsertions
+        .init(num_queues)
+        .flags(statistics::nozero)
+        ;
+    waitTimeBase.assign(num_queues, 0);
+    insertionsBase.assign(num_queues, 0);
+
+    const auto &pools = memPools();
+    memPoolAllocations
+        .init(pools.size())
+        .flags(statistics::nozero)
+        ;
+    memPoolHits
+        .init(pools.size())
+        .flags(statistics::nozero)
+        ;
+    memPoolHitRate = memPoolHits / memPoolAllocations;
+    memPoolHitRate.flags(statistics::nozero | statistics::nonan);
+    for (size_t i = 0; i < pools.size(); ++i) {
+        memPoolAllocations.subname(i, pools[i]->name());
+        memPoolHits.subname(i, pools[i]->name());
+        memPoolHitRate.subname(i, pools[i]->name());
+    }
+    poolAllocationsBase.assign(pools.size(), 0);
+    poolHitsBase.assign(pools.size(), 0);
 }
 
 void
@@ -110,6 +188,41 @@ Root::RootStats::resetStats()
     startTick = curTick();
 
     statistics::Group::resetStats();
+
+    for (uint32_t i = 0; i < waitTimeBase.size() &&
+             i < numMainEventQueues; ++i) {
+        waitTimeBase[i] = mainEventQueue[i]->barrierWaitTime();
+        insertionsBase[i] = mainEventQueue[i]->asyncInsertions();
+    }
+
+    const auto &pools = memPools();
+    for (size_t i = 0; i < poolAllocationsBase.size(); ++i) {
+        poolAllocationsBase[i] = pools[i]->allocations();
+        poolHitsBase[i] = pools[i]->reuses();
+    }
+}
+
+void
+Root::RootStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    // The per-queue counters are only updated by their threads outside
+    // of global events, so they are stable while the stats are dumped.
+    for (uint32_t i = 0; i < waitTimeBase.size() &&
+             i < numMainEventQueues; ++i) {
+        barrierWaitTime[i] =
+            mainEventQueue[i]->barrierWaitTime() - waitTimeBase[i];
+        asyncInsertions[i] =
+            mainEventQueue[i]->asyncInsertions() - insertionsBase[i];
+    }
+
+    const auto &pools = memPools();
+    for (size_t i = 0; i < poolAllocationsBase.size(); ++i) {
+        memPoolAllocations[i] =
+            pools[i]->allocations() - poolAllocationsBase[i];
+        memPoolHits[i] = pools[i]->reuses() - poolHitsBase[i];
+    }
 }
 
 /*
@@ -188,6 +301,33 @@ Root::Root(const RootParams &p, int)
 
     simQuantum = p.sim_quantum;
 
+    for (auto *pool : memPools())
+        pool->enable(p.mem_pools);
+
+    adaptiveSimQuantum.enabled = p.sim_quantum_adaptive;
+    adaptiveSimQuantum.min = p.sim_quantum_min ? p.sim_quantum_min :
+                                                 p.sim_quantum;
+    adaptiveSimQuantum.max = p.sim_quantum_max ? p.sim_quantum_max :
+                                                 p.sim_quantum;
+    adaptiveSimQuantum.lowTraffic = p.sim_quantum_low_traffic;
+    adaptiveSimQuantum.highTraffic = p.sim_quantum_high_traffic;
+    if (adaptiveSimQuantum.enabled) {
+        fatal_if(adaptiveSimQuantum.min == 0 ||
+                 adaptiveSimQuantum.min > simQuantum ||
+                 simQuantum > adaptiveSimQuantum.max,
+                 "The adaptive quantum bounds must satisfy "
+                 "0 < sim_quantum_min <= sim_quantum <= sim_quantum_max.");
+        fatal_if(adaptiveSimQuantum.lowTraffic >
+                 adaptiveSimQuantum.highTraffic,
+                 "sim_quantum_low_traffic must not be larger than "
+                 "sim_quantum_high_traffic.");
+    }
+
+    EventQueue::defaultEngine = p.eventq_engine == EventQueueEngine::calendar ?
+        EventQueue::Engine::Calendar : EventQueue::Engine::Linear;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->engine(EventQueue::defaultEngine);
+
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
     // having a single global stat group for global stats. Merge that
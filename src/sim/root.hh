@@ -51,6 +51,8 @@
 #ifndef __SIM_ROOT_HH__
 #define __SIM_ROOT_HH__
 
+#include <vector>
+
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "base/types.hh"
@@ -99,7 +101,9 @@ class Root : public SimObject
   public: // Global statistics
     struct RootStats : public statistics::Group
     {
+        void regStats() override;
         void resetStats() override;
+        void preDumpStats() override;
 
         statistics::Formula simSeconds;
         statistics::Value simTicks;
@@ -110,6 +114,14 @@ class Root : public SimObject
         statistics::Formula hostTickRate;
         statistics::Value hostMemory;
 
+        statistics::Value simQuantum;
+        statistics::Vector barrierWaitTime;
+        statistics::Vector asyncInsertions;
+
+        statistics::Vector memPoolAllocations;
+        statistics::Vector memPoolHits;
+        statistics::Formula memPoolHitRate;
+
         static RootStats instance;
 
       private:
@@ -120,6 +132,14 @@ class Root : public SimObject
 
         Time statTime;
         Tick startTick;
+
+        /** Per-queue counter values at the last stats reset. */
+        std::vector<double> waitTimeBase;
+        std::vector<Counter> insertionsBase;
+
+        /** Per-pool counter values at the last stats reset. */
+        std::vector<Counter> poolAllocationsBase;
+        std::vector<Counter> poolHitsBase;
     };
 
   public:
@@ -42,6 +42,7 @@
 
 #include "sim/simulate.hh"
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <thread>
@@ -51,6 +52,7 @@
 #include "base/types.hh"
 #include "sim/async.hh"
 #include "sim/eventq.hh"
+#include "sim/global_event.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
 #include "sim/stat_control.hh"
@@ -167,6 +169,61 @@ class SimulatorThreads
 
 static std::unique_ptr<SimulatorThreads> simulatorThreads;
 
+/**
+ * Quantum event that adapts the length of the next quantum to the
+ * number of events scheduled across event queues during the previous
+ * one, see AdaptiveQuantum.
+ */
+class AdaptiveSyncEvent : public GlobalSyncEvent
+{
+  private:
+    Counter lastInsertions;
+
+    /**
+     * The events scheduled across queues during a quantum are only
+     * merged once it ends, after this event is processed, so the events
+     * still waiting to be merged are counted as well. Otherwise, the
+     * quantum would only adapt to the traffic of the quantum before.
+     */
+    static Counter
+    totalInsertions()
+    {
+        Counter total = 0;
+        for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+            total += mainEventQueue[i]->asyncInsertions() +
+                mainEventQueue[i]->pendingAsyncInsertions();
+        }
+        return total;
+    }
+
+  public:
+    AdaptiveSyncEvent(Tick when, Tick quantum, Priority p, Flags f)
+        : GlobalSyncEvent(p, f), lastInsertions(totalInsertions())
+    {
+        repeat = quantum;
+        schedule(when);
+    }
+
+    void
+    process() override
+    {
+        // All other threads are waiting on the barrier, so the event
+        // queue counters and simQuantum can be safely accessed.
+        const AdaptiveQuantum &adaptive = adaptiveSimQuantum;
+        Counter total = totalInsertions();
+        Counter traffic = total - lastInsertions;
+        lastInsertions = total;
+
+        if (traffic < adaptive.lowTraffic)
+            repeat = std::min(repeat * 2, adaptive.max);
+        else if (traffic > adaptive.highTraffic)
+            repeat = std::max(repeat / 2, adaptive.min);
+        simQuantum = repeat;
+
+        GlobalSyncEvent::process();
+    }
+};
+
 struct DescheduleDeleter
 {
     void operator()(BaseGlobalEvent *event)
@@ -207,9 +264,15 @@ simulate(Tick num_cycles)
         fatal_if(simQuantum == 0,
                  "Quantum for multi-eventq simulation not specified");
 
-        quantum_event.reset(
-            new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
-                                EventBase::Progress_Event_Pri, 0));
+        if (adaptiveSimQuantum.enabled) {
+            quantum_event.reset(
+                new AdaptiveSyncEvent(curTick() + simQuantum, simQuantum,
+                                      EventBase::Progress_Event_Pri, 0));
+        } else {
+            quantum_event.reset(
+                new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
+                                    EventBase::Progress_Event_Pri, 0));
+        }
 
         inParallelMode = true;
     }
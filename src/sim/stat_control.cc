@@ -48,11 +48,17 @@
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <memory>
 
 #include "base/callback.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
 #include "base/statistics.hh"
 #include "base/time.hh"
+#include "sim/core.hh"
 #include "sim/global_event.hh"
+#include "sim/root.hh"
+#include "sim/stat_sampler.hh"
 
 namespace gem5
 {
@@ -159,5 +165,41 @@ updateEvents()
     }
 }
 
+namespace
+{
+
+std::unique_ptr<Sampler> sampler;
+OutputStream *samplerStream = nullptr;
+
+} // anonymous namespace
+
+void
+startSampling(const std::string &file, Tick period,
+              const std::vector<std::string> &patterns, size_t buffer_rows)
+{
+    static bool registered = false;
+    if (!registered) {
+        registerExitCallback([]{ stopSampling(); });
+        registered = true;
+    }
+
+    stopSampling();
+    samplerStream = simout.create(file, true);
+    sampler.reset(new Sampler(*Root::root(), *samplerStream->stream(),
+                              period, patterns, buffer_rows));
+    inform("Sampling %d stat columns every %d ticks to %s.",
+           sampler->numColumns(), period, file);
+}
+
+void
+stopSampling()
+{
+    sampler.reset();
+    if (samplerStream) {
+        simout.close(samplerStream);
+        samplerStream = nullptr;
+    }
+}
+
 } // namespace statistics
 } // namespace gem5
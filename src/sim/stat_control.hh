@@ -41,6 +41,10 @@
 #ifndef __SIM_STAT_CONTROL_HH__
 #define __SIM_STAT_CONTROL_HH__
 
+#include <cstddef>
+#include <string>
+#include <vector>
+
 #include "base/compiler.hh"
 #include "base/types.hh"
 #include "sim/cur_tick.hh"
@@ -82,6 +86,19 @@ void schedStatEvent(bool dump, bool reset, Tick when = curTick(),
  * @param period The period at which the dumping should occur.
  */
 void periodicStatDump(Tick period = 0);
+
+/**
+ * Start sampling the stats of the simulation to a file in the output
+ * directory, replacing any sampling in progress. See Sampler in
+ * sim/stat_sampler.hh for the parameters.
+ */
+void startSampling(const std::string &file, Tick period,
+                   const std::vector<std::string> &patterns,
+                   size_t buffer_rows);
+
+/** Stop sampling stats, writing all the samples taken so far. */
+void stopSampling();
+
 } // namespace statistics
 } // namespace gem5
 
@@ -0,0 +1,232 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/stat_sampler.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/stats/group.hh"
+#include "base/stats/info.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+namespace
+{
+
+/** Number of chunks in the ring of samples. */
+const size_t NumChunks = 4;
+
+} // anonymous namespace
+
+Sampler::Sampler(const Group &root, std::ostream &os, Tick _period,
+                 const std::vector<std::string> &patterns,
+                 size_t buffer_rows)
+    : period(_period), sampleEvent([this]{ sample(); }, "StatSampler",
+                                   false, Event::Stat_Event_Pri),
+      curChunk(0), curRows(0), done(false)
+{
+    fatal_if(numMainEventQueues > 1,
+             "Stat sampling doesn't support multiple event queues.");
+    fatal_if(period == 0, "The stat sampling period can't be zero.");
+
+    std::vector<ColumnarWriter::Stat> schema;
+    schema.push_back({ "curTick", "Tick of the sample", "Tick", { "" } });
+    std::vector<std::regex> regexes;
+    for (const auto &pattern : patterns) {
+        try {
+            regexes.emplace_back(pattern);
+        } catch (const std::regex_error &e) {
+            fatal("Invalid stat sampling pattern '%s': %s", pattern,
+                  e.what());
+        }
+    }
+    addStats(root, "", regexes, schema);
+    warn_if(sources.empty(), "No stat matches the stat sampling patterns.");
+
+    rowSize = 0;
+    for (const auto &stat : schema)
+        rowSize += stat.suffixes.size();
+
+    chunkRows = std::max<size_t>(1, buffer_rows / NumChunks);
+    chunks.resize(NumChunks, std::vector<double>(chunkRows * rowSize));
+    for (size_t chunk = NumChunks - 1; chunk > 0; --chunk)
+        freeChunks.push_back(chunk);
+
+    writer.reset(new ColumnarWriter(os));
+    writer->writeSchema(schema);
+    writerThread = std::thread([this]{ writeChunks(); });
+
+    mainEventQueue[0]->schedule(&sampleEvent, curTick());
+}
+
+Sampler::~Sampler()
+{
+    if (sampleEvent.scheduled())
+        mainEventQueue[0]->deschedule(&sampleEvent);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (curRows)
+            filled.emplace_back(curChunk, curRows);
+        done = true;
+    }
+    cond.notify_all();
+    writerThread.join();
+}
+
+void
+Sampler::addStats(const Group &group, const std::string &prefix,
+                  const std::vector<std::regex> &regexes,
+                  std::vector<ColumnarWriter::Stat> &schema)
+{
+    for (Info *info : group.getStats()) {
+        const std::string name = prefix + info->name;
+        if (!info->flags.isSet(display))
+            continue;
+
+        bool selected = false;
+        for (const auto &regex : regexes)
+            selected = selected || std::regex_match(name, regex);
+        if (!selected)
+            continue;
+
+        ColumnarWriter::Stat stat{ name, info->desc,
+                                   info->unit->getUnitString(), {} };
+        if (dynamic_cast<FormulaInfo *>(info)) {
+            warn("Not sampling formula %s, sample its operands instead.",
+                 name);
+            continue;
+        } else if (dynamic_cast<ScalarInfo *>(info)) {
+            sources.push_back({ Source::Scalar, info, name, 1 });
+            stat.suffixes.emplace_back();
+        } else if (auto *vector = dynamic_cast<VectorInfo *>(info)) {
+            sources.push_back({ Source::Vector, info, name, vector->size() });
+            for (size_t i = 0; i < vector->size(); ++i) {
+                stat.suffixes.push_back(
+                    i < vector->subnames.size() &&
+                    !vector->subnames[i].empty() ?
+                    vector->subnames[i] : std::to_string(i));
+            }
+        } else if (dynamic_cast<DistInfo *>(info)) {
+            sources.push_back({ Source::Dist, info, name, 2 });
+            stat.suffixes = { "samples", "sum" };
+        } else {
+            warn("Not sampling %s, only scalars, vectors and distributions "
+                 "can be sampled.", name);
+            continue;
+        }
+        schema.push_back(std::move(stat));
+    }
+
+    for (const auto &child : group.getStatGroups())
+        addStats(*child.second, prefix + child.first + ".", regexes, schema);
+}
+
+void
+Sampler::sample()
+{
+    double *row = chunks[curChunk].data() + curRows * rowSize;
+    *row++ = curTick();
+
+    for (const auto &source : sources) {
+        switch (source.kind) {
+          case Source::Scalar:
+            *row++ = static_cast<ScalarInfo *>(source.info)->value();
+            break;
+          case Source::Vector: {
+            const VCounter &values =
+                static_cast<VectorInfo *>(source.info)->value();
+            panic_if(values.size() != source.columns,
+                     "Sampled vector %s changed size from %d to %d.",
+                     source.name, source.columns, values.size());
+            row = std::copy(values.begin(), values.end(), row);
+            break;
+          }
+          case Source::Dist: {
+            auto *dist = static_cast<DistInfo *>(source.info);
+            dist->prepare();
+            *row++ = dist->data.samples;
+            *row++ = dist->data.sum;
+            break;
+          }
+        }
+    }
+
+    if (++curRows == chunkRows)
+        submitChunk();
+
+    mainEventQueue[0]->schedule(&sampleEvent, curTick() + period);
+}
+
+void
+Sampler::submitChunk()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    filled.emplace_back(curChunk, curRows);
+    cond.notify_all();
+
+    if (freeChunks.empty()) {
+        warn_once("Stat sampling is waiting for samples to be written, "
+                  "consider buffering more samples.");
+        cond.wait(guard, [this]{ return !freeChunks.empty(); });
+    }
+
+    curChunk = freeChunks.back();
+    freeChunks.pop_back();
+    curRows = 0;
+}
+
+void
+Sampler::writeChunks()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        cond.wait(guard, [this]{ return done || !filled.empty(); });
+        if (filled.empty())
+            break;
+
+        const auto [chunk, rows] = filled.front();
+        filled.pop_front();
+
+        guard.unlock();
+        for (size_t row = 0; row < rows; ++row)
+            writer->writeRow(chunks[chunk].data() + row * rowSize, rowSize);
+        writer->flush();
+        guard.lock();
+
+        freeChunks.push_back(chunk);
+        cond.notify_all();
+    }
+}
+
+} // namespace statistics
+} // namespace gem5
@@ -0,0 +1,161 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_STAT_SAMPLER_HH__
+#define __SIM_STAT_SAMPLER_HH__
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/stats/columnar.hh"
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+class Group;
+class Info;
+
+/**
+ * Periodically samples the raw values of a few stats, without the cost
+ * of a full stats dump.
+ *
+ * A single event copies the current tick and the value of every
+ * sampled column into a row of an in-memory ring of chunks, and a
+ * helper thread appends each filled chunk to a columnar stat file (see
+ * ColumnarWriter) in the background. If the helper thread falls behind,
+ * the simulation waits for it to free a chunk instead of dropping
+ * samples.
+ *
+ * The samples are the raw values kept in the stats storage: counters
+ * are not reset and formulas aren't evaluated, so rates such as the
+ * IPC are computed from the differences between consecutive samples of
+ * their operands. Stats only updated when the stats are dumped (e.g.,
+ * by a preDumpStats() method) are not up to date in the samples.
+ *
+ * The columns are chosen when sampling starts, so the sampled vectors
+ * must not change size afterwards.
+ */
+class Sampler
+{
+  public:
+    /**
+     * @param root Group holding the stats to sample.
+     * @param os Stream the samples are written to.
+     * @param period Sampling period in ticks.
+     * @param patterns Regular expressions selecting the stats to sample
+     *                 by their full name, as printed in stats.txt.
+     * @param buffer_rows Number of samples buffered in memory.
+     */
+    Sampler(const Group &root, std::ostream &os, Tick period,
+            const std::vector<std::string> &patterns, size_t buffer_rows);
+
+    /** Write the buffered samples to the stream. */
+    ~Sampler();
+
+    Sampler(const Sampler &other) = delete;
+
+    /** Number of sampled columns, excluding the tick. */
+    size_t numColumns() const { return rowSize - 1; }
+
+  private:
+    /** A sampled stat. */
+    struct Source
+    {
+        enum Kind { Scalar, Vector, Dist };
+
+        Kind kind;
+        Info *info;
+        /** Full name of the stat. */
+        std::string name;
+        /** Number of columns of the stat. */
+        size_t columns;
+    };
+
+    /** Select the stats of a group and its subgroups. */
+    void addStats(const Group &group, const std::string &prefix,
+                  const std::vector<std::regex> &regexes,
+                  std::vector<ColumnarWriter::Stat> &schema);
+
+    /** Take a sample and schedule the next one. */
+    void sample();
+
+    /** Hand the current chunk over to the writer thread. */
+    void submitChunk();
+
+    /** Main loop of the writer thread. */
+    void writeChunks();
+
+    std::vector<Source> sources;
+
+    const Tick period;
+    EventFunctionWrapper sampleEvent;
+
+    /** Number of values in a row, including the tick. */
+    size_t rowSize;
+
+    /** Number of rows in a chunk. */
+    size_t chunkRows;
+
+    /** Ring of chunks of rows. */
+    std::vector<std::vector<double>> chunks;
+
+    /** Chunk being filled, and number of rows it holds. */
+    size_t curChunk;
+    size_t curRows;
+
+    /** @{ */
+    /** State shared with the writer thread, protected by lock. */
+    std::mutex lock;
+    std::condition_variable cond;
+    /** Filled chunks and their number of rows, in sampling order. */
+    std::deque<std::pair<size_t, size_t>> filled;
+    /** Chunks available for sampling. */
+    std::vector<size_t> freeChunks;
+    bool done;
+    /** @} */
+
+    std::unique_ptr<ColumnarWriter> writer;
+    std::thread writerThread;
+};
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __SIM_STAT_SAMPLER_HH__
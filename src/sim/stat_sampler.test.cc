@@ -0,0 +1,304 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/stats/group.hh"
+#include "base/stats/info.hh"
+#include "base/stats/units.hh"
+#include "sim/eventq.hh"
+#include "sim/stat_sampler.hh"
+
+using namespace gem5;
+using namespace gem5::statistics;
+
+namespace
+{
+
+/**
+ * Stat whose values are set by the test, which avoids depending on the
+ * stats of the simulation.
+ */
+template <class Base>
+class FakeInfo : public Base
+{
+  public:
+    FakeInfo(Group &group, const std::string &name)
+    {
+        this->name = name;
+        this->unit = units::Count::get();
+        this->flags.set(display);
+        group.addStat(this);
+    }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return false; }
+    void visit(Output &visitor) override {}
+};
+
+class FakeScalar : public FakeInfo<ScalarInfo>
+{
+  public:
+    using FakeInfo::FakeInfo;
+
+    statistics::Counter counter = 0;
+
+    statistics::Counter value() const override { return counter; }
+    Result result() const override { return counter; }
+    Result total() const override { return counter; }
+};
+
+class FakeVector : public FakeInfo<VectorInfo>
+{
+  public:
+    using FakeInfo::FakeInfo;
+
+    VCounter counters;
+    mutable VResult results;
+
+    size_type size() const override { return counters.size(); }
+    const VCounter &value() const override { return counters; }
+
+    const VResult &
+    result() const override
+    {
+        results.assign(counters.begin(), counters.end());
+        return results;
+    }
+
+    Result
+    total() const override
+    {
+        return std::accumulate(counters.begin(), counters.end(), 0.0);
+    }
+};
+
+class FakeFormula : public FakeInfo<FormulaInfo>
+{
+  public:
+    using FakeInfo::FakeInfo;
+
+    VCounter counters;
+    VResult results;
+
+    size_type size() const override { return 0; }
+    const VCounter &value() const override { return counters; }
+    const VResult &result() const override { return results; }
+    Result total() const override { return 0; }
+    std::string str() const override { return ""; }
+};
+
+/** Stats of a fake CPU, in a group named cpu. */
+struct CpuStats : public Group
+{
+    CpuStats(Group *parent)
+        : Group(parent, "cpu"), numInsts(*this, "numInsts"),
+          bytes(*this, "bytes"), latency(*this, "latency"),
+          ipc(*this, "ipc"), late(*this, "late")
+    {
+        bytes.counters.resize(2);
+        bytes.subnames = { "read", "write" };
+    }
+
+    FakeScalar numInsts;
+    FakeVector bytes;
+    FakeInfo<DistInfo> latency;
+    /** Formulas are not sampled. */
+    FakeFormula ipc;
+    /** Vector initialized once sampling has started. */
+    FakeVector late;
+};
+
+/** Reads back the rows of a sample file, see ColumnarWriter. */
+class Reader
+{
+  private:
+    std::string data;
+    size_t pos = 0;
+
+    template <class T>
+    T
+    read()
+    {
+        T value;
+        EXPECT_LE(pos + sizeof(T), data.size());
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string
+    readString()
+    {
+        const uint32_t size = read<uint32_t>();
+        std::string str = data.substr(pos, size);
+        pos += size;
+        return str;
+    }
+
+  public:
+    /** Name and suffixes of each stat of the schema. */
+    std::vector<std::pair<std::string, std::vector<std::string>>> schema;
+    std::vector<std::vector<double>> rows;
+
+    explicit Reader(const std::string &_data) : data(_data)
+    {
+        pos = 8 + 2 * sizeof(uint32_t);
+        while (pos < data.size()) {
+            const char kind = read<char>();
+            if (kind == 'S') {
+                schema.resize(read<uint32_t>());
+                for (auto &[name, suffixes] : schema) {
+                    name = readString();
+                    readString();
+                    readString();
+                    suffixes.resize(read<uint32_t>());
+                    for (auto &suffix : suffixes)
+                        suffix = readString();
+                }
+            } else {
+                EXPECT_EQ(kind, 'R');
+                if (kind != 'R')
+                    return;
+                rows.emplace_back(read<uint32_t>());
+                for (auto &value : rows.back())
+                    value = read<double>();
+            }
+        }
+    }
+};
+
+class StatSamplerTest : public testing::Test
+{
+  protected:
+    Group root;
+    CpuStats stats;
+    EventQueue *eventq;
+    std::ostringstream os;
+
+    StatSamplerTest() : root(nullptr), stats(&root) {}
+
+    void
+    SetUp() override
+    {
+        eventq = getEventQueue(0);
+        curEventQueue(eventq);
+        eventq->setCurTick(0);
+    }
+
+    /** Take the next sample. */
+    void
+    sample()
+    {
+        ASSERT_FALSE(eventq->empty());
+        eventq->serviceOne();
+    }
+};
+
+} // anonymous namespace
+
+TEST_F(StatSamplerTest, Samples)
+{
+    auto sampler = std::make_unique<Sampler>(
+        root, os, 10, std::vector<std::string>{ "cpu\\..*" }, 4);
+    // the formula is skipped, and the vector has no element yet
+    EXPECT_EQ(sampler->numColumns(), 5U);
+
+    stats.numInsts.counter = 5;
+    stats.bytes.counters[0] = 64;
+    stats.latency.data.samples = 1;
+    stats.latency.data.sum = 20;
+    sample();
+
+    stats.numInsts.counter += 5;
+    stats.bytes.counters[1] += 128;
+    sample();
+
+    stats.latency.data.samples += 1;
+    stats.latency.data.sum += 40;
+    sample();
+    sampler.reset();
+
+    Reader reader(os.str());
+    using Schema = decltype(reader.schema);
+    EXPECT_EQ(reader.schema, Schema({
+        { "curTick", { "" } },
+        { "cpu.numInsts", { "" } },
+        { "cpu.bytes", { "read", "write" } },
+        { "cpu.latency", { "samples", "sum" } },
+        { "cpu.late", {} },
+    }));
+    EXPECT_EQ(reader.rows, std::vector<std::vector<double>>({
+        { 0, 5, 64, 0, 1, 20 },
+        { 10, 10, 64, 128, 1, 20 },
+        { 20, 10, 64, 128, 2, 60 },
+    }));
+}
+
+TEST_F(StatSamplerTest, Patterns)
+{
+    Sampler sampler(root, os, 10, { "cpu\\.numInsts", "cpu\\.bytes" }, 4);
+    EXPECT_EQ(sampler.numColumns(), 3U);
+}
+
+/** The samples are all written, in order, when the buffer is full. */
+TEST_F(StatSamplerTest, FullBuffer)
+{
+    const int count = 100;
+    auto sampler = std::make_unique<Sampler>(
+        root, os, 10, std::vector<std::string>{ "cpu\\.numInsts" }, 8);
+    for (int i = 0; i < count; ++i) {
+        stats.numInsts.counter = i;
+        sample();
+    }
+    sampler.reset();
+
+    Reader reader(os.str());
+    ASSERT_EQ(reader.rows.size(), size_t(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(reader.rows[i],
+                  std::vector<double>({ double(i * 10), double(i) }));
+    }
+}
+
+/** A vector can't grow once the columns are chosen. */
+TEST_F(StatSamplerTest, VectorResize)
+{
+    Sampler sampler(root, os, 10, { "cpu\\.late" }, 4);
+    sample();
+
+    stats.late.counters.resize(3);
+    ASSERT_ANY_THROW(sample());
+}
@@ -0,0 +1,128 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Drive two identical DRAM systems with the same mostly idle traffic, one
+# with lazy_refresh set and one without, and check that the energy and
+# power state time of every rank are the same in both of them. The stats
+# are reset during an idle phase and dumped at the end, so that the
+# skipped refreshes are caught up on an access, a reset and a dump.
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common import ObjectList
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--mem-type', default='DDR3_1600_8x8',
+                    help='type of memory to use')
+args = parser.parse_args()
+
+mem_range = AddrRange('256MB')
+
+block_size = 64
+period = 2000
+# long enough for a burst to complete
+burst_duration = 20000000
+# with the default address mapping, covers all the banks of both ranks
+burst_size = 128 * 1024
+
+# idle phases in ps, from shorter than a refresh interval to many of them,
+# and not aligned on the refresh interval
+idle_durations = (5000000, 30000000, 123456789, 1000000000, 77777777)
+
+def make_system(lazy_refresh):
+    system = System(membus = IOXBar(width = 32))
+    system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                       voltage_domain =
+                                       VoltageDomain(voltage = '1V'))
+    system.mem_ranges = [mem_range]
+    system.mmap_using_noreserve = True
+    system.mem_mode = 'timing'
+
+    mem_class = ObjectList.mem_list.get(args.mem_type)
+    # drain all the writes when there are no reads, as the ranks only skip
+    # their refreshes with nothing left in the queues
+    system.mem_ctrl = MemCtrl(dram = mem_class(range = mem_range,
+                                               lazy_refresh = lazy_refresh),
+                              write_low_thresh_perc = 0)
+    system.mem_ctrl.port = system.membus.mem_side_ports
+
+    system.tgen = PyTrafficGen()
+    system.tgen.port = system.membus.cpu_side_ports
+    system.system_port = system.membus.cpu_side_ports
+    return system
+
+root = Root(full_system = False,
+            eager = make_system(False),
+            lazy = make_system(True))
+
+m5.instantiate()
+
+# bursts of reads and writes, separated by idle phases, with a fixed
+# period so that both generators issue the same requests
+def trace(tgen):
+    for i, idle in enumerate(idle_durations):
+        yield tgen.createLinear(burst_duration, 0, burst_size, block_size,
+                                period, period, 100 if i % 2 else 0,
+                                burst_size)
+        yield tgen.createIdle(idle)
+    yield tgen.createExit(0)
+
+for system in (root.eager, root.lazy):
+    system.tgen.start(trace(system.tgen))
+
+# reset the stats in the middle of the longest idle phase
+reset_tick = sum(idle_durations[:3]) + 4 * burst_duration + \
+    idle_durations[3] // 2
+m5.simulate(reset_tick)
+m5.stats.reset()
+m5.simulate()
+m5.stats.dump()
+
+rank_stats = ('actEnergy', 'preEnergy', 'readEnergy', 'writeEnergy',
+              'refreshEnergy', 'actBackEnergy', 'preBackEnergy',
+              'totalEnergy', 'totalIdleTime', 'pwrStateTime')
+
+mismatches = 0
+for rank in range(int(root.eager.mem_ctrl.dram.ranks_per_channel)):
+    for stat in rank_stats:
+        name = 'rank%d.%s' % (rank, stat)
+        eager = root.eager.mem_ctrl.dram.resolveStat(name).value
+        lazy = root.lazy.mem_ctrl.dram.resolveStat(name).value
+        if eager != lazy:
+            print("%s: %s without and %s with lazy refresh" %
+                  (name, eager, lazy))
+            mismatches += 1
+    refresh = root.eager.mem_ctrl.dram.resolveStat(
+        'rank%d.refreshEnergy' % rank).value
+    if refresh == 0:
+        print("rank%d did not refresh" % rank)
+        mismatches += 1
+
+if mismatches:
+    sys.exit(1)
+print("The rank energy and power state times match with and without "
+      "lazy refresh")
@@ -24,11 +24,22 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import argparse
+
 import m5
 from m5.objects import *
 m5.util.addToPath('../../../configs/')
 from common.Caches import *
 
+parser = argparse.ArgumentParser()
+parser.add_argument('--snoop-filter-assoc', type=int, default=0,
+                    help='Make the snoop filter of the L2 crossbar a small '
+                    'set-associative one, whose evictions back-invalidate '
+                    'the L1 caches')
+parser.add_argument('--snoop-filter-size', type=str, default='16kB',
+                    help='Capacity of the set-associative snoop filter')
+args = parser.parse_args()
+
 #MAX CORES IS 8 with the fals sharing method
 nb_cores = 8
 cpus = [MemTest(max_loads = 1e5, progress_interval = 1e4)
@@ -49,6 +60,11 @@ system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
                                        voltage_domain = system.voltage_domain)
 
 system.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain)
+if args.snoop_filter_assoc:
+    system.toL2Bus.snoop_filter = SnoopFilter(lookup_latency = 0,
+        max_capacity = args.snoop_filter_size,
+        assoc = args.snoop_filter_assoc,
+        replacement_policy = LRURP())
 system.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size='64kB', assoc=8)
 system.l2c.cpu_side = system.toL2Bus.mem_side_ports
 
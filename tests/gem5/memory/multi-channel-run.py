@@ -0,0 +1,128 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Drive two identical multi-channel DRAM systems with the same linear
+# traffic, one with standalone channel controllers and one with the
+# channels behind a multi-channel controller, as configured by
+# --mem-multi-channel-ctrl, and check that every channel sees the same
+# requests in both of them.
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common import MemConfig
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--mem-type', default='DDR3_1600_8x8',
+                    help='type of memory to use')
+parser.add_argument('--mem-channels', type=int, default=4,
+                    help='number of memory channels')
+args = parser.parse_args()
+
+mem_range = AddrRange('256MB')
+
+# stay in each phase for 1 ms, which is long enough for the data
+# limit to be reached
+duration = 1000000000
+data_limit = 1024 * 1024
+block_size = 64
+period = 2000
+
+def make_system(multi_channel_ctrl):
+    system = System(membus = IOXBar(width = 32))
+    system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                       voltage_domain =
+                                       VoltageDomain(voltage = '1V'))
+    system.mem_ranges = [mem_range]
+    system.mmap_using_noreserve = True
+    system.mem_mode = 'timing'
+
+    mem_args = argparse.Namespace(
+        mem_type = args.mem_type, mem_channels = args.mem_channels,
+        external_memory_system = 0, tlm_memory = 0, elastic_trace_en = 0,
+        mem_multi_channel_ctrl = multi_channel_ctrl)
+    MemConfig.config_mem(mem_args, system)
+
+    system.tgen = PyTrafficGen()
+    system.tgen.port = system.membus.cpu_side_ports
+    system.system_port = system.membus.cpu_side_ports
+    return system
+
+root = Root(full_system = False,
+            plain = make_system(False),
+            multi = make_system(True))
+
+m5.instantiate()
+
+# write a linear range, and read it back, with a fixed period so that
+# both generators issue the same requests
+def trace(tgen):
+    yield tgen.createLinear(duration, 0, data_limit, block_size,
+                            period, period, 0, data_limit)
+    yield tgen.createLinear(duration, 0, data_limit, block_size,
+                            period, period, 100, data_limit)
+    yield tgen.createExit(0)
+
+for system in (root.plain, root.multi):
+    system.tgen.start(trace(system.tgen))
+
+m5.simulate()
+
+# only the counts that do not depend on the front-end timing, as the
+# multi-channel controller has a single port and response queue
+channel_stats = ('readReqs', 'writeReqs', 'readBursts', 'writeBursts',
+                 'bytesReadSys', 'bytesWrittenSys')
+tgen_stats = ('numPackets', 'totalReads', 'totalWrites')
+
+def values(obj, names):
+    return [(name, obj.resolveStat(name).value) for name in names]
+
+mismatches = 0
+def compare(name, plain, multi):
+    global mismatches
+    for (stat, plain_value), (_, multi_value) in zip(plain, multi):
+        if plain_value != multi_value:
+            print("%s.%s: %d without and %d with the multi-channel "
+                  "controller" % (name, stat, plain_value, multi_value))
+            mismatches += 1
+
+compare('tgen', values(root.plain.tgen, tgen_stats),
+        values(root.multi.tgen, tgen_stats))
+for i, (plain, multi) in enumerate(zip(root.plain.mem_ctrls,
+                                       root.multi.mem_ctrls)):
+    plain_values = values(plain, channel_stats)
+    compare('mem_ctrls%d' % i, plain_values, values(multi, channel_stats))
+    if dict(plain_values)['readReqs'] == 0:
+        print("mem_ctrls%d did not see any read" % i)
+        mismatches += 1
+
+if root.multi.mem_multi_channel_ctrl.resolveStat('channelEvents').value == 0:
+    print("The multi-channel controller did not process any event")
+    mismatches += 1
+
+if mismatches:
+    sys.exit(1)
+print("The stats match with and without the multi-channel controller")
@@ -67,6 +67,48 @@ gem5_verify_config(
     valid_isas=(constants.null_tag,),
 )
 
+# The small set-associative snoop filter keeps back-invalidating the
+# dirty lines of the L1 caches, including those in their write buffers
+gem5_verify_config(
+    name='memtest-snoop-filter-assoc',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'memtest-run.py'),
+    config_args = ['--snoop-filter-assoc', '16'],
+    valid_isas=(constants.null_tag,),
+)
+
+# A direct-mapped snoop filter of 16 lines, whose sets are often all
+# taken by lines with requests in flight from the 8 testers, so that
+# their new lines go to the overflow entries
+gem5_verify_config(
+    name='memtest-snoop-filter-full-set',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'memtest-run.py'),
+    config_args = ['--snoop-filter-assoc', '1',
+                   '--snoop-filter-size', '1kB'],
+    valid_isas=(constants.null_tag,),
+)
+
+# Every channel should see the same requests whether or not they are
+# behind a multi-channel controller
+gem5_verify_config(
+    name='multi-channel-mem-ctrl',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'multi-channel-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
+# The ranks should use the same energy and spend the same time in each
+# power state whether or not they skip their refresh events while idle
+gem5_verify_config(
+    name='lazy-refresh',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'lazy-refresh-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
 null_tests = [
     ('garnet_synth_traffic', None, ['--sim-cycles', '5000000']),
     ('memcheck', None, ['--maxtick', '2000000000', '--prefetchers']),
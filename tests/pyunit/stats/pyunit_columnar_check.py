@@ -0,0 +1,182 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import gzip
+import io
+import math
+import os
+import shutil
+import struct
+import tempfile
+import unittest
+
+from m5.ext.pystats import columnar
+
+
+class Writer:
+    """
+    Writes columnar stat files record by record, following the format
+    documented in base/stats/columnar.hh.
+    """
+
+    def __init__(self, order: str = "<"):
+        self.order = order
+        self.data = io.BytesIO()
+        self.data.write(b"gem5cols")
+        self._pack("II", columnar.VERSION, columnar.BYTE_ORDER_MARK)
+
+    def _pack(self, fmt, *values):
+        self.data.write(struct.pack(self.order + fmt, *values))
+
+    def _str(self, s):
+        data = s.encode()
+        self._pack("I", len(data))
+        self.data.write(data)
+
+    def schema(self, stats):
+        self.data.write(b"S")
+        self._pack("I", len(stats))
+        for name, desc, unit, suffixes in stats:
+            self._str(name)
+            self._str(desc)
+            self._str(unit)
+            self._pack("I", len(suffixes))
+            for suffix in suffixes:
+                self._str(suffix)
+
+    def row(self, values):
+        self.data.write(b"R")
+        self._pack("I", len(values))
+        self._pack(f"{len(values)}d", *values)
+
+    def delta(self, changed):
+        self.data.write(b"D")
+        self._pack("I", len(changed))
+        for index, value in changed:
+            self._pack("Id", index, value)
+
+    def bytes(self):
+        return self.data.getvalue()
+
+
+SCHEMA = [
+    ("simTicks", "Number of ticks simulated", "Tick", [""]),
+    ("system.mem.bytes", "Bytes per requestor", "Byte", ["cpu", "dma"]),
+]
+
+
+class ColumnarReaderTestSuite(unittest.TestCase):
+    """Round trip of columnar stat files through the reader"""
+
+    def setUp(self):
+        self.dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.dir)
+
+    def _file(self, name, data, compress=False):
+        path = os.path.join(self.dir, name)
+        with (gzip.open if compress else open)(path, "wb") as f:
+            f.write(data)
+        return path
+
+    def _write_dumps(self, order="<"):
+        writer = Writer(order)
+        writer.schema(SCHEMA)
+        writer.row([1000, 64, 0])
+        writer.delta([(0, 2000), (2, 128)])
+        writer.delta([])
+        writer.row([3000, 96, 128])
+        return writer.bytes()
+
+    EXPECTED = [
+        {"simTicks": 1000, "system.mem.bytes::cpu": 64,
+         "system.mem.bytes::dma": 0},
+        {"simTicks": 2000, "system.mem.bytes::cpu": 64,
+         "system.mem.bytes::dma": 128},
+        {"simTicks": 2000, "system.mem.bytes::cpu": 64,
+         "system.mem.bytes::dma": 128},
+        {"simTicks": 3000, "system.mem.bytes::cpu": 96,
+         "system.mem.bytes::dma": 128},
+    ]
+
+    def test_rows_and_deltas(self):
+        path = self._file("stats.cols", self._write_dumps())
+        with columnar.ColumnarReader(path) as reader:
+            self.assertEqual(list(reader), self.EXPECTED)
+            self.assertEqual(reader.columns, ["simTicks",
+                                              "system.mem.bytes::cpu",
+                                              "system.mem.bytes::dma"])
+            self.assertEqual([s.name for s in reader.stats],
+                             ["simTicks", "system.mem.bytes"])
+            self.assertEqual(reader.stats[1].desc, "Bytes per requestor")
+            self.assertEqual(reader.stats[1].unit, "Byte")
+
+    def test_load(self):
+        path = self._file("stats.cols", self._write_dumps())
+        self.assertEqual(columnar.load(path), self.EXPECTED)
+
+    def test_stream(self):
+        stream = io.BytesIO(self._write_dumps())
+        self.assertEqual(columnar.load(stream), self.EXPECTED)
+        self.assertFalse(stream.closed)
+
+    def test_gzip(self):
+        path = self._file("stats.cols.gz", self._write_dumps(), True)
+        self.assertEqual(columnar.load(path), self.EXPECTED)
+
+    def test_big_endian(self):
+        path = self._file("stats.cols", self._write_dumps(">"))
+        self.assertEqual(columnar.load(path), self.EXPECTED)
+
+    def test_schema_change(self):
+        writer = Writer()
+        writer.schema(SCHEMA)
+        writer.row([1000, 64, 0])
+        writer.schema([("simTicks", "", "Tick", [""]),
+                       ("system.cpu.ipc", "", "Ratio", [""])])
+        writer.row([2000, math.nan])
+        writer.delta([(0, 3000)])
+        dumps = columnar.load(self._file("stats.cols", writer.bytes()))
+
+        self.assertEqual(len(dumps), 3)
+        self.assertEqual(dumps[0], self.EXPECTED[0])
+        self.assertEqual(list(dumps[1]), ["simTicks", "system.cpu.ipc"])
+        self.assertEqual(dumps[1]["simTicks"], 2000)
+        self.assertTrue(math.isnan(dumps[1]["system.cpu.ipc"]))
+        self.assertEqual(dumps[2]["simTicks"], 3000)
+        self.assertTrue(math.isnan(dumps[2]["system.cpu.ipc"]))
+
+    def test_invalid(self):
+        path = self._file("stats.txt", b"---------- Begin Simulation")
+        self.assertRaises(ValueError, columnar.ColumnarReader, path)
+
+        data = self._write_dumps()
+        path = self._file("truncated.cols", data[:-4])
+        self.assertRaises(EOFError, columnar.load, path)
+
+        writer = Writer()
+        writer.schema(SCHEMA)
+        writer.row([1000, 64])
+        path = self._file("short.cols", writer.bytes())
+        self.assertRaises(ValueError, columnar.load, path)
@@ -0,0 +1,67 @@
+#! /usr/bin/env python3
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import argparse
+import subprocess
+import sys
+import time
+
+parser = argparse.ArgumentParser()
+
+# This script measures the simulation speed of Garnet on a large mesh
+# at low injection rates, where most routers are idle in any given
+# cycle. It runs the garnet_synth_traffic.py example script once per
+# injection rate and reports the host time of each run.
+
+parser.add_argument('-r', '--mesh-rows', type=int, default=16)
+parser.add_argument('-c', '--sim-cycles', type=int, default=100000)
+parser.add_argument('-s', '--synthetic', default='uniform_random')
+parser.add_argument('-i', '--injection-rates', type=float, nargs='+',
+                    default=[0.001, 0.005, 0.01, 0.02])
+parser.add_argument('binary')
+
+args = parser.parse_args()
+
+num_nodes = args.mesh_rows * args.mesh_rows
+
+for rate in args.injection_rates:
+    start = time.time()
+    status = subprocess.call([args.binary, '-q',
+                              'configs/example/garnet_synth_traffic.py',
+                              '--network=garnet',
+                              '--topology=Mesh_XY',
+                              '--mesh-rows=%d' % args.mesh_rows,
+                              '--num-cpus=%d' % num_nodes,
+                              '--num-dirs=%d' % num_nodes,
+                              '--synthetic=%s' % args.synthetic,
+                              '--sim-cycles=%d' % args.sim_cycles,
+                              '--injectionrate=%f' % rate],
+                             stdout=subprocess.DEVNULL)
+    if status != 0:
+        print("Error: garnet_synth_traffic run failed\n")
+        sys.exit(1)
+
+    print("%dx%d mesh, injection rate %f: %.2f host seconds" %
+          (args.mesh_rows, args.mesh_rows, rate, time.time() - start))
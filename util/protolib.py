@@ -74,11 +74,25 @@ import struct
 def openFileRd(in_file):
     """
     This opens the file passed as argument for reading using an appropriate
-    function depending on if it is gzipped or not. It returns the file
-    handle.
+    function depending on if it is gzipped, zstd compressed or not. It
+    returns the file handle. Reading zstd compressed files requires the
+    zstandard module.
     """
     try:
-        # First see if this file is gzipped
+        # First see if this file is zstd compressed
+        with open(in_file, 'rb') as f:
+            magic = f.read(4)
+        if magic == b'\x28\xb5\x2f\xfd':
+            try:
+                import zstandard
+            except ImportError:
+                print("Reading zstd compressed traces requires the "
+                      "zstandard module")
+                exit(-1)
+            return zstandard.ZstdDecompressor().stream_reader(
+                open(in_file, 'rb'))
+
+        # Then see if this file is gzipped
         try:
             # Opening the file works even if it is not a gzip file
             proto_in = gzip.open(in_file, 'rb')